@@ -0,0 +1,236 @@
+#include "archive_dir_index.h"
+#include "archive_files.h"
+#include "archive_browser.h"
+
+#define TAG "ArchiveIndex"
+
+/* Offset of every Nth item is kept in memory, up to N-1 items are skipped on jump */
+#define ARCHIVE_DIR_INDEX_PAGE_SIZE 16
+#define ARCHIVE_DIR_INDEX_BUFFER_SIZE 512
+
+#pragma pack(push, 1)
+
+/* Index file item, followed by name without terminator */
+typedef struct {
+    uint32_t size;
+    uint8_t flags;
+    uint8_t name_len;
+} ArchiveDirIndexItem;
+
+#pragma pack(pop)
+
+struct ArchiveDirIndex {
+    Storage* storage;
+    FuriPubSubSubscription* subscription;
+    volatile bool changed;
+
+    bool built;
+    bool available;
+    string_t path;
+    const char* tab_ext;
+
+    /* Kept open while index is valid, closing file written by us is a change too */
+    File* file;
+    uint32_t count;
+    uint32_t* pages;
+    uint32_t pages_max;
+
+    /* Item at current position of index file */
+    uint32_t cursor;
+    char name[MAX_NAME_LEN + 1];
+};
+
+static void archive_dir_index_storage_callback(const void* message, void* context) {
+    const StorageEvent* event = message;
+    ArchiveDirIndex* index = context;
+
+    if((event->type != StorageEventTypeFileClose) && (event->type != StorageEventTypeDirClose)) {
+        index->changed = true;
+    }
+}
+
+ArchiveDirIndex* archive_dir_index_alloc() {
+    ArchiveDirIndex* index = malloc(sizeof(ArchiveDirIndex));
+    string_init(index->path);
+
+    index->storage = furi_record_open("storage");
+    index->file = storage_file_alloc(index->storage);
+    index->subscription = furi_pubsub_subscribe(
+        storage_get_pubsub(index->storage), archive_dir_index_storage_callback, index);
+
+    return index;
+}
+
+static void archive_dir_index_reset(ArchiveDirIndex* index) {
+    if(storage_file_is_open(index->file)) {
+        storage_file_close(index->file);
+    }
+    free(index->pages);
+    index->pages = NULL;
+    index->pages_max = 0;
+    index->count = 0;
+    index->cursor = 0;
+    index->built = false;
+    index->available = false;
+}
+
+void archive_dir_index_free(ArchiveDirIndex* index) {
+    furi_assert(index);
+
+    furi_pubsub_unsubscribe(storage_get_pubsub(index->storage), index->subscription);
+
+    if(index->built) {
+        archive_dir_index_reset(index);
+        storage_common_remove(index->storage, ARCHIVE_DIR_INDEX_PATH);
+    }
+    storage_file_free(index->file);
+    furi_record_close("storage");
+
+    string_clear(index->path);
+    free(index);
+}
+
+static void archive_dir_index_add_page(ArchiveDirIndex* index, uint32_t offset) {
+    uint32_t page = index->count / ARCHIVE_DIR_INDEX_PAGE_SIZE;
+    if(page == index->pages_max) {
+        index->pages_max = index->pages_max ? index->pages_max * 2 : 8;
+        index->pages = realloc(index->pages, index->pages_max * sizeof(uint32_t));
+    }
+    index->pages[page] = offset;
+}
+
+/* Write all matching items to index file, buffered to save storage calls */
+static bool archive_dir_index_build(ArchiveDirIndex* index) {
+    File* directory = storage_file_alloc(index->storage);
+    uint8_t* buffer = malloc(ARCHIVE_DIR_INDEX_BUFFER_SIZE);
+    size_t buffer_used = 0;
+    uint32_t offset = 0;
+    bool result = false;
+
+    FileInfo file_info;
+    char* path = malloc(MAX_NAME_LEN);
+    snprintf(path, MAX_NAME_LEN, "%s/", string_get_cstr(index->path));
+    size_t path_len = strlen(path);
+
+    do {
+        if(!storage_file_open(
+               index->file, ARCHIVE_DIR_INDEX_PATH, FSAM_READ_WRITE, FSOM_CREATE_ALWAYS))
+            break;
+        if(!storage_dir_open(directory, string_get_cstr(index->path))) break;
+
+        bool write_failed = false;
+        while(archive_dir_read_next(directory, &file_info, path, path_len, index->tab_ext)) {
+            ArchiveDirIndexItem item = {
+                .size = file_info.size,
+                .flags = file_info.flags,
+                .name_len = strlen(&path[path_len]),
+            };
+            size_t item_size = sizeof(item) + item.name_len;
+            if(buffer_used + item_size > ARCHIVE_DIR_INDEX_BUFFER_SIZE) {
+                if(storage_file_write(index->file, buffer, buffer_used) != buffer_used) {
+                    write_failed = true;
+                    break;
+                }
+                buffer_used = 0;
+            }
+
+            if(index->count % ARCHIVE_DIR_INDEX_PAGE_SIZE == 0) {
+                archive_dir_index_add_page(index, offset);
+            }
+            memcpy(&buffer[buffer_used], &item, sizeof(item));
+            memcpy(&buffer[buffer_used + sizeof(item)], &path[path_len], item.name_len);
+            buffer_used += item_size;
+            offset += item_size;
+            index->count++;
+        }
+        if(write_failed) break;
+        if(storage_file_write(index->file, buffer, buffer_used) != buffer_used) break;
+
+        /* Invalid cursor, first read will seek */
+        index->cursor = UINT32_MAX;
+        result = true;
+    } while(0);
+
+    storage_dir_close(directory);
+    storage_file_free(directory);
+    free(path);
+    free(buffer);
+
+    return result;
+}
+
+bool archive_dir_index_update(ArchiveDirIndex* index, const char* path, const char* tab_ext) {
+    furi_assert(index);
+    furi_assert(path);
+    furi_assert(tab_ext);
+
+    if(index->built && !index->changed && !string_cmp_str(index->path, path) &&
+       !strcmp(index->tab_ext, tab_ext)) {
+        return index->available;
+    }
+
+    archive_dir_index_reset(index);
+    /* Changes made while directory is read will trigger next rebuild */
+    index->changed = false;
+    string_set_str(index->path, path);
+    index->tab_ext = tab_ext;
+    index->built = true;
+
+    if(archive_dir_index_build(index)) {
+        index->available = true;
+    } else {
+        /* SD card may be missing, read-only or full */
+        FURI_LOG_W(TAG, "%s: index is not available", path);
+        archive_dir_index_reset(index);
+        storage_common_remove(index->storage, ARCHIVE_DIR_INDEX_PATH);
+        index->changed = false;
+        index->built = true;
+    }
+
+    return index->available;
+}
+
+uint32_t archive_dir_index_get_count(ArchiveDirIndex* index) {
+    furi_assert(index);
+    return index->count;
+}
+
+const char* archive_dir_index_get_item(ArchiveDirIndex* index, uint32_t idx, FileInfo* file_info) {
+    furi_assert(index);
+    furi_assert(idx < index->count);
+
+    uint32_t page = idx / ARCHIVE_DIR_INDEX_PAGE_SIZE;
+    if((idx < index->cursor) || (page != index->cursor / ARCHIVE_DIR_INDEX_PAGE_SIZE)) {
+        if(!storage_file_seek(index->file, index->pages[page], true)) {
+            index->cursor = UINT32_MAX;
+            return NULL;
+        }
+        index->cursor = page * ARCHIVE_DIR_INDEX_PAGE_SIZE;
+    }
+
+    ArchiveDirIndexItem item;
+    const char* name = NULL;
+    while(storage_file_read(index->file, &item, sizeof(item)) == sizeof(item)) {
+        if(index->cursor == idx) {
+            if(storage_file_read(index->file, index->name, item.name_len) == item.name_len) {
+                index->name[item.name_len] = '\0';
+                name = index->name;
+            }
+            break;
+        }
+        if(!storage_file_seek(index->file, item.name_len, false)) break;
+        index->cursor++;
+    }
+
+    if(name) {
+        index->cursor++;
+        if(file_info) {
+            file_info->flags = item.flags;
+            file_info->size = item.size;
+        }
+    } else {
+        index->cursor = UINT32_MAX;
+    }
+
+    return name;
+}
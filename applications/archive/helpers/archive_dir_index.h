@@ -0,0 +1,24 @@
+#pragma once
+
+#include <storage/storage.h>
+
+/* Index file, hidden from browser */
+#define ARCHIVE_DIR_INDEX_PATH "/ext/.archive_dir.idx"
+
+/* List of directory items matching tab extension, in directory order.
+ * Built once per directory, rebuilt after storage reports a change,
+ * so any page of a big directory is read without going through it again.
+ * Items are kept on SD card, only offset of every page is kept in memory.
+ */
+typedef struct ArchiveDirIndex ArchiveDirIndex;
+
+ArchiveDirIndex* archive_dir_index_alloc();
+void archive_dir_index_free(ArchiveDirIndex* index);
+
+/* Returns false if index can't be written, directory should be read without it */
+bool archive_dir_index_update(ArchiveDirIndex* index, const char* path, const char* tab_ext);
+uint32_t archive_dir_index_get_count(ArchiveDirIndex* index);
+
+/* Returns item name, valid until next call, or NULL on read error.
+ * Consecutive items are read without seeking */
+const char* archive_dir_index_get_item(ArchiveDirIndex* index, uint32_t idx, FileInfo* file_info);
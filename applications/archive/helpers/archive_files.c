@@ -1,6 +1,7 @@
 #include "archive_files.h"
 #include "archive_apps.h"
 #include "archive_browser.h"
+#include "archive_dir_index.h"
 
 #define TAG "Archive"
 
@@ -12,13 +13,18 @@ bool archive_filter_by_extension(FileInfo* file_info, const char* tab_ext, const
     furi_assert(name);
 
     bool result = false;
+    /* Full path may be passed, but only item name is matched */
+    const char* file_name = strrchr(name, '/');
+    file_name = file_name ? file_name + 1 : name;
 
-    if(strcmp(tab_ext, "*") == 0) {
+    if(strcmp(name, ARCHIVE_DIR_INDEX_PATH) == 0) {
+        result = false;
+    } else if(strcmp(tab_ext, "*") == 0) {
         result = true;
-    } else if(strstr(name, tab_ext) != NULL) {
+    } else if(strstr(file_name, tab_ext) != NULL) {
         result = true;
     } else if(file_info->flags & FSF_DIRECTORY) {
-        if(strstr(name, ASSETS_DIR) != NULL) {
+        if(strstr(file_name, ASSETS_DIR) != NULL) {
             result = false; // Skip assets folder in all tabs except browser
         } else {
             result = true;
@@ -94,31 +100,38 @@ bool archive_get_filenames(void* context, const char* path) {
     return res;
 }
 
-uint32_t archive_dir_count_items(void* context, const char* path) {
-    furi_assert(context);
-    ArchiveBrowserView* browser = context;
+bool archive_dir_read_next(
+    File* directory,
+    FileInfo* file_info,
+    char* path,
+    size_t path_len,
+    const char* tab_ext) {
+    furi_assert(path_len < MAX_NAME_LEN);
+
+    while(storage_dir_read(directory, file_info, &path[path_len], MAX_NAME_LEN - path_len)) {
+        if(storage_file_get_error(directory) != FSE_OK) break;
+        if(path[path_len] && archive_filter_by_extension(file_info, tab_ext, path)) {
+            return true;
+        }
+    }
+
+    return false;
+}
 
+/* Read entry by entry when index can't be written, in the same order and with the same filter */
+static uint32_t archive_dir_count_items_unindexed(ArchiveBrowserView* browser, const char* path) {
     FileInfo file_info;
     Storage* fs_api = furi_record_open("storage");
     File* directory = storage_file_alloc(fs_api);
     char name[MAX_NAME_LEN];
-
-    if(!storage_dir_open(directory, path)) {
-        storage_dir_close(directory);
-        storage_file_free(directory);
-        return 0;
-    }
+    snprintf(name, MAX_NAME_LEN, "%s/", path);
+    size_t path_len = strlen(name);
+    const char* tab_ext = archive_get_tab_ext(archive_get_tab(browser));
 
     uint32_t files_found = 0;
-    while(1) {
-        if(!storage_dir_read(directory, &file_info, name, MAX_NAME_LEN)) {
-            break;
-        }
-        if((storage_file_get_error(directory) == FSE_OK) && (name[0])) {
-            if(archive_filter_by_extension(
-                   &file_info, archive_get_tab_ext(archive_get_tab(browser)), name)) {
-                files_found++;
-            }
+    if(storage_dir_open(directory, path)) {
+        while(archive_dir_read_next(directory, &file_info, name, path_len, tab_ext)) {
+            files_found++;
         }
     }
     storage_dir_close(directory);
@@ -126,68 +139,96 @@ uint32_t archive_dir_count_items(void* context, const char* path) {
 
     furi_record_close("storage");
 
-    archive_set_item_count(browser, files_found);
-
     return files_found;
 }
 
-uint32_t archive_dir_read_items(void* context, const char* path, uint32_t offset, uint32_t count) {
+uint32_t archive_dir_count_items(void* context, const char* path) {
     furi_assert(context);
-
     ArchiveBrowserView* browser = context;
+
+    uint32_t files_found = 0;
+    if(archive_dir_index_update(
+           browser->dir_index, path, archive_get_tab_ext(archive_get_tab(browser)))) {
+        files_found = archive_dir_index_get_count(browser->dir_index);
+    } else {
+        files_found = archive_dir_count_items_unindexed(browser, path);
+    }
+
+    archive_set_item_count(browser, files_found);
+
+    return files_found;
+}
+
+static bool archive_dir_read_items_unindexed(
+    ArchiveBrowserView* browser,
+    const char* path,
+    uint32_t offset,
+    uint32_t count) {
     FileInfo file_info;
     Storage* fs_api = furi_record_open("storage");
     File* directory = storage_file_alloc(fs_api);
     char name[MAX_NAME_LEN];
     snprintf(name, MAX_NAME_LEN, "%s/", path);
     size_t path_len = strlen(name);
+    const char* tab_ext = archive_get_tab_ext(archive_get_tab(browser));
+    bool result = false;
 
-    if(!storage_dir_open(directory, path)) {
-        storage_dir_close(directory);
-        storage_file_free(directory);
-        return false;
-    }
+    do {
+        if(!storage_dir_open(directory, path)) break;
 
-    // Skip items before offset
-    uint32_t items_cnt = 0;
-    while(items_cnt < offset) {
-        if(!storage_dir_read(directory, &file_info, &name[path_len], MAX_NAME_LEN)) {
-            break;
+        // Skip items before offset
+        uint32_t items_cnt = 0;
+        while((items_cnt < offset) &&
+              archive_dir_read_next(directory, &file_info, name, path_len, tab_ext)) {
+            items_cnt++;
         }
-        if(storage_file_get_error(directory) == FSE_OK) {
-            if(archive_filter_by_extension(
-                   &file_info, archive_get_tab_ext(archive_get_tab(browser)), name)) {
-                items_cnt++;
-            }
-        } else {
-            break;
+        if(items_cnt != offset) break;
+
+        items_cnt = 0;
+        archive_file_array_rm_all(browser);
+        while((items_cnt < count) &&
+              archive_dir_read_next(directory, &file_info, name, path_len, tab_ext)) {
+            archive_add_file_item(browser, &file_info, name);
+            items_cnt++;
         }
+        result = (items_cnt == count);
+    } while(0);
+
+    storage_dir_close(directory);
+    storage_file_free(directory);
+    furi_record_close("storage");
+
+    return result;
+}
+
+uint32_t archive_dir_read_items(void* context, const char* path, uint32_t offset, uint32_t count) {
+    furi_assert(context);
+    ArchiveBrowserView* browser = context;
+    ArchiveDirIndex* index = browser->dir_index;
+
+    if(!archive_dir_index_update(index, path, archive_get_tab_ext(archive_get_tab(browser)))) {
+        return archive_dir_read_items_unindexed(browser, path, offset, count);
     }
-    if(items_cnt != offset) {
-        storage_dir_close(directory);
-        storage_file_free(directory);
-        furi_record_close("storage");
 
+    uint32_t items_total = archive_dir_index_get_count(index);
+    if(offset > items_total) {
         return false;
     }
 
-    items_cnt = 0;
     archive_file_array_rm_all(browser);
-    while(items_cnt < count) {
-        if(!storage_dir_read(directory, &file_info, &name[path_len], MAX_NAME_LEN - path_len)) {
-            break;
-        }
 
-        if(storage_file_get_error(directory) == FSE_OK) {
-            archive_add_file_item(browser, &file_info, name);
-            items_cnt++;
-        } else {
-            break;
-        }
+    FileInfo file_info;
+    string_t name;
+    string_init(name);
+    uint32_t items_cnt = 0;
+    while((items_cnt < count) && (offset + items_cnt < items_total)) {
+        const char* item_name = archive_dir_index_get_item(index, offset + items_cnt, &file_info);
+        if(!item_name) break;
+        string_printf(name, "%s/%s", path, item_name);
+        archive_add_file_item(browser, &file_info, string_get_cstr(name));
+        items_cnt++;
     }
-    storage_dir_close(directory);
-    storage_file_free(directory);
-    furi_record_close("storage");
+    string_clear(name);
 
     return (items_cnt == count);
 }
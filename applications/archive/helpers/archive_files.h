@@ -59,6 +59,13 @@ ARRAY_DEF(
      CLEAR(API_2(ArchiveFile_t_clear))))
 
 bool archive_filter_by_extension(FileInfo* file_info, const char* tab_ext, const char* name);
+/* Read next directory item matching tab extension, its name is written to path at path_len */
+bool archive_dir_read_next(
+    File* directory,
+    FileInfo* file_info,
+    char* path,
+    size_t path_len,
+    const char* tab_ext);
 void archive_set_file_type(ArchiveFile_t* file, FileInfo* file_info, const char* path, bool is_app);
 void archive_trim_file_path(char* name, bool ext);
 void archive_get_file_extension(char* name, char* ext);
@@ -351,6 +351,7 @@ ArchiveBrowserView* browser_alloc() {
     view_set_input_callback(browser->view, archive_view_input);
 
     string_init(browser->path);
+    browser->dir_index = archive_dir_index_alloc();
 
     with_view_model(
         browser->view, (ArchiveBrowserViewModel * model) {
@@ -373,6 +374,7 @@ void browser_free(ArchiveBrowserView* browser) {
         });
 
     string_clear(browser->path);
+    archive_dir_index_free(browser->dir_index);
 
     view_free(browser->view);
     free(browser);
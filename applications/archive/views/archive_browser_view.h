@@ -8,6 +8,7 @@
 #include <storage/storage.h>
 #include "../helpers/archive_files.h"
 #include "../helpers/archive_favorites.h"
+#include "../helpers/archive_dir_index.h"
 
 #define MAX_LEN_PX 110
 #define MAX_NAME_LEN 255
@@ -74,6 +75,7 @@ struct ArchiveBrowserView {
     void* context;
 
     string_t path;
+    ArchiveDirIndex* dir_index;
 };
 
 ARRAY_DEF(idx_last_array, int32_t)
@@ -202,6 +202,7 @@ static bool bt_on_gap_event_callback(GapEvent event, void* context) {
             bt->rpc_session = rpc_session_open(bt->rpc);
             if(bt->rpc_session) {
                 FURI_LOG_I(TAG, "Open RPC connection");
+                rpc_session_set_features(bt->rpc_session, RPC_SESSION_FEATURES_BT);
                 rpc_session_set_send_bytes_callback(bt->rpc_session, bt_rpc_send_bytes_callback);
                 rpc_session_set_buffer_is_empty_callback(
                     bt->rpc_session, furi_hal_bt_serial_notify_buffer_is_empty);
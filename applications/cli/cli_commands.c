@@ -7,6 +7,7 @@
 #include <notification/notification_messages.h>
 #include <loader/loader.h>
 #include <stream_buffer.h>
+#include <lib/toolbox/args.h>
 
 // Close to ISO, `date +'%Y-%m-%d %H:%M:%S %u'`
 #define CLI_DATE_FORMAT "%.4d-%.2d-%.2d %.2d:%.2d:%.2d %d"
@@ -135,6 +136,23 @@ void cli_command_log_tx_callback(const uint8_t* buffer, size_t size, void* conte
 }
 
 void cli_command_log(Cli* cli, string_t args, void* context) {
+    if(!string_cmp(args, "deferred")) {
+        furi_log_set_deferred(true);
+        printf("Deferred logging enabled, %lu records dropped so far\r\n", furi_log_get_dropped());
+        return;
+    } else if(!string_cmp(args, "trace")) {
+        // Binary frames for scripts/log_decode.py
+        furi_log_set_trace(furi_hal_console_tx);
+        return;
+    } else if(!string_cmp(args, "direct")) {
+        furi_log_set_trace(NULL);
+        furi_log_set_deferred(false);
+        return;
+    } else if(string_size(args)) {
+        cli_print_usage("log", "<deferred|trace|direct>", string_get_cstr(args));
+        return;
+    }
+
     StreamBufferHandle_t ring = xStreamBufferCreate(CLI_COMMAND_LOG_RING_SIZE, 1);
     uint8_t buffer[CLI_COMMAND_LOG_BUFFER_SIZE];
 
@@ -348,12 +366,62 @@ void cli_command_free(Cli* cli, string_t args, void* context) {
     printf("Total heap size: %d\r\n", memmgr_get_total_heap());
     printf("Minimum heap size: %d\r\n", memmgr_get_minimum_free_heap());
     printf("Maximum heap block: %d\r\n", memmgr_heap_get_max_free_block());
+
+    MemmgrHeapPoolStats pool_stats;
+    memmgr_heap_get_pool_stats(&pool_stats);
+    printf(
+        "Pool slabs used: %lu/%lu, bytes used: %u, allocations: %lu, fallbacks: %lu\r\n",
+        pool_stats.slabs_used,
+        pool_stats.slabs_total,
+        pool_stats.used,
+        pool_stats.allocations,
+        pool_stats.fallbacks);
+
+    FuriHalCompressIconCacheStats icon_cache_stats;
+    furi_hal_compress_icon_cache_get_stats(&icon_cache_stats);
+    printf(
+        "Icon cache: %u/%u bytes, hits: %lu, misses: %lu\r\n",
+        icon_cache_stats.used,
+        icon_cache_stats.size,
+        icon_cache_stats.hits,
+        icon_cache_stats.misses);
 }
 
 void cli_command_free_blocks(Cli* cli, string_t args, void* context) {
     memmgr_heap_printf_free_blocks();
 }
 
+void cli_command_heap_profile_callback(
+    const char* key,
+    const char* value,
+    bool last,
+    void* context) {
+    printf("%-32s: %s\r\n", key, value);
+}
+
+void cli_command_heap_profile(Cli* cli, string_t args, void* context) {
+    string_t mode;
+    string_init(mode);
+    args_read_string_and_trim(args, mode);
+
+    if(string_cmp_str(mode, "start") == 0) {
+        int sample_rate = 0;
+        args_read_int_and_trim(args, &sample_rate);
+        memmgr_heap_profile_start(sample_rate > 0 ? sample_rate : 0);
+        printf("Heap profiling started\r\n");
+    } else if(string_cmp_str(mode, "stop") == 0) {
+        memmgr_heap_profile_stop();
+        printf("Heap profiling stopped\r\n");
+    } else if(string_size(mode) == 0 || string_cmp_str(mode, "show") == 0) {
+        memmgr_heap_profile_export(cli_command_heap_profile_callback, NULL);
+        printf("size_N: allocations live, caller_N: address thread count bytes\r\n");
+    } else {
+        cli_print_usage("heap_profile", "<start [sample_rate]|stop|show>", string_get_cstr(mode));
+    }
+
+    string_clear(mode);
+}
+
 void cli_command_i2c(Cli* cli, string_t args, void* context) {
     furi_hal_i2c_acquire(&furi_hal_i2c_handle_external);
     printf("Scanning external i2c on PC0(SCL)/PC1(SDA)\r\n"
@@ -386,6 +454,8 @@ void cli_commands_init(Cli* cli) {
     cli_add_command(cli, "ps", CliCommandFlagParallelSafe, cli_command_ps, NULL);
     cli_add_command(cli, "free", CliCommandFlagParallelSafe, cli_command_free, NULL);
     cli_add_command(cli, "free_blocks", CliCommandFlagParallelSafe, cli_command_free_blocks, NULL);
+    cli_add_command(
+        cli, "heap_profile", CliCommandFlagParallelSafe, cli_command_heap_profile, NULL);
 
     cli_add_command(cli, "vibro", CliCommandFlagDefault, cli_command_vibro, NULL);
     cli_add_command(cli, "led", CliCommandFlagDefault, cli_command_led, NULL);
@@ -0,0 +1,322 @@
+#include "animation_frame_stream.h"
+
+#include <furi.h>
+#include <storage/storage.h>
+#include <m-string.h>
+
+#define TAG "AnimationFrameStream"
+
+/* Frame being shown, prefetched next one and one more,
+ * so short passive loops don't touch SD-card at all */
+#define ANIMATION_FRAME_STREAM_WINDOW 3
+#define ANIMATION_FRAME_STREAM_QUEUE_DEPTH 2
+#define ANIMATION_FRAME_STREAM_STACK_SIZE 2048
+#define ANIMATION_FRAME_STREAM_STOP 0xFFFF
+
+typedef struct {
+    uint8_t* data;
+    int16_t frame; /**< -1 if slot is empty */
+    uint32_t used; /**< for least recently used replacement */
+} AnimationFrameSlot;
+
+struct AnimationFrameStream {
+    Storage* storage;
+    File* file;
+    string_t directory;
+    uint32_t* offsets; /**< bundle offsets table, NULL for separate files */
+    uint8_t frame_count;
+    size_t frame_size_max;
+
+    osMutexId_t mutex;
+    AnimationFrameSlot slots[ANIMATION_FRAME_STREAM_WINDOW];
+    uint8_t current; /**< slot returned by last get, never replaced */
+    uint32_t stamp;
+    FuriThread* thread;
+    osMessageQueueId_t queue;
+};
+
+static void animation_frame_stream_frame_path(
+    string_t path,
+    AnimationFrameStream* stream,
+    uint8_t frame) {
+    string_printf(path, "%s/frame_%u.bm", string_get_cstr(stream->directory), frame);
+}
+
+bool animation_frame_stream_has_bundle(const char* directory) {
+    furi_assert(directory);
+
+    Storage* storage = furi_record_open("storage");
+    string_t path;
+    string_init_printf(path, "%s/" ANIMATION_BUNDLE_FILE, directory);
+    bool exists = storage_common_stat(storage, string_get_cstr(path), NULL) == FSE_OK;
+    string_clear(path);
+    furi_record_close("storage");
+
+    return exists;
+}
+
+static bool animation_frame_stream_open_bundle(
+    AnimationFrameStream* stream,
+    uint8_t width,
+    uint8_t height) {
+    string_t path;
+    string_init_printf(path, "%s/" ANIMATION_BUNDLE_FILE, string_get_cstr(stream->directory));
+    size_t table_size = sizeof(uint32_t) * (stream->frame_count + 1);
+    stream->offsets = malloc(table_size);
+
+    bool result = false;
+    do {
+        if(!storage_file_open(
+               stream->file, string_get_cstr(path), FSAM_READ, FSOM_OPEN_EXISTING)) {
+            FURI_LOG_E(TAG, "Can't open file \'%s\'", string_get_cstr(path));
+            break;
+        }
+
+        AnimationBundleHeader header;
+        if(storage_file_read(stream->file, &header, sizeof(header)) != sizeof(header)) break;
+        if((header.magic != ANIMATION_BUNDLE_MAGIC) ||
+           (header.version != ANIMATION_BUNDLE_VERSION)) {
+            FURI_LOG_E(TAG, "Unsupported bundle \'%s\'", string_get_cstr(path));
+            break;
+        }
+        if((header.frame_count != stream->frame_count) || (header.width != width) ||
+           (header.height != height)) {
+            FURI_LOG_E(
+                TAG,
+                "Bundle %ux%u, %u frames, expected %ux%u, %u frames",
+                header.width,
+                header.height,
+                header.frame_count,
+                width,
+                height,
+                stream->frame_count);
+            break;
+        }
+        if(storage_file_read(stream->file, stream->offsets, table_size) != table_size) break;
+
+        /* Frames go one after another, right after the table, up to end of file */
+        if(stream->offsets[0] != sizeof(header) + table_size) break;
+        if(stream->offsets[stream->frame_count] != storage_file_size(stream->file)) break;
+
+        result = true;
+        for(uint8_t i = 0; i < stream->frame_count; ++i) {
+            uint32_t size = stream->offsets[i + 1] - stream->offsets[i];
+            if((stream->offsets[i + 1] <= stream->offsets[i]) || (size > stream->frame_size_max)) {
+                FURI_LOG_E(TAG, "Frame %u size %lu, max: %u", i, size, stream->frame_size_max);
+                result = false;
+                break;
+            }
+        }
+    } while(0);
+
+    string_clear(path);
+    return result;
+}
+
+static bool animation_frame_stream_check_files(AnimationFrameStream* stream) {
+    string_t path;
+    string_init(path);
+    FileInfo file_info;
+
+    bool result = true;
+    for(uint8_t i = 0; i < stream->frame_count; ++i) {
+        animation_frame_stream_frame_path(path, stream, i);
+        if(storage_common_stat(stream->storage, string_get_cstr(path), &file_info) != FSE_OK) {
+            FURI_LOG_E(TAG, "Can't stat file \'%s\'", string_get_cstr(path));
+            result = false;
+            break;
+        }
+        if((file_info.size == 0) || (file_info.size > stream->frame_size_max)) {
+            FURI_LOG_E(
+                TAG,
+                "Filesize %d, max: %d (\'%s\')",
+                file_info.size,
+                stream->frame_size_max,
+                string_get_cstr(path));
+            result = false;
+            break;
+        }
+    }
+
+    string_clear(path);
+    return result;
+}
+
+AnimationFrameStream* animation_frame_stream_alloc(
+    const char* directory,
+    uint8_t frame_count,
+    uint8_t width,
+    uint8_t height) {
+    furi_assert(directory);
+    furi_assert(frame_count);
+
+    AnimationFrameStream* stream = malloc(sizeof(AnimationFrameStream));
+    stream->storage = furi_record_open("storage");
+    stream->file = storage_file_alloc(stream->storage);
+    string_init_set_str(stream->directory, directory);
+    stream->frame_count = frame_count;
+    /* compressed bitmap is never bigger than uncompressed one plus header */
+    stream->frame_size_max = ROUND_UP_TO(width, 8) * height + 1;
+    stream->mutex = osMutexNew(NULL);
+    for(uint8_t i = 0; i < ANIMATION_FRAME_STREAM_WINDOW; ++i) {
+        stream->slots[i].frame = -1;
+    }
+
+    bool result;
+    if(animation_frame_stream_has_bundle(directory)) {
+        result = animation_frame_stream_open_bundle(stream, width, height);
+    } else {
+        result = animation_frame_stream_check_files(stream);
+    }
+
+    if(!result) {
+        animation_frame_stream_free(stream);
+        stream = NULL;
+    }
+
+    return stream;
+}
+
+/* Must be called with mutex taken */
+static bool
+    animation_frame_stream_read(AnimationFrameStream* stream, uint8_t frame, uint8_t* data) {
+    bool result = false;
+
+    if(stream->offsets) {
+        uint32_t size = stream->offsets[frame + 1] - stream->offsets[frame];
+        result = storage_file_seek(stream->file, stream->offsets[frame], true) &&
+                 (storage_file_read(stream->file, data, size) == size);
+    } else {
+        string_t path;
+        string_init(path);
+        animation_frame_stream_frame_path(path, stream, frame);
+        if(storage_file_open(stream->file, string_get_cstr(path), FSAM_READ, FSOM_OPEN_EXISTING)) {
+            result = storage_file_read(stream->file, data, stream->frame_size_max) > 0;
+            storage_file_close(stream->file);
+        }
+        string_clear(path);
+    }
+
+    if(!result) {
+        FURI_LOG_E(TAG, "Failed to read frame %u", frame);
+    }
+
+    return result;
+}
+
+/* Must be called with mutex taken. Returns slot with frame, -1 on error */
+static int8_t animation_frame_stream_load(AnimationFrameStream* stream, uint8_t frame) {
+    int8_t slot = -1;
+
+    for(uint8_t i = 0; i < ANIMATION_FRAME_STREAM_WINDOW; ++i) {
+        if(stream->slots[i].frame == frame) {
+            slot = i;
+            break;
+        }
+        if((i != stream->current) &&
+           ((slot < 0) || (stream->slots[i].used < stream->slots[slot].used))) {
+            slot = i;
+        }
+    }
+
+    if(stream->slots[slot].frame != frame) {
+        stream->slots[slot].frame = -1;
+        if(!animation_frame_stream_read(stream, frame, stream->slots[slot].data)) {
+            return -1;
+        }
+        stream->slots[slot].frame = frame;
+    }
+    stream->slots[slot].used = ++stream->stamp;
+
+    return slot;
+}
+
+static int32_t animation_frame_stream_worker(void* context) {
+    AnimationFrameStream* stream = context;
+    uint16_t frame;
+
+    for(;;) {
+        furi_check(osMessageQueueGet(stream->queue, &frame, NULL, osWaitForever) == osOK);
+        if(frame == ANIMATION_FRAME_STREAM_STOP) break;
+
+        furi_check(osMutexAcquire(stream->mutex, osWaitForever) == osOK);
+        animation_frame_stream_load(stream, frame);
+        osMutexRelease(stream->mutex);
+    }
+
+    return 0;
+}
+
+/* Window is allocated on first use, so animations which are
+ * loaded, but never shown, don't hold any frame memory */
+static void animation_frame_stream_start(AnimationFrameStream* stream) {
+    for(uint8_t i = 0; i < ANIMATION_FRAME_STREAM_WINDOW; ++i) {
+        stream->slots[i].data = malloc(stream->frame_size_max);
+    }
+
+    stream->queue = osMessageQueueNew(ANIMATION_FRAME_STREAM_QUEUE_DEPTH, sizeof(uint16_t), NULL);
+    stream->thread = furi_thread_alloc();
+    furi_thread_set_name(stream->thread, "AnimFrames");
+    furi_thread_set_stack_size(stream->thread, ANIMATION_FRAME_STREAM_STACK_SIZE);
+    furi_thread_set_context(stream->thread, stream);
+    furi_thread_set_callback(stream->thread, animation_frame_stream_worker);
+    furi_thread_start(stream->thread);
+}
+
+void animation_frame_stream_free(AnimationFrameStream* stream) {
+    furi_assert(stream);
+
+    if(stream->thread) {
+        uint16_t message = ANIMATION_FRAME_STREAM_STOP;
+        furi_check(osMessageQueuePut(stream->queue, &message, 0, osWaitForever) == osOK);
+        furi_thread_join(stream->thread);
+        furi_thread_free(stream->thread);
+        osMessageQueueDelete(stream->queue);
+    }
+
+    for(uint8_t i = 0; i < ANIMATION_FRAME_STREAM_WINDOW; ++i) {
+        free(stream->slots[i].data);
+    }
+
+    if(storage_file_is_open(stream->file)) {
+        storage_file_close(stream->file);
+    }
+    storage_file_free(stream->file);
+    free(stream->offsets);
+    string_clear(stream->directory);
+    osMutexDelete(stream->mutex);
+    furi_record_close("storage");
+    free(stream);
+}
+
+const uint8_t* animation_frame_stream_get(AnimationFrameStream* stream, uint8_t frame) {
+    furi_assert(stream);
+    furi_assert(frame < stream->frame_count);
+
+    furi_check(osMutexAcquire(stream->mutex, osWaitForever) == osOK);
+    if(!stream->thread) {
+        animation_frame_stream_start(stream);
+    }
+
+    int8_t slot = animation_frame_stream_load(stream, frame);
+    if(slot >= 0) {
+        stream->current = slot;
+    }
+    const AnimationFrameSlot* current = &stream->slots[stream->current];
+    const uint8_t* data = (current->frame >= 0) ? current->data : NULL;
+    osMutexRelease(stream->mutex);
+
+    return data;
+}
+
+void animation_frame_stream_prefetch(AnimationFrameStream* stream, uint8_t frame) {
+    furi_assert(stream);
+    furi_assert(frame < stream->frame_count);
+
+    /* Nothing is shown yet */
+    if(!stream->queue) return;
+
+    /* Queue is full only if worker is behind, then this request is dropped */
+    uint16_t message = frame;
+    osMessageQueuePut(stream->queue, &message, 0, 0);
+}
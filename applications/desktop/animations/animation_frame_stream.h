@@ -0,0 +1,83 @@
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+
+/** Frames of external animation, read from SD-card while playing.
+ * Only a small window of frames is kept in memory, next frame
+ * is read in background before it is requested.
+ */
+typedef struct AnimationFrameStream AnimationFrameStream;
+
+/** Single file with all frames of animation.
+ * AnimationBundleHeader, then frame_count + 1 offsets (uint32_t, from start
+ * of file, last one is file size), then frames data, same as in frame_N.bm.
+ * Keep in sync with scripts/flipper/assets/dolphin.py
+ */
+#define ANIMATION_BUNDLE_FILE "frames.bundle"
+#define ANIMATION_BUNDLE_MAGIC 0x4E424641 /* "AFBN" */
+#define ANIMATION_BUNDLE_VERSION 1
+
+#pragma pack(push, 1)
+
+typedef struct {
+    uint32_t magic;
+    uint8_t version;
+    uint8_t frame_count;
+    uint8_t width;
+    uint8_t height;
+} AnimationBundleHeader;
+
+#pragma pack(pop)
+
+/**
+ * Check if animation directory contains frames bundle.
+ *
+ * @directory       animation directory
+ * @return          true if bundle file exists
+ */
+bool animation_frame_stream_has_bundle(const char* directory);
+
+/**
+ * Prepare frames of animation for streaming.
+ * Frames are taken from bundle if it exists, from separate
+ * frame_N.bm files otherwise. Size of every frame is checked,
+ * but no frame data is read.
+ *
+ * @directory       animation directory
+ * @frame_count     number of frames
+ * @width           frame width
+ * @height          frame height
+ * @return          stream instance, NULL if frames are invalid
+ */
+AnimationFrameStream* animation_frame_stream_alloc(
+    const char* directory,
+    uint8_t frame_count,
+    uint8_t width,
+    uint8_t height);
+
+/**
+ * Free stream and all its frames.
+ *
+ * @stream          stream instance
+ */
+void animation_frame_stream_free(AnimationFrameStream* stream);
+
+/**
+ * Get frame data, read it if it is not in window yet.
+ * Data stays valid until next call. If frame can't be read,
+ * previously returned frame is returned again.
+ *
+ * @stream          stream instance
+ * @frame           frame number
+ * @return          frame bitmap, NULL if nothing was read yet
+ */
+const uint8_t* animation_frame_stream_get(AnimationFrameStream* stream, uint8_t frame);
+
+/**
+ * Request background read of frame which is going to be shown next.
+ * Doesn't block.
+ *
+ * @stream          stream instance
+ * @frame           frame number
+ */
+void animation_frame_stream_prefetch(AnimationFrameStream* stream, uint8_t frame);
@@ -16,6 +16,9 @@
 #define ANIMATION_META_FILE "meta.txt"
 #define ANIMATION_DIR "/ext/dolphin"
 #define ANIMATION_MANIFEST_FILE ANIMATION_DIR "/manifest.txt"
+/* Animations with more frame data are streamed from SD-card while playing.
+ * Streaming window and its worker take about 5K for the biggest frames. */
+#define ANIMATION_PRELOAD_SIZE_MAX 8192
 #define TAG "AnimationStorage"
 
 static void animation_storage_free_bubbles(BubbleAnimation* animation);
@@ -252,7 +255,14 @@ static bool animation_storage_cast_align(string_t align_str, Align* align) {
 static void animation_storage_free_frames(BubbleAnimation* animation) {
     furi_assert(animation);
 
-    const Icon* icon = &animation->icon_animation;
+    if(animation->frame_stream) {
+        animation_frame_stream_free(animation->frame_stream);
+        animation->frame_stream = NULL;
+    }
+
+    Icon* icon = (Icon*)&animation->icon_animation;
+    if(!icon->frames) return;
+
     for(int i = 0; i < icon->frame_count; ++i) {
         if(icon->frames[i]) {
             free((void*)icon->frames[i]);
@@ -260,6 +270,7 @@ static void animation_storage_free_frames(BubbleAnimation* animation) {
     }
 
     free((void*)icon->frames);
+    icon->frames = NULL;
 }
 
 static bool animation_storage_load_frames(
@@ -286,14 +297,24 @@ static bool animation_storage_load_frames(
     FURI_CONST_ASSIGN(icon->frame_rate, 0);
     FURI_CONST_ASSIGN(icon->height, height);
     FURI_CONST_ASSIGN(icon->width, width);
+    size_t max_filesize = ROUND_UP_TO(width, 8) * height + 1;
+
+    string_t filename;
+    string_init_printf(filename, ANIMATION_DIR "/%s", name);
+    bool stream = animation_frame_stream_has_bundle(string_get_cstr(filename)) ||
+                  (icon->frame_count * max_filesize > ANIMATION_PRELOAD_SIZE_MAX);
+    if(stream) {
+        animation->frame_stream = animation_frame_stream_alloc(
+            string_get_cstr(filename), icon->frame_count, width, height);
+        string_clear(filename);
+        return !!animation->frame_stream;
+    }
+
     icon->frames = malloc(sizeof(const uint8_t*) * icon->frame_count);
 
     bool frames_ok = false;
     File* file = storage_file_alloc(storage);
     FileInfo file_info;
-    string_t filename;
-    string_init(filename);
-    size_t max_filesize = ROUND_UP_TO(width, 8) * height + 1;
 
     for(int i = 0; i < icon->frame_count; ++i) {
         frames_ok = false;
@@ -499,6 +520,7 @@ static BubbleAnimation* animation_storage_load_animation(const char* name) {
     }
 
     if(!success) {
+        animation_storage_free_frames(animation);
         if(animation->frame_order) {
             free((void*)animation->frame_order);
         }
@@ -39,23 +39,63 @@ struct BubbleAnimationView {
 static void bubble_animation_activate(BubbleAnimationView* view, bool force);
 static void bubble_animation_activate_right_now(BubbleAnimationView* view);
 
-static uint8_t bubble_animation_get_frame_index(BubbleAnimationViewModel* model) {
-    furi_assert(model);
+static uint8_t
+    bubble_animation_get_frame_index(const BubbleAnimation* animation, uint8_t current_frame) {
+    furi_assert(animation);
     uint8_t icon_index = 0;
-    const BubbleAnimation* animation = model->current;
 
-    if(model->current_frame < animation->passive_frames) {
-        icon_index = model->current_frame;
+    if(current_frame < animation->passive_frames) {
+        icon_index = current_frame;
     } else {
-        icon_index =
-            (model->current_frame - animation->passive_frames) % animation->active_frames +
-            animation->passive_frames;
+        icon_index = (current_frame - animation->passive_frames) % animation->active_frames +
+                     animation->passive_frames;
     }
     furi_assert(icon_index < (animation->passive_frames + animation->active_frames));
 
     return animation->frame_order[icon_index];
 }
 
+/* Advance (frame, cycle) pair by one tick, returns true if active part has just ended */
+static bool bubble_animation_advance_frame(
+    const BubbleAnimation* animation,
+    uint8_t* current_frame,
+    uint8_t* active_cycle) {
+    furi_assert(animation);
+
+    if(*current_frame < animation->passive_frames) {
+        *current_frame = (*current_frame + 1) % animation->passive_frames;
+        return false;
+    }
+
+    ++*current_frame;
+    *active_cycle += !((*current_frame - animation->passive_frames) % animation->active_frames);
+    if(*active_cycle >= animation->active_cycles) {
+        *active_cycle = 0;
+        *current_frame = 0;
+        return true;
+    }
+
+    return false;
+}
+
+/* Frame to be shown on next tick, if animation is not activated until then */
+static uint8_t bubble_animation_get_next_frame(BubbleAnimationViewModel* model) {
+    uint8_t current_frame = model->current_frame;
+    uint8_t active_cycle = model->active_cycle;
+
+    bubble_animation_advance_frame(model->current, &current_frame, &active_cycle);
+
+    return current_frame;
+}
+
+static const uint8_t*
+    bubble_animation_get_frame_data(const BubbleAnimation* animation, uint8_t index) {
+    if(animation->frame_stream) {
+        return animation_frame_stream_get(animation->frame_stream, index);
+    }
+    return animation->icon_animation.frames[index];
+}
+
 static void bubble_animation_draw_callback(Canvas* canvas, void* model_) {
     furi_assert(model_);
     furi_assert(canvas);
@@ -75,12 +115,20 @@ static void bubble_animation_draw_callback(Canvas* canvas, void* model_) {
 
     furi_assert(model->current_frame < 255);
 
-    uint8_t index = bubble_animation_get_frame_index(model);
+    uint8_t index = bubble_animation_get_frame_index(animation, model->current_frame);
     uint8_t width = icon_get_width(&animation->icon_animation);
     uint8_t height = icon_get_height(&animation->icon_animation);
     uint8_t y_offset = canvas_height(canvas) - height;
-    canvas_draw_bitmap(
-        canvas, 0, y_offset, width, height, animation->icon_animation.frames[index]);
+    const uint8_t* frame = bubble_animation_get_frame_data(animation, index);
+    if(frame) {
+        canvas_draw_bitmap(canvas, 0, y_offset, width, height, frame);
+    }
+
+    if(animation->frame_stream) {
+        uint8_t next_index =
+            bubble_animation_get_frame_index(animation, bubble_animation_get_next_frame(model));
+        animation_frame_stream_prefetch(animation->frame_stream, next_index);
+    }
 
     const FrameBubble* bubble = model->current_bubble;
     if(bubble) {
@@ -202,25 +250,17 @@ static void bubble_animation_next_frame(BubbleAnimationViewModel* model) {
         return;
     }
 
-    if(model->current_frame < model->current->passive_frames) {
-        model->current_frame = (model->current_frame + 1) % model->current->passive_frames;
-    } else {
-        ++model->current_frame;
-        model->active_cycle +=
-            !((model->current_frame - model->current->passive_frames) %
-              model->current->active_frames);
-        if(model->active_cycle >= model->current->active_cycles) {
-            // switch to passive
-            model->active_cycle = 0;
-            model->current_frame = 0;
-            model->current_bubble = bubble_animation_pick_bubble(model, false);
-            model->active_ended_at = xTaskGetTickCount();
-        }
+    bool active = model->current_frame >= model->current->passive_frames;
+    if(bubble_animation_advance_frame(
+           model->current, &model->current_frame, &model->active_cycle)) {
+        // switch to passive
+        model->current_bubble = bubble_animation_pick_bubble(model, false);
+        model->active_ended_at = xTaskGetTickCount();
+    }
 
-        if(model->current_bubble) {
-            if(model->current_frame > model->current_bubble->end_frame) {
-                model->current_bubble = model->current_bubble->next_bubble;
-            }
+    if(active && model->current_bubble) {
+        if(model->current_frame > model->current_bubble->end_frame) {
+            model->current_bubble = model->current_bubble->next_bubble;
         }
     }
 }
@@ -251,10 +291,12 @@ static void bubble_animation_timer_callback(void* context) {
  * animation is always activated at unfreezing and played
  * passive frame first, and 2 frames after - active
  */
-static Icon* bubble_animation_clone_first_frame(const Icon* icon_orig) {
-    furi_assert(icon_orig);
-    furi_assert(icon_orig->frames);
-    furi_assert(icon_orig->frames[0]);
+static Icon* bubble_animation_clone_first_frame(const BubbleAnimation* animation) {
+    furi_assert(animation);
+    const Icon* icon_orig = &animation->icon_animation;
+    const uint8_t* frame = bubble_animation_get_frame_data(animation, 0);
+    /* streamed frame may fail to read, blank frame is shown then */
+    furi_assert(frame || animation->frame_stream);
 
     Icon* icon_clone = malloc(sizeof(Icon));
     memcpy(icon_clone, icon_orig, sizeof(Icon));
@@ -267,7 +309,9 @@ static Icon* bubble_animation_clone_first_frame(const Icon* icon_orig) {
      */
     size_t max_bitmap_size = ROUND_UP_TO(icon_orig->width, 8) * icon_orig->height + 1;
     FURI_CONST_ASSIGN_PTR(icon_clone->frames[0], malloc(max_bitmap_size));
-    memcpy((void*)icon_clone->frames[0], icon_orig->frames[0], max_bitmap_size);
+    if(frame) {
+        memcpy((void*)icon_clone->frames[0], frame, max_bitmap_size);
+    }
     FURI_CONST_ASSIGN(icon_clone->frame_count, 1);
 
     return icon_clone;
@@ -377,7 +421,7 @@ void bubble_animation_freeze(BubbleAnimationView* view) {
     BubbleAnimationViewModel* model = view_get_model(view->view);
     furi_assert(model->current);
     furi_assert(!model->freeze_frame);
-    model->freeze_frame = bubble_animation_clone_first_frame(&model->current->icon_animation);
+    model->freeze_frame = bubble_animation_clone_first_frame(model->current);
     model->current = NULL;
     view_commit_model(view->view, false);
     osTimerStop(view->timer);
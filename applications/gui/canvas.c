@@ -27,6 +27,8 @@ Canvas* canvas_init() {
     // Wake up display
     u8g2_SetPowerSave(&canvas->fb, 0);
 
+    canvas->sent_buffer = malloc(canvas_get_buffer_size(canvas));
+
     // Clear buffer and send to device
     canvas_clear(canvas);
     canvas_commit(canvas);
@@ -38,6 +40,10 @@ Canvas* canvas_init() {
 
 void canvas_free(Canvas* canvas) {
     furi_assert(canvas);
+    for(size_t i = 0; i < FontTotalNumber; i++) {
+        free(canvas->font_metrics[i]);
+    }
+    free(canvas->sent_buffer);
     free(canvas);
 }
 
@@ -51,9 +57,50 @@ void canvas_reset(Canvas* canvas) {
     canvas_set_font_direction(canvas, CanvasDirectionLeftToRight);
 }
 
-void canvas_commit(Canvas* canvas) {
+bool canvas_commit(Canvas* canvas) {
+    furi_assert(canvas);
+
+    u8g2_t* fb = &canvas->fb;
+    const uint8_t* buffer = u8g2_GetBufferPtr(fb);
+    const uint8_t tile_width = u8g2_GetBufferTileWidth(fb);
+    const uint8_t tile_height = u8g2_GetBufferTileHeight(fb);
+    const size_t page_size = tile_width * 8;
+    bool changed = false;
+
+    // Buffer is a row of pages, 8 pixel rows high, each page is a row of 8x8 tiles.
+    // Send only tiles from first to last changed one in every page.
+    for(uint8_t page = 0; page < tile_height; page++) {
+        const uint8_t* current = &buffer[page * page_size];
+        const uint8_t* sent = &canvas->sent_buffer[page * page_size];
+        uint8_t first = 0;
+        uint8_t last = tile_width;
+
+        if(canvas->sent_buffer_valid) {
+            if(memcmp(current, sent, page_size) == 0) continue;
+            while(memcmp(&current[first * 8], &sent[first * 8], 8) == 0) {
+                first++;
+            }
+            while(memcmp(&current[(last - 1) * 8], &sent[(last - 1) * 8], 8) == 0) {
+                last--;
+            }
+        }
+
+        u8g2_UpdateDisplayArea(fb, first, page, last - first, 1);
+        changed = true;
+    }
+
+    if(changed) {
+        u8x8_RefreshDisplay(u8g2_GetU8x8(fb));
+        memcpy(canvas->sent_buffer, buffer, page_size * tile_height);
+        canvas->sent_buffer_valid = true;
+    }
+
+    return changed;
+}
+
+void canvas_invalidate(Canvas* canvas) {
     furi_assert(canvas);
-    u8g2_SendBuffer(&canvas->fb);
+    canvas->sent_buffer_valid = false;
 }
 
 uint8_t* canvas_get_buffer(Canvas* canvas) {
@@ -125,6 +172,20 @@ void canvas_invert_color(Canvas* canvas) {
     canvas->fb.draw_color = !canvas->fb.draw_color;
 }
 
+static void
+    canvas_read_glyph_metrics(Canvas* canvas, uint16_t encoding, CanvasGlyphMetrics* metrics) {
+    metrics->exists = u8g2_IsGlyph(&canvas->fb, encoding);
+    if(metrics->exists) {
+        metrics->dx = u8g2_GetGlyphWidth(&canvas->fb, encoding);
+        metrics->x_offset = canvas->fb.glyph_x_offset;
+        metrics->width = canvas->fb.font_decode.glyph_width;
+    } else {
+        metrics->dx = 0;
+        metrics->x_offset = 0;
+        metrics->width = 0;
+    }
+}
+
 void canvas_set_font(Canvas* canvas, Font font) {
     furi_assert(canvas);
     u8g2_SetFontMode(&canvas->fb, 1);
@@ -139,6 +200,27 @@ void canvas_set_font(Canvas* canvas, Font font) {
     } else {
         furi_crash(NULL);
     }
+
+    // Glyph lookup in u8g2 font is a linear search, do it once per glyph
+    if(!canvas->font_metrics[font]) {
+        CanvasGlyphMetrics* metrics =
+            malloc(sizeof(CanvasGlyphMetrics) * CANVAS_GLYPH_METRICS_COUNT);
+        for(uint16_t i = 0; i < CANVAS_GLYPH_METRICS_COUNT; i++) {
+            canvas_read_glyph_metrics(canvas, i, &metrics[i]);
+        }
+        canvas->font_metrics[font] = metrics;
+    }
+    canvas->metrics = canvas->font_metrics[font];
+}
+
+static inline void
+    canvas_get_glyph_metrics(Canvas* canvas, char symbol, CanvasGlyphMetrics* metrics) {
+    uint8_t encoding = symbol;
+    if(canvas->metrics && encoding < CANVAS_GLYPH_METRICS_COUNT) {
+        *metrics = canvas->metrics[encoding];
+    } else {
+        canvas_read_glyph_metrics(canvas, encoding, metrics);
+    }
 }
 
 void canvas_draw_str(Canvas* canvas, uint8_t x, uint8_t y, const char* str) {
@@ -165,10 +247,10 @@ void canvas_draw_str_aligned(
     case AlignLeft:
         break;
     case AlignRight:
-        x -= u8g2_GetStrWidth(&canvas->fb, str);
+        x -= canvas_string_width(canvas, str);
         break;
     case AlignCenter:
-        x -= (u8g2_GetStrWidth(&canvas->fb, str) / 2);
+        x -= (canvas_string_width(canvas, str) / 2);
         break;
     default:
         furi_crash(NULL);
@@ -192,15 +274,72 @@ void canvas_draw_str_aligned(
     u8g2_DrawStr(&canvas->fb, x, y, str);
 }
 
+/* Same measure as u8g2_GetStrWidth: glyph advances, but bitmap width of the last glyph.
+ * Measures up to length characters, stops at the end of line. If width is not NULL,
+ * stops before the first character which makes string wider than it.
+ * Returns number of measured characters */
+static size_t canvas_string_measure(
+    Canvas* canvas,
+    const char* str,
+    size_t length,
+    uint16_t* width,
+    uint16_t* result) {
+    CanvasGlyphMetrics metrics;
+    int32_t advance = 0;
+    int32_t string_width = 0;
+    uint8_t last_width = 0;
+    int8_t last_x_offset = 0;
+    size_t i = 0;
+
+    for(; i < length && str[i] && str[i] != '\n'; i++) {
+        canvas_get_glyph_metrics(canvas, str[i], &metrics);
+        if(metrics.exists) {
+            last_width = metrics.width;
+            last_x_offset = metrics.x_offset;
+        }
+
+        int32_t prefix_width = advance + metrics.dx;
+        if(last_width) {
+            prefix_width = advance + last_width + last_x_offset;
+        }
+        if(width && prefix_width > *width) break;
+
+        advance += metrics.dx;
+        string_width = prefix_width;
+    }
+
+    *result = string_width;
+    return i;
+}
+
 uint16_t canvas_string_width(Canvas* canvas, const char* str) {
     furi_assert(canvas);
     if(!str) return 0;
-    return u8g2_GetStrWidth(&canvas->fb, str);
+    uint16_t width;
+    canvas_string_measure(canvas, str, SIZE_MAX, NULL, &width);
+    return width;
+}
+
+uint16_t canvas_string_prefix_width(Canvas* canvas, const char* str, size_t length) {
+    furi_assert(canvas);
+    if(!str) return 0;
+    uint16_t width;
+    canvas_string_measure(canvas, str, length, NULL, &width);
+    return width;
+}
+
+size_t canvas_string_fit_length(Canvas* canvas, const char* str, uint16_t width) {
+    furi_assert(canvas);
+    if(!str) return 0;
+    uint16_t fit_width;
+    return canvas_string_measure(canvas, str, SIZE_MAX, &width, &fit_width);
 }
 
 uint8_t canvas_glyph_width(Canvas* canvas, char symbol) {
     furi_assert(canvas);
-    return u8g2_GetGlyphWidth(&canvas->fb, symbol);
+    CanvasGlyphMetrics metrics;
+    canvas_get_glyph_metrics(canvas, symbol, &metrics);
+    return metrics.dx;
 }
 
 void canvas_draw_bitmap(
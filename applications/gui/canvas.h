@@ -6,6 +6,7 @@
 #pragma once
 
 #include <stdint.h>
+#include <stddef.h>
 #include <gui/icon_animation.h>
 #include <assets_icons.h>
 
@@ -169,6 +170,29 @@ void canvas_draw_str_aligned(
  */
 uint16_t canvas_string_width(Canvas* canvas, const char* str);
 
+/** Get width of string beginning
+ *
+ * @param      canvas  Canvas instance
+ * @param      str     C-string
+ * @param      length  number of characters to measure
+ *
+ * @return     width in pixels, same as canvas_string_width of string cut to
+ *             length
+ */
+uint16_t canvas_string_prefix_width(Canvas* canvas, const char* str, size_t length);
+
+/** Get length of the longest string beginning which fits into width
+ *
+ * Measurement stops at the end of line, as in canvas_string_width.
+ *
+ * @param      canvas  Canvas instance
+ * @param      str     C-string
+ * @param      width   available width in pixels
+ *
+ * @return     number of characters
+ */
+size_t canvas_string_fit_length(Canvas* canvas, const char* str, uint16_t width);
+
 /** Get glyph width
  *
  * @param      canvas  Canvas instance
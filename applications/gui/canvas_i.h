@@ -8,6 +8,18 @@
 #include "canvas.h"
 #include <u8g2.h>
 
+/** Number of glyphs with cached metrics, all fonts are ASCII-only */
+#define CANVAS_GLYPH_METRICS_COUNT 128
+
+/** Horizontal glyph metrics, as reported by u8g2
+ */
+typedef struct {
+    int8_t dx; /**< distance to next glyph */
+    int8_t x_offset; /**< bitmap offset from glyph origin */
+    uint8_t width; /**< bitmap width */
+    bool exists; /**< glyph is present in font */
+} CanvasGlyphMetrics;
+
 /** Canvas structure
  */
 struct Canvas {
@@ -17,6 +29,13 @@ struct Canvas {
     uint8_t offset_y;
     uint8_t width;
     uint8_t height;
+    /** Per-font glyph metrics, built on first canvas_set_font */
+    CanvasGlyphMetrics* font_metrics[FontTotalNumber];
+    /** Metrics of current font */
+    CanvasGlyphMetrics* metrics;
+    /** Copy of buffer sent to display, only changed tiles are sent next time */
+    uint8_t* sent_buffer;
+    bool sent_buffer_valid;
 };
 
 /** Allocate memory and initialize canvas
@@ -37,11 +56,19 @@ void canvas_free(Canvas* canvas);
  */
 void canvas_reset(Canvas* canvas);
 
-/** Commit canvas. Send buffer to display
+/** Commit canvas. Send changed part of buffer to display
+ *
+ * @param      canvas  Canvas instance
+ *
+ * @return     true if buffer differs from previously committed one
+ */
+bool canvas_commit(Canvas* canvas);
+
+/** Forget previously committed buffer, next commit sends whole buffer
  *
  * @param      canvas  Canvas instance
  */
-void canvas_commit(Canvas* canvas);
+void canvas_invalidate(Canvas* canvas);
 
 /** Get canvas buffer.
  *
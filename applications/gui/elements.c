@@ -189,12 +189,9 @@ static size_t
         end = text + strlen(text);
     }
     size_t text_size = end - text;
-    string_t str;
-    string_init_set_str(str, text);
-    string_left(str, text_size);
     size_t result = 0;
 
-    uint16_t len_px = canvas_string_width(canvas, string_get_cstr(str));
+    uint16_t len_px = canvas_string_prefix_width(canvas, text, text_size);
     uint8_t px_left = 0;
     if(horizontal == AlignCenter) {
         if(x > (canvas_width(canvas) / 2)) {
@@ -224,7 +221,6 @@ static size_t
         result = text_size;
     }
 
-    string_clear(str);
     return result;
 }
 
@@ -540,10 +536,7 @@ void elements_string_fit_width(Canvas* canvas, string_t string, uint8_t width) {
     uint16_t len_px = canvas_string_width(canvas, string_get_cstr(string));
     if(len_px > width) {
         width -= canvas_string_width(canvas, "...");
-        do {
-            string_left(string, string_size(string) - 1);
-            len_px = canvas_string_width(canvas, string_get_cstr(string));
-        } while(len_px > width);
+        string_left(string, canvas_string_fit_length(canvas, string_get_cstr(string), width));
         string_cat(string, "...");
     }
 }
@@ -210,12 +210,16 @@ void gui_redraw(Gui* gui) {
         }
     }
 
-    canvas_commit(gui->canvas);
-    for
-        M_EACH(p, gui->canvas_callback_pair, CanvasCallbackPairArray_t) {
-            p->callback(
-                canvas_get_buffer(gui->canvas), canvas_get_buffer_size(gui->canvas), p->context);
-        }
+    // Unchanged frame is neither sent to display nor to framebuffer subscribers
+    if(canvas_commit(gui->canvas)) {
+        for
+            M_EACH(p, gui->canvas_callback_pair, CanvasCallbackPairArray_t) {
+                p->callback(
+                    canvas_get_buffer(gui->canvas),
+                    canvas_get_buffer_size(gui->canvas),
+                    p->context);
+            }
+    }
     gui_unlock(gui);
 }
 
@@ -410,6 +414,8 @@ void gui_add_framebuffer_callback(Gui* gui, GuiCanvasCommitCallback callback, vo
     gui_lock(gui);
     furi_assert(CanvasCallbackPairArray_count(gui->canvas_callback_pair, p) == 0);
     CanvasCallbackPairArray_push_back(gui->canvas_callback_pair, p);
+    // New subscriber gets current frame, even if it doesn't change
+    canvas_invalidate(gui->canvas);
     gui_unlock(gui);
 
     // Request redraw
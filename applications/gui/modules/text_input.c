@@ -159,23 +159,25 @@ static void text_input_view_draw_callback(Canvas* canvas, void* _model) {
     canvas_draw_str(canvas, 2, 8, model->header);
     elements_slightly_rounded_frame(canvas, 1, 12, 126, 15);
 
-    if(canvas_string_width(canvas, text) > needed_string_width) {
+    uint16_t text_width = canvas_string_width(canvas, text);
+    if(text_width > needed_string_width) {
         canvas_draw_str(canvas, start_pos, 22, "...");
         start_pos += 6;
         needed_string_width -= 8;
     }
 
-    while(text != 0 && canvas_string_width(canvas, text) > needed_string_width) {
+    // Dropping first symbol doesn't change last one, so only its advance is gone
+    while(text[0] && text_width > needed_string_width) {
+        text_width -= canvas_glyph_width(canvas, text[0]);
         text++;
     }
 
     if(model->clear_default_text) {
-        elements_slightly_rounded_box(
-            canvas, start_pos - 1, 14, canvas_string_width(canvas, text) + 2, 10);
+        elements_slightly_rounded_box(canvas, start_pos - 1, 14, text_width + 2, 10);
         canvas_set_color(canvas, ColorWhite);
     } else {
-        canvas_draw_str(canvas, start_pos + canvas_string_width(canvas, text) + 1, 22, "|");
-        canvas_draw_str(canvas, start_pos + canvas_string_width(canvas, text) + 2, 22, "|");
+        canvas_draw_str(canvas, start_pos + text_width + 1, 22, "|");
+        canvas_draw_str(canvas, start_pos + text_width + 2, 22, "|");
     }
     canvas_draw_str(canvas, start_pos, 22, text);
 
@@ -0,0 +1,221 @@
+#include "infrared_index.h"
+#include <furi.h>
+#include <string.h>
+
+#define TAG "InfraredIndex"
+
+#pragma pack(push, 1)
+
+/** Parsed signal, preceded by protocol name length (uint8_t) and protocol name */
+typedef struct {
+    uint32_t address;
+    uint32_t command;
+} InfraredIndexMessage;
+
+/** Raw signal, followed by timings (uint32_t) */
+typedef struct {
+    uint32_t frequency;
+    float duty_cycle;
+    uint32_t timings_cnt;
+} InfraredIndexRaw;
+
+#pragma pack(pop)
+
+/** Smallest signal: type, empty protocol name and message */
+#define INFRARED_INDEX_SIGNAL_SIZE_MIN \
+    (sizeof(uint8_t) + sizeof(uint8_t) + sizeof(InfraredIndexMessage))
+
+static bool infrared_index_write(File* file, const void* data, size_t size) {
+    return storage_file_write(file, data, size) == size;
+}
+
+static bool infrared_index_read(File* file, void* data, size_t size) {
+    return storage_file_read(file, data, size) == size;
+}
+
+bool infrared_index_write_header(File* file, const InfraredIndexHeader* header) {
+    furi_assert(file);
+    furi_assert(header);
+
+    return storage_file_seek(file, 0, true) &&
+           infrared_index_write(file, header, sizeof(InfraredIndexHeader));
+}
+
+bool infrared_index_read_header(File* file, InfraredIndexHeader* header) {
+    furi_assert(file);
+    furi_assert(header);
+
+    bool result = false;
+
+    do {
+        if(!storage_file_seek(file, 0, true)) break;
+        if(!infrared_index_read(file, header, sizeof(InfraredIndexHeader))) break;
+        if((header->magic != INFRARED_INDEX_MAGIC) ||
+           (header->version != INFRARED_INDEX_VERSION)) {
+            break;
+        }
+        if((header->table_offset < sizeof(InfraredIndexHeader)) ||
+           (header->table_offset > storage_file_size(file))) {
+            FURI_LOG_E(TAG, "Table offset is out of range: %lu", header->table_offset);
+            break;
+        }
+        result = true;
+    } while(0);
+
+    return result;
+}
+
+bool infrared_index_write_signal(File* file, const InfraredIndexSignal* signal) {
+    furi_assert(file);
+    furi_assert(signal);
+
+    bool result = false;
+    uint8_t is_raw = signal->is_raw;
+
+    do {
+        if(!infrared_index_write(file, &is_raw, sizeof(is_raw))) break;
+        if(is_raw) {
+            furi_assert(signal->timings_cnt <= MAX_TIMINGS_AMOUNT);
+            InfraredIndexRaw raw = {
+                .frequency = signal->frequency,
+                .duty_cycle = signal->duty_cycle,
+                .timings_cnt = signal->timings_cnt,
+            };
+            if(!infrared_index_write(file, &raw, sizeof(raw))) break;
+            if(!infrared_index_write(
+                   file, signal->timings, sizeof(uint32_t) * signal->timings_cnt))
+                break;
+        } else {
+            /* Protocol is saved by name, enum may change with firmware update */
+            const char* protocol_name = infrared_get_protocol_name(signal->message.protocol);
+            uint8_t protocol_name_len = strlen(protocol_name);
+            InfraredIndexMessage message = {
+                .address = signal->message.address,
+                .command = signal->message.command,
+            };
+            if(!infrared_index_write(file, &protocol_name_len, sizeof(protocol_name_len))) break;
+            if(!infrared_index_write(file, protocol_name, protocol_name_len)) break;
+            if(!infrared_index_write(file, &message, sizeof(message))) break;
+        }
+        result = true;
+    } while(0);
+
+    return result;
+}
+
+bool infrared_index_read_signal(File* file, InfraredIndexSignal* signal) {
+    furi_assert(file);
+    furi_assert(signal);
+
+    bool result = false;
+    uint8_t is_raw = 0;
+
+    do {
+        if(!infrared_index_read(file, &is_raw, sizeof(is_raw))) break;
+        signal->is_raw = is_raw;
+        if(is_raw) {
+            furi_assert(signal->timings);
+            InfraredIndexRaw raw;
+            if(!infrared_index_read(file, &raw, sizeof(raw))) break;
+            if(!raw.timings_cnt || (raw.timings_cnt > MAX_TIMINGS_AMOUNT)) break;
+            if(!infrared_index_read(file, signal->timings, sizeof(uint32_t) * raw.timings_cnt))
+                break;
+            signal->frequency = raw.frequency;
+            signal->duty_cycle = raw.duty_cycle;
+            signal->timings_cnt = raw.timings_cnt;
+        } else {
+            char protocol_name[INFRARED_INDEX_NAME_SIZE];
+            uint8_t protocol_name_len = 0;
+            InfraredIndexMessage message;
+            if(!infrared_index_read(file, &protocol_name_len, sizeof(protocol_name_len))) break;
+            if(!infrared_index_read(file, protocol_name, protocol_name_len)) break;
+            protocol_name[protocol_name_len] = '\0';
+            if(!infrared_index_read(file, &message, sizeof(message))) break;
+
+            signal->message.protocol = infrared_get_protocol_by_name(protocol_name);
+            signal->message.address = message.address;
+            signal->message.command = message.command;
+            signal->message.repeat = false;
+            if(!infrared_is_protocol_valid(signal->message.protocol)) break;
+        }
+        result = true;
+    } while(0);
+
+    return result;
+}
+
+bool infrared_index_write_record(
+    File* file,
+    const char* name,
+    const uint32_t* offsets,
+    uint32_t count) {
+    furi_assert(file);
+    furi_assert(name);
+
+    uint8_t name_len = MIN(strlen(name), (size_t)UINT8_MAX);
+
+    return infrared_index_write(file, &name_len, sizeof(name_len)) &&
+           infrared_index_write(file, name, name_len) &&
+           infrared_index_write(file, &count, sizeof(count)) &&
+           infrared_index_write(file, offsets, sizeof(uint32_t) * count);
+}
+
+bool infrared_index_read_record(
+    File* file,
+    const InfraredIndexHeader* header,
+    char* name,
+    uint32_t* count) {
+    furi_assert(file);
+    furi_assert(header);
+    furi_assert(name);
+    furi_assert(count);
+
+    bool result = false;
+    uint8_t name_len = 0;
+
+    do {
+        if(!infrared_index_read(file, &name_len, sizeof(name_len))) break;
+        if(!infrared_index_read(file, name, name_len)) break;
+        name[name_len] = '\0';
+        if(!infrared_index_read(file, count, sizeof(uint32_t))) break;
+
+        uint64_t position = storage_file_tell(file);
+        uint64_t size = storage_file_size(file);
+        uint32_t signals_max =
+            (header->table_offset - sizeof(InfraredIndexHeader)) / INFRARED_INDEX_SIGNAL_SIZE_MIN;
+        if((position < header->table_offset) || (*count > signals_max) ||
+           ((uint64_t)*count * sizeof(uint32_t) > size - position)) {
+            FURI_LOG_E(TAG, "Signals count is out of range: %lu", *count);
+            break;
+        }
+        result = true;
+    } while(0);
+
+    return result;
+}
+
+bool infrared_index_read_record_offsets(
+    File* file,
+    const InfraredIndexHeader* header,
+    uint32_t* offsets,
+    uint32_t count) {
+    furi_assert(file);
+    furi_assert(header);
+
+    bool result = infrared_index_read(file, offsets, sizeof(uint32_t) * count);
+
+    for(uint32_t i = 0; result && (i < count); ++i) {
+        if((offsets[i] < sizeof(InfraredIndexHeader)) || (offsets[i] >= header->table_offset)) {
+            FURI_LOG_E(TAG, "Signal offset is out of range: %lu", offsets[i]);
+            result = false;
+        }
+    }
+
+    return result;
+}
+
+bool infrared_index_skip_record_offsets(File* file, uint32_t count) {
+    furi_assert(file);
+
+    return storage_file_seek(file, storage_file_tell(file) + sizeof(uint32_t) * count, true);
+}
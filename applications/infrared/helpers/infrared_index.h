@@ -0,0 +1,141 @@
+/**
+  * @file infrared_index.h
+  * Infrared: Binary index of universal database.
+  *     Signals are stored already parsed, followed by table of
+  *     signal offsets for every record name.
+  */
+#pragma once
+
+#include <infrared.h>
+#include <infrared_worker.h>
+#include <storage/storage.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define INFRARED_INDEX_MAGIC 0x58444949 /* "IIDX" */
+#define INFRARED_INDEX_VERSION 1
+/** Buffer size for record name, including terminator */
+#define INFRARED_INDEX_NAME_SIZE (UINT8_MAX + 1)
+
+#pragma pack(push, 1)
+
+/** Index file header, followed by signals, then by table of records:
+ * name length (uint8_t), name, signals count (uint32_t), signal offsets (uint32_t) */
+typedef struct {
+    uint32_t magic;
+    uint8_t version;
+    uint32_t db_size;
+    uint32_t db_crc;
+    uint32_t table_offset;
+    uint32_t record_count;
+} InfraredIndexHeader;
+
+#pragma pack(pop)
+
+/** Signal stored in index */
+typedef struct {
+    bool is_raw;
+    /** Parsed signal */
+    InfraredMessage message;
+    /** Raw signal, on read timings must have room for MAX_TIMINGS_AMOUNT values */
+    uint32_t frequency;
+    float duty_cycle;
+    uint32_t timings_cnt;
+    uint32_t* timings;
+} InfraredIndexSignal;
+
+/** Write header at the beginning of index file
+ *
+ * @param file - index file
+ * @param header - header to write
+ * @retval true on success
+ */
+bool infrared_index_write_header(File* file, const InfraredIndexHeader* header);
+
+/** Read and validate header at the beginning of index file
+ *
+ * Fails if magic or version doesn't match, or table is out of file bounds.
+ *
+ * @param file - index file
+ * @param header - header to read to
+ * @retval true on success
+ */
+bool infrared_index_read_header(File* file, InfraredIndexHeader* header);
+
+/** Write signal at current position
+ *
+ * @param file - index file
+ * @param signal - signal to write
+ * @retval true on success
+ */
+bool infrared_index_write_signal(File* file, const InfraredIndexSignal* signal);
+
+/** Read signal at current position
+ *
+ * @param file - index file
+ * @param signal - signal to read to, with timings buffer for raw signal
+ * @retval true on success
+ */
+bool infrared_index_read_signal(File* file, InfraredIndexSignal* signal);
+
+/** Write table record at current position
+ *
+ * @param file - index file
+ * @param name - record name, truncated to UINT8_MAX characters
+ * @param offsets - offsets of record signals
+ * @param count - number of offsets
+ * @retval true on success
+ */
+bool infrared_index_write_record(
+    File* file,
+    const char* name,
+    const uint32_t* offsets,
+    uint32_t count);
+
+/** Read table record name and signals count at current position
+ *
+ * Fails if count doesn't fit in the file or exceeds number of signals that
+ * can be stored before table. Must be followed by
+ * infrared_index_read_record_offsets or infrared_index_skip_record_offsets.
+ *
+ * @param file - index file
+ * @param header - validated index header
+ * @param name - buffer of INFRARED_INDEX_NAME_SIZE for record name
+ * @param count - signals count
+ * @retval true on success
+ */
+bool infrared_index_read_record(
+    File* file,
+    const InfraredIndexHeader* header,
+    char* name,
+    uint32_t* count);
+
+/** Read and validate signal offsets of table record
+ *
+ * @param file - index file
+ * @param header - validated index header
+ * @param offsets - buffer for count offsets
+ * @param count - count returned by infrared_index_read_record
+ * @retval true on success, all offsets point before table
+ */
+bool infrared_index_read_record_offsets(
+    File* file,
+    const InfraredIndexHeader* header,
+    uint32_t* offsets,
+    uint32_t count);
+
+/** Skip signal offsets of table record
+ *
+ * @param file - index file
+ * @param count - count returned by infrared_index_read_record
+ * @retval true on success
+ */
+bool infrared_index_skip_record_offsets(File* file, uint32_t count);
+
+#ifdef __cplusplus
+}
+#endif
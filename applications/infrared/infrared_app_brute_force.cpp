@@ -1,26 +1,193 @@
-
 #include "helpers/infrared_parser.h"
+#include "helpers/infrared_index.h"
 #include "infrared_app_brute_force.h"
 #include "infrared_app_signal.h"
 #include <memory>
 #include <m-string.h>
 #include <furi.h>
+#include <toolbox/crc32_calc.h>
+
+#define TAG "InfraredBruteForce"
+
+#define INFRARED_BRUTE_FORCE_CRC_BLOCK 512
+
+static bool infrared_brute_force_write_signal(File* file, const InfraredAppSignal& signal) {
+    InfraredIndexSignal index_signal = {};
+
+    index_signal.is_raw = signal.is_raw();
+    if(index_signal.is_raw) {
+        auto& raw_signal = signal.get_raw_signal();
+        index_signal.frequency = raw_signal.frequency;
+        index_signal.duty_cycle = raw_signal.duty_cycle;
+        index_signal.timings_cnt = raw_signal.timings_cnt;
+        index_signal.timings = raw_signal.timings;
+    } else {
+        index_signal.message = signal.get_message();
+    }
+
+    return infrared_index_write_signal(file, &index_signal);
+}
+
+static bool infrared_brute_force_read_signal(File* file, InfraredAppSignal& signal) {
+    InfraredIndexSignal index_signal = {};
+    index_signal.timings = (uint32_t*)malloc(sizeof(uint32_t) * MAX_TIMINGS_AMOUNT);
+
+    bool result = infrared_index_read_signal(file, &index_signal);
+    if(result && index_signal.is_raw) {
+        signal.set_raw_signal(
+            index_signal.timings,
+            index_signal.timings_cnt,
+            index_signal.frequency,
+            index_signal.duty_cycle);
+    } else if(result) {
+        result = infrared_parser_is_parsed_signal_valid(&index_signal.message);
+        if(result) {
+            signal.set_message(&index_signal.message);
+        }
+    }
+
+    free(index_signal.timings);
+    return result;
+}
 
 void InfraredAppBruteForce::add_record(int index, const char* name) {
     records[name].index = index;
     records[name].amount = 0;
+    records[name].offsets.clear();
 }
 
-bool InfraredAppBruteForce::calculate_messages() {
+bool InfraredAppBruteForce::calculate_db_crc(Storage* storage, uint32_t& crc) {
+    File* file = storage_file_alloc(storage);
+    bool result = storage_file_open(file, universal_db_filename, FSAM_READ, FSOM_OPEN_EXISTING);
+
+    if(result) {
+        uint8_t* buffer = (uint8_t*)malloc(INFRARED_BRUTE_FORCE_CRC_BLOCK);
+        uint16_t bytes_read = 0;
+        crc = 0;
+
+        /* Software CRC, hardware one would be held during whole SD card read */
+        do {
+            bytes_read = storage_file_read(file, buffer, INFRARED_BRUTE_FORCE_CRC_BLOCK);
+            crc = crc32_calc_buffer(crc, buffer, bytes_read);
+        } while(bytes_read == INFRARED_BRUTE_FORCE_CRC_BLOCK);
+
+        result = storage_file_get_error(file) == FSE_OK;
+        free(buffer);
+    }
+
+    storage_file_free(file);
+    return result;
+}
+
+bool InfraredAppBruteForce::load_index(Storage* storage, uint32_t db_size, uint32_t db_crc) {
+    File* file = storage_file_alloc(storage);
+    InfraredIndexHeader header;
     bool result = false;
 
-    Storage* storage = static_cast<Storage*>(furi_record_open("storage"));
-    FlipperFormat* ff = flipper_format_file_alloc(storage);
-    result = flipper_format_file_open_existing(ff, universal_db_filename);
+    do {
+        if(!storage_file_open(file, index_filename.c_str(), FSAM_READ, FSOM_OPEN_EXISTING)) break;
+        if(!infrared_index_read_header(file, &header)) break;
+        if((header.db_size != db_size) || (header.db_crc != db_crc)) {
+            FURI_LOG_I(TAG, "Index is outdated");
+            break;
+        }
+        if(!storage_file_seek(file, header.table_offset, true)) break;
+
+        uint32_t i = 0;
+        for(; i < header.record_count; ++i) {
+            char name[INFRARED_INDEX_NAME_SIZE];
+            uint32_t count = 0;
+            if(!infrared_index_read_record(file, &header, name, &count)) break;
+
+            auto element = records.find(name);
+            if(element != records.end()) {
+                auto& offsets = element->second.offsets;
+                offsets.resize(count);
+                if(!infrared_index_read_record_offsets(file, &header, offsets.data(), count))
+                    break;
+            } else if(!infrared_index_skip_record_offsets(file, count)) {
+                break;
+            }
+        }
+        result = (i == header.record_count);
+    } while(0);
+
+    if(!result) {
+        for(auto& it : records) {
+            it.second.offsets.clear();
+        }
+    }
+
+    storage_file_free(file);
+    return result;
+}
+
+bool InfraredAppBruteForce::build_index(Storage* storage, uint32_t db_size, uint32_t db_crc) {
+    FlipperFormat* ff = flipper_format_buffered_file_alloc(storage);
+    File* file = storage_file_alloc(storage);
+    std::unordered_map<std::string, std::vector<uint32_t>> table;
+    InfraredIndexHeader header = {
+        .magic = 0,
+        .version = INFRARED_INDEX_VERSION,
+        .db_size = db_size,
+        .db_crc = db_crc,
+        .table_offset = 0,
+        .record_count = 0,
+    };
+    bool result = false;
+
+    FURI_LOG_I(TAG, "Building index %s", index_filename.c_str());
+    do {
+        if(!flipper_format_buffered_file_open_existing(ff, universal_db_filename)) break;
+        if(!storage_file_open(file, index_filename.c_str(), FSAM_WRITE, FSOM_CREATE_ALWAYS))
+            break;
+        /* Header without magic is written first, so incomplete index is never valid */
+        if(!infrared_index_write_header(file, &header)) break;
 
-    if(result) {
         InfraredAppSignal signal;
+        std::string signal_name;
+        bool write_failed = false;
+        while(infrared_parser_read_signal(ff, signal, signal_name)) {
+            table[signal_name].push_back(storage_file_tell(file));
+            if(!infrared_brute_force_write_signal(file, signal)) {
+                write_failed = true;
+                break;
+            }
+        }
+        if(write_failed) break;
 
+        header.table_offset = storage_file_tell(file);
+        header.record_count = table.size();
+        for(const auto& it : table) {
+            if(!infrared_index_write_record(
+                   file, it.first.c_str(), it.second.data(), it.second.size()))
+                break;
+            --header.record_count;
+        }
+        if(header.record_count) break;
+
+        header.record_count = table.size();
+        header.magic = INFRARED_INDEX_MAGIC;
+        if(!infrared_index_write_header(file, &header)) break;
+        result = true;
+    } while(0);
+
+    storage_file_free(file);
+    flipper_format_free(ff);
+
+    if(!result) {
+        FURI_LOG_E(TAG, "Failed to build index");
+        storage_common_remove(storage, index_filename.c_str());
+    }
+
+    return result;
+}
+
+bool InfraredAppBruteForce::count_records(Storage* storage) {
+    FlipperFormat* ff = flipper_format_buffered_file_alloc(storage);
+    bool result = flipper_format_buffered_file_open_existing(ff, universal_db_filename);
+
+    if(result) {
         string_t signal_name;
         string_init(signal_name);
         while(flipper_format_read_string(ff, "name", signal_name)) {
@@ -33,6 +200,37 @@ bool InfraredAppBruteForce::calculate_messages() {
     }
 
     flipper_format_free(ff);
+    return result;
+}
+
+bool InfraredAppBruteForce::calculate_messages() {
+    bool result = false;
+
+    Storage* storage = static_cast<Storage*>(furi_record_open("storage"));
+    FileInfo db_info;
+    uint32_t db_crc = 0;
+
+    indexed = false;
+    if((storage_common_stat(storage, universal_db_filename, &db_info) == FSE_OK) &&
+       calculate_db_crc(storage, db_crc)) {
+        indexed = load_index(storage, db_info.size, db_crc);
+        if(!indexed) {
+            indexed = build_index(storage, db_info.size, db_crc) &&
+                      load_index(storage, db_info.size, db_crc);
+        }
+    }
+
+    if(indexed) {
+        for(auto& it : records) {
+            it.second.amount = it.second.offsets.size();
+        }
+        result = true;
+    } else {
+        /* SD card may be read-only or full, brute force still works without index */
+        FURI_LOG_W(TAG, "Index is not available, database will be parsed");
+        result = count_records(storage);
+    }
+
     furi_record_close("storage");
     return result;
 }
@@ -41,23 +239,40 @@ void InfraredAppBruteForce::stop_bruteforce() {
     furi_assert((current_record.size()));
 
     if(current_record.size()) {
-        furi_assert(ff);
+        furi_assert(index_file || ff);
         current_record.clear();
-        flipper_format_free(ff);
+        if(index_file) {
+            storage_file_free(index_file);
+            index_file = nullptr;
+        }
+        if(ff) {
+            flipper_format_free(ff);
+            ff = nullptr;
+        }
         furi_record_close("storage");
     }
 }
 
 bool InfraredAppBruteForce::send_next_bruteforce(void) {
     furi_assert(current_record.size());
-    furi_assert(ff);
+    furi_assert(index_file || ff);
 
     InfraredAppSignal signal;
-    std::string signal_name;
     bool result = false;
-    do {
-        result = infrared_parser_read_signal(ff, signal, signal_name);
-    } while(result && current_record.compare(signal_name));
+
+    if(index_file) {
+        const auto& offsets = records[current_record].offsets;
+        if(current_signal < offsets.size()) {
+            result = storage_file_seek(index_file, offsets[current_signal], true) &&
+                     infrared_brute_force_read_signal(index_file, signal);
+            ++current_signal;
+        }
+    } else {
+        std::string signal_name;
+        do {
+            result = infrared_parser_read_signal(ff, signal, signal_name);
+        } while(result && current_record.compare(signal_name));
+    }
 
     if(result) {
         signal.transmit();
@@ -81,10 +296,24 @@ bool InfraredAppBruteForce::start_bruteforce(int index, int& record_amount) {
 
     if(record_amount) {
         Storage* storage = static_cast<Storage*>(furi_record_open("storage"));
-        ff = flipper_format_file_alloc(storage);
-        result = flipper_format_file_open_existing(ff, universal_db_filename);
+        if(indexed) {
+            index_file = storage_file_alloc(storage);
+            current_signal = 0;
+            result = storage_file_open(
+                index_file, index_filename.c_str(), FSAM_READ, FSOM_OPEN_EXISTING);
+            if(!result) {
+                storage_file_free(index_file);
+                index_file = nullptr;
+            }
+        } else {
+            ff = flipper_format_buffered_file_alloc(storage);
+            result = flipper_format_buffered_file_open_existing(ff, universal_db_filename);
+            if(!result) {
+                flipper_format_free(ff);
+                ff = nullptr;
+            }
+        }
         if(!result) {
-            flipper_format_free(ff);
             furi_record_close("storage");
         }
     }
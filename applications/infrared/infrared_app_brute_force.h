@@ -5,29 +5,53 @@
 #pragma once
 
 #include <unordered_map>
+#include <vector>
+#include <string>
 #include <memory>
+#include <storage/storage.h>
 #include <flipper_format/flipper_format.h>
 
-/** Class handles brute force mechanic */
+/** Class handles brute force mechanic.
+ *
+ * Universal database is compiled into binary index file next to it
+ * ('universal_db_name' + ".idx"): signals of database, already parsed,
+ * and table of their offsets for every record name. Index is rebuilt
+ * when size or CRC32 of database doesn't match the ones saved in index.
+ * If index can't be built, database is parsed during brute force.
+ */
 class InfraredAppBruteForce {
     /** Universal database filename */
     const char* universal_db_filename;
 
+    /** Universal database index filename */
+    std::string index_filename;
+
     /** Current record name (POWER, MUTE, VOL+, etc).
      * This is the name of signal to brute force. */
     std::string current_record;
 
-    /** Flipper File Format instance */
+    /** Index file, open during brute force */
+    File* index_file;
+
+    /** Universal database, open during brute force without index */
     FlipperFormat* ff;
 
+    /** Index is loaded and used for brute force */
+    bool indexed;
+
+    /** Number of signals of current record sent */
+    size_t current_signal;
+
     /** Data about every record - index in button panel view
-     * and amount of signals, which is need for correct
-     * progress bar displaying. */
+     * and offsets of signals in index file. Amount of signals
+     * is need for correct progress bar displaying. */
     typedef struct {
         /** Index of record in button panel view model */
         int index;
         /** Amount of signals of that type (POWER, MUTE, etc) */
         int amount;
+        /** Offsets of signals of that type (POWER, MUTE, etc) in index file */
+        std::vector<uint32_t> offsets;
     } Record;
 
     /** Container to hold Record info.
@@ -39,6 +63,19 @@ class InfraredAppBruteForce {
      */
     std::unordered_map<std::string, Record> records;
 
+    /** Calculate CRC32 of universal database */
+    bool calculate_db_crc(Storage* storage, uint32_t& crc);
+
+    /** Read signal offsets of every record from index file.
+     * Fails if index is missing or doesn't match database. */
+    bool load_index(Storage* storage, uint32_t db_size, uint32_t db_crc);
+
+    /** Parse universal database and write its index file */
+    bool build_index(Storage* storage, uint32_t db_size, uint32_t db_crc);
+
+    /** Count signals of every record by parsing universal database */
+    bool count_records(Storage* storage);
+
 public:
     /** Calculate messages. Walk through the file ('universal_db_name')
      * and calculate amount of records of certain type. */
@@ -58,7 +95,11 @@ public:
 
     /** Initialize class, set db file */
     InfraredAppBruteForce(const char* filename)
-        : universal_db_filename(filename) {
+        : universal_db_filename(filename)
+        , index_filename(std::string(filename) + ".idx")
+        , index_file(nullptr)
+        , ff(nullptr)
+        , indexed(false) {
     }
 
     /** Deinitialize class */
@@ -26,6 +26,9 @@ typedef enum {
 
 #define RPC_ALL_EVENTS (RpcEvtNewData | RpcEvtDisconnect)
 
+/* Varint length prefix of delimited message takes at most 5 bytes */
+#define RPC_DELIMITER_SIZE_MAX (5)
+
 DICT_DEF2(RpcHandlerDict, pb_size_t, M_DEFAULT_OPLIST, RpcHandler, M_POD_OPLIST)
 
 typedef struct {
@@ -64,6 +67,10 @@ struct RpcSession {
     bool terminate;
     void** system_contexts;
     bool decode_error;
+    size_t chunk_size;
+    uint32_t features;
+    uint8_t* tx_buffer;
+    size_t tx_buffer_size;
 
     osMutexId_t callbacks_mutex;
     RpcSendBytesCallback send_bytes_callback;
@@ -418,6 +425,21 @@ size_t rpc_session_get_available_size(RpcSession* session) {
     return xStreamBufferSpacesAvailable(session->stream);
 }
 
+void rpc_session_set_features(RpcSession* session, uint32_t features) {
+    furi_assert(session);
+    session->features = features;
+}
+
+uint32_t rpc_session_get_features(RpcSession* session) {
+    furi_assert(session);
+    return session->features;
+}
+
+size_t rpc_session_get_chunk_size(RpcSession* session) {
+    furi_assert(session);
+    return session->chunk_size;
+}
+
 bool rpc_pb_stream_read(pb_istream_t* istream, pb_byte_t* buf, size_t count) {
     RpcSession* session = istream->state;
     furi_assert(session);
@@ -491,7 +513,8 @@ static int32_t rpc_session_worker(void* context) {
             .callback = rpc_pb_stream_read,
             .state = session,
             .errmsg = NULL,
-            .bytes_left = RPC_MAX_MESSAGE_SIZE, /* max incoming message size */
+            /* max incoming message size */
+            .bytes_left = session->chunk_size + RPC_MESSAGE_OVERHEAD,
         };
 
         bool message_decode_failed = false;
@@ -580,6 +603,7 @@ static void rpc_session_free_callback(FuriThreadState thread_state, void* contex
         }
         free(session->system_contexts);
         free(session->decoded_message);
+        free(session->tx_buffer);
         RpcHandlerDict_clear(session->handlers);
         vStreamBufferDelete(session->stream);
 
@@ -596,11 +620,24 @@ static void rpc_session_free_callback(FuriThreadState thread_state, void* contex
 }
 
 RpcSession* rpc_session_open(Rpc* rpc) {
+    return rpc_session_open_ex(rpc, RPC_CHUNK_SIZE_DEFAULT);
+}
+
+RpcSession* rpc_session_open_ex(Rpc* rpc, size_t chunk_size) {
     furi_assert(rpc);
 
     RpcSession* session = malloc(sizeof(RpcSession));
+    session->chunk_size = CLAMP(chunk_size, RPC_CHUNK_SIZE_MAX, RPC_CHUNK_SIZE_DEFAULT);
+    size_t stream_size = RPC_BUFFER_SIZE;
+    if(session->chunk_size > RPC_CHUNK_SIZE_DEFAULT) {
+        /* keep several chunks in flight while previous one is being processed */
+        stream_size = RPC_CHUNKS_IN_FLIGHT * (session->chunk_size + RPC_MESSAGE_OVERHEAD);
+    }
     session->callbacks_mutex = osMutexNew(NULL);
-    session->stream = xStreamBufferCreate(RPC_BUFFER_SIZE, 1);
+    session->stream = xStreamBufferCreate(stream_size, 1);
+    /* bulk transfers bring own buffer, see rpc_send_with_buffer() */
+    session->tx_buffer_size = RPC_MAX_MESSAGE_SIZE;
+    session->tx_buffer = malloc(session->tx_buffer_size);
     session->rpc = rpc;
     session->terminate = false;
     session->decode_error = false;
@@ -666,36 +703,95 @@ void rpc_add_handler(RpcSession* session, pb_size_t message_tag, RpcHandler* han
     RpcHandlerDict_set_at(session->handlers, message_tag, *handler);
 }
 
-void rpc_send(RpcSession* session, PB_Main* message) {
-    furi_assert(session);
-    furi_assert(message);
+/* Encode delimited message in a single pass: body is encoded after room
+ * reserved for the longest length prefix, prefix is put right before it. */
+static bool rpc_encode_message(
+    PB_Main* message,
+    uint8_t* buffer,
+    size_t buffer_size,
+    uint8_t** encoded,
+    size_t* encoded_size) {
+    if(buffer_size <= RPC_DELIMITER_SIZE_MAX) return false;
+
+    pb_ostream_t ostream = pb_ostream_from_buffer(
+        buffer + RPC_DELIMITER_SIZE_MAX, buffer_size - RPC_DELIMITER_SIZE_MAX);
+    if(!pb_encode(&ostream, &PB_Main_msg, message)) return false;
+
+    uint8_t prefix[RPC_DELIMITER_SIZE_MAX];
+    pb_ostream_t prefix_stream = pb_ostream_from_buffer(prefix, sizeof(prefix));
+    if(!pb_encode_varint(&prefix_stream, ostream.bytes_written)) return false;
+
+    *encoded = buffer + RPC_DELIMITER_SIZE_MAX - prefix_stream.bytes_written;
+    memcpy(*encoded, prefix, prefix_stream.bytes_written);
+    *encoded_size = prefix_stream.bytes_written + ostream.bytes_written;
+    return true;
+}
 
-    pb_ostream_t ostream = PB_OSTREAM_SIZING;
+/* Encode message into buffer and send it, called with callbacks mutex held */
+static bool rpc_send_encoded(
+    RpcSession* session,
+    PB_Main* message,
+    uint8_t* buffer,
+    size_t buffer_size) {
+    uint8_t* encoded = NULL;
+    size_t encoded_size = 0;
+    if(!rpc_encode_message(message, buffer, buffer_size, &encoded, &encoded_size)) {
+        return false;
+    }
 
 #if SRV_RPC_DEBUG
     FURI_LOG_I(TAG, "OUTPUT:");
     rpc_print_message(message);
+    rpc_print_data("OUTPUT", encoded, encoded_size);
 #endif
 
-    bool result = pb_encode_ex(&ostream, &PB_Main_msg, message, PB_ENCODE_DELIMITED);
-    furi_check(result && ostream.bytes_written);
+    if(session->send_bytes_callback) {
+        session->send_bytes_callback(session->context, encoded, encoded_size);
+    }
+    return true;
+}
 
-    uint8_t* buffer = malloc(ostream.bytes_written);
-    ostream = pb_ostream_from_buffer(buffer, ostream.bytes_written);
+void rpc_send_with_buffer(
+    RpcSession* session,
+    PB_Main* message,
+    uint8_t* buffer,
+    size_t buffer_size) {
+    furi_assert(session);
+    furi_assert(message);
+    furi_assert(buffer);
 
-    pb_encode_ex(&ostream, &PB_Main_msg, message, PB_ENCODE_DELIMITED);
+    osMutexAcquire(session->callbacks_mutex, osWaitForever);
+    bool sent = rpc_send_encoded(session, message, buffer, buffer_size);
+    osMutexRelease(session->callbacks_mutex);
 
-#if SRV_RPC_DEBUG
-    rpc_print_data("OUTPUT", buffer, ostream.bytes_written);
-#endif
+    if(!sent) {
+        FURI_LOG_W(TAG, "Message doesn't fit %u bytes buffer", buffer_size);
+        rpc_send(session, message);
+    }
+}
+
+void rpc_send(RpcSession* session, PB_Main* message) {
+    furi_assert(session);
+    furi_assert(message);
 
+    /* Transmit buffer is shared by session worker and other senders (e.g. screen streaming) */
     osMutexAcquire(session->callbacks_mutex, osWaitForever);
-    if(session->send_bytes_callback) {
-        session->send_bytes_callback(session->context, buffer, ostream.bytes_written);
+
+    if(!rpc_send_encoded(session, message, session->tx_buffer, session->tx_buffer_size)) {
+        /* Larger than anything sent before: grow buffer, it is kept for next messages */
+        pb_ostream_t ostream = PB_OSTREAM_SIZING;
+        bool result = pb_encode(&ostream, &PB_Main_msg, message);
+        furi_check(result && ostream.bytes_written);
+
+        free(session->tx_buffer);
+        session->tx_buffer_size = ostream.bytes_written + RPC_DELIMITER_SIZE_MAX;
+        session->tx_buffer = malloc(session->tx_buffer_size);
+        result =
+            rpc_send_encoded(session, message, session->tx_buffer, session->tx_buffer_size);
+        furi_check(result);
     }
-    osMutexRelease(session->callbacks_mutex);
 
-    free(buffer);
+    osMutexRelease(session->callbacks_mutex);
 }
 
 void rpc_send_and_release(RpcSession* session, PB_Main* message) {
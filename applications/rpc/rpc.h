@@ -7,6 +7,22 @@
 
 #define RPC_BUFFER_SIZE (1024)
 #define RPC_MAX_MESSAGE_SIZE (1536)
+/** Default payload size of data carrying messages (e.g. storage read/write) */
+#define RPC_CHUNK_SIZE_DEFAULT (512)
+/** Largest payload size that can be negotiated with rpc_session_open_ex() */
+#define RPC_CHUNK_SIZE_MAX (2048)
+/** Amount of max-sized incoming messages buffered without acknowledgement */
+#define RPC_CHUNKS_IN_FLIGHT (2)
+
+/** Optional protocol extensions, enabled by transport layer on client request */
+typedef enum {
+    RpcSessionFeatureScreenDelta = (1 << 0), /**< Screen frames are sent as tile deltas */
+    RpcSessionFeatureScreenCompress = (1 << 1), /**< Screen deltas are heatshrink compressed */
+} RpcSessionFeature;
+
+/** Features of sessions opened by BT service: BLE client can't pass them on session
+ * start like USB one does, and bandwidth is what screen deltas are for */
+#define RPC_SESSION_FEATURES_BT (RpcSessionFeatureScreenDelta | RpcSessionFeatureScreenCompress)
 
 /** Rpc interface. Used for opening session only. */
 typedef struct Rpc Rpc;
@@ -44,6 +60,45 @@ typedef void (*RpcSessionTerminatedCallback)(void* context);
  */
 RpcSession* rpc_session_open(Rpc* rpc);
 
+/** Open RPC session with negotiated chunk size
+ *
+ * Same as rpc_session_open(), but data carrying messages (storage read
+ * responses and write requests) can hold up to chunk_size bytes of payload,
+ * and the receive buffer keeps RPC_CHUNKS_IN_FLIGHT of such messages, so the
+ * client can stream write chunks back-to-back without waiting for the device.
+ *
+ * @param   rpc         instance
+ * @param   chunk_size  requested chunk size, clamped to
+ *                      [RPC_CHUNK_SIZE_DEFAULT, RPC_CHUNK_SIZE_MAX]
+ * @return              pointer to RpcSession descriptor, or
+ *                      NULL if RPC is busy and can't open session now
+ */
+RpcSession* rpc_session_open_ex(Rpc* rpc, size_t chunk_size);
+
+/** Enable optional protocol extensions for session
+ * Has to be called before client sends any request relying on them.
+ *
+ * @param   session     pointer to RpcSession descriptor
+ * @param   features    RpcSessionFeature bitmask
+ */
+void rpc_session_set_features(RpcSession* session, uint32_t features);
+
+/** Get optional protocol extensions enabled for session
+ *
+ * @param   session     pointer to RpcSession descriptor
+ *
+ * @return              RpcSessionFeature bitmask
+ */
+uint32_t rpc_session_get_features(RpcSession* session);
+
+/** Get chunk size negotiated for session
+ *
+ * @param   session     pointer to RpcSession descriptor
+ *
+ * @return              max payload size of data carrying messages
+ */
+size_t rpc_session_get_chunk_size(RpcSession* session);
+
 /** Close RPC session
  * It is guaranteed that no callbacks will be called
  * as soon as session is closed. So no need in setting
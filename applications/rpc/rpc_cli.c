@@ -3,6 +3,7 @@
 #include <rpc/rpc.h>
 #include <furi_hal.h>
 #include <semphr.h>
+#include <lib/toolbox/args.h>
 
 #define TAG "RpcCli"
 
@@ -43,8 +44,18 @@ void rpc_cli_command_start_session(Cli* cli, string_t args, void* context) {
     uint32_t mem_before = memmgr_get_free_heap();
     FURI_LOG_D(TAG, "Free memory %d", mem_before);
 
+    /* Optional arguments: chunk size the companion is able to handle and
+     * RpcSessionFeature bitmask of protocol extensions it supports */
+    int chunk_size = 0;
+    int features = 0;
+    if(!args_read_int_and_trim(args, &chunk_size) || (chunk_size <= 0)) {
+        chunk_size = RPC_CHUNK_SIZE_DEFAULT;
+    } else if(!args_read_int_and_trim(args, &features) || (features < 0)) {
+        features = 0;
+    }
+
     furi_hal_usb_lock();
-    RpcSession* rpc_session = rpc_session_open(rpc);
+    RpcSession* rpc_session = rpc_session_open_ex(rpc, chunk_size);
     if(rpc_session == NULL) {
         printf("Session start error\r\n");
         furi_hal_usb_unlock();
@@ -53,6 +64,7 @@ void rpc_cli_command_start_session(Cli* cli, string_t args, void* context) {
 
     CliRpc cli_rpc = {.cli = cli, .session_close_request = false};
     cli_rpc.terminate_semaphore = osSemaphoreNew(1, 0, NULL);
+    rpc_session_set_features(rpc_session, features);
     rpc_session_set_context(rpc_session, &cli_rpc);
     rpc_session_set_send_bytes_callback(rpc_session, rpc_send_bytes_callback);
     rpc_session_set_close_callback(rpc_session, rpc_session_close_callback);
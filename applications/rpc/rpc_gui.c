@@ -1,6 +1,7 @@
 #include "flipper.pb.h"
 #include "rpc_i.h"
 #include "gui.pb.h"
+#include "rpc_gui_frame.h"
 #include <gui/gui_i.h>
 
 #define TAG "RpcGui"
@@ -24,6 +25,13 @@ typedef struct {
     PB_Main* transmit_frame;
     FuriThread* transmit_thread;
 
+    // Delta transmit
+    osMutexId_t frame_mutex;
+    uint8_t* frame; // latest framebuffer, written by GUI thread
+    uint8_t* current_frame;
+    size_t framebuffer_size;
+    RpcGuiFrameEncoder* encoder;
+
     bool virtual_display_not_empty;
     bool is_streaming;
 } RpcGuiSystem;
@@ -34,16 +42,40 @@ static void
     furi_assert(context);
 
     RpcGuiSystem* rpc_gui = (RpcGuiSystem*)context;
-    uint8_t* buffer = rpc_gui->transmit_frame->content.gui_screen_frame.data->bytes;
-
-    furi_assert(size == rpc_gui->transmit_frame->content.gui_screen_frame.data->size);
 
-    memcpy(buffer, data, size);
+    if(rpc_gui->frame) {
+        furi_assert(size == rpc_gui->framebuffer_size);
+        osMutexAcquire(rpc_gui->frame_mutex, osWaitForever);
+        memcpy(rpc_gui->frame, data, size);
+        osMutexRelease(rpc_gui->frame_mutex);
+    } else {
+        uint8_t* buffer = rpc_gui->transmit_frame->content.gui_screen_frame.data->bytes;
+        furi_assert(size == rpc_gui->transmit_frame->content.gui_screen_frame.data->size);
+        memcpy(buffer, data, size);
+    }
 
     osThreadFlagsSet(
         furi_thread_get_thread_id(rpc_gui->transmit_thread), RpcGuiWorkerFlagTransmit);
 }
 
+/** Put delta or keyframe of latest frame into transmit_frame
+ *
+ * @return false if frame hasn't changed and nothing has to be sent
+ */
+static bool rpc_system_gui_screen_stream_encode_delta(RpcGuiSystem* rpc_gui) {
+    osMutexAcquire(rpc_gui->frame_mutex, osWaitForever);
+    memcpy(rpc_gui->current_frame, rpc_gui->frame, rpc_gui->framebuffer_size);
+    osMutexRelease(rpc_gui->frame_mutex);
+
+    pb_bytes_array_t* data = rpc_gui->transmit_frame->content.gui_screen_frame.data;
+    size_t data_size = 0;
+    bool result =
+        rpc_gui_frame_encode(rpc_gui->encoder, rpc_gui->current_frame, data->bytes, &data_size);
+    data->size = data_size;
+
+    return result;
+}
+
 static int32_t rpc_system_gui_screen_stream_frame_transmit_thread(void* context) {
     furi_assert(context);
 
@@ -52,7 +84,9 @@ static int32_t rpc_system_gui_screen_stream_frame_transmit_thread(void* context)
     while(true) {
         uint32_t flags = osThreadFlagsWait(RpcGuiWorkerFlagAny, osFlagsWaitAny, osWaitForever);
         if(flags & RpcGuiWorkerFlagTransmit) {
-            rpc_send(rpc_gui->session, rpc_gui->transmit_frame);
+            if(!rpc_gui->frame || rpc_system_gui_screen_stream_encode_delta(rpc_gui)) {
+                rpc_send(rpc_gui->session, rpc_gui->transmit_frame);
+            }
         }
         if(flags & RpcGuiWorkerFlagExit) {
             break;
@@ -62,6 +96,29 @@ static int32_t rpc_system_gui_screen_stream_frame_transmit_thread(void* context)
     return 0;
 }
 
+static void rpc_system_gui_screen_stream_stop(RpcGuiSystem* rpc_gui) {
+    rpc_gui->is_streaming = false;
+    // Remove GUI framebuffer callback
+    gui_remove_framebuffer_callback(
+        rpc_gui->gui, rpc_system_gui_screen_stream_frame_callback, rpc_gui);
+    // Stop and release worker thread
+    osThreadFlagsSet(furi_thread_get_thread_id(rpc_gui->transmit_thread), RpcGuiWorkerFlagExit);
+    furi_thread_join(rpc_gui->transmit_thread);
+    furi_thread_free(rpc_gui->transmit_thread);
+    // Release frame
+    pb_release(&PB_Main_msg, rpc_gui->transmit_frame);
+    free(rpc_gui->transmit_frame);
+    rpc_gui->transmit_frame = NULL;
+    // Release delta buffers
+    if(rpc_gui->frame) {
+        osMutexDelete(rpc_gui->frame_mutex);
+        free(rpc_gui->frame);
+        free(rpc_gui->current_frame);
+        rpc_gui_frame_encoder_free(rpc_gui->encoder);
+        rpc_gui->frame = NULL;
+    }
+}
+
 static void rpc_system_gui_start_screen_stream_process(const PB_Main* request, void* context) {
     furi_assert(request);
     furi_assert(context);
@@ -80,12 +137,23 @@ static void rpc_system_gui_start_screen_stream_process(const PB_Main* request, v
 
         rpc_gui->is_streaming = true;
         size_t framebuffer_size = gui_get_framebuffer_size(rpc_gui->gui);
+        size_t frame_data_size = framebuffer_size;
+        uint32_t features = rpc_session_get_features(session);
+        if(features & RpcSessionFeatureScreenDelta) {
+            rpc_gui->framebuffer_size = framebuffer_size;
+            rpc_gui->frame_mutex = osMutexNew(NULL);
+            rpc_gui->frame = malloc(framebuffer_size);
+            rpc_gui->current_frame = malloc(framebuffer_size);
+            rpc_gui->encoder = rpc_gui_frame_encoder_alloc(
+                framebuffer_size, features & RpcSessionFeatureScreenCompress);
+            frame_data_size = RPC_GUI_FRAME_SIZE_MAX(framebuffer_size);
+        }
         // Reusable Frame
         rpc_gui->transmit_frame = malloc(sizeof(PB_Main));
         rpc_gui->transmit_frame->which_content = PB_Main_gui_screen_frame_tag;
         rpc_gui->transmit_frame->command_status = PB_CommandStatus_OK;
         rpc_gui->transmit_frame->content.gui_screen_frame.data =
-            malloc(PB_BYTES_ARRAY_T_ALLOCSIZE(framebuffer_size));
+            malloc(PB_BYTES_ARRAY_T_ALLOCSIZE(frame_data_size));
         rpc_gui->transmit_frame->content.gui_screen_frame.data->size = framebuffer_size;
         // Transmission thread for async TX
         rpc_gui->transmit_thread = furi_thread_alloc();
@@ -112,19 +180,7 @@ static void rpc_system_gui_stop_screen_stream_process(const PB_Main* request, vo
     furi_assert(session);
 
     if(rpc_gui->is_streaming) {
-        rpc_gui->is_streaming = false;
-        // Remove GUI framebuffer callback
-        gui_remove_framebuffer_callback(
-            rpc_gui->gui, rpc_system_gui_screen_stream_frame_callback, context);
-        // Stop and release worker thread
-        osThreadFlagsSet(
-            furi_thread_get_thread_id(rpc_gui->transmit_thread), RpcGuiWorkerFlagExit);
-        furi_thread_join(rpc_gui->transmit_thread);
-        furi_thread_free(rpc_gui->transmit_thread);
-        // Release frame
-        pb_release(&PB_Main_msg, rpc_gui->transmit_frame);
-        free(rpc_gui->transmit_frame);
-        rpc_gui->transmit_frame = NULL;
+        rpc_system_gui_screen_stream_stop(rpc_gui);
     }
 
     rpc_send_and_release_empty(session, request->command_id, PB_CommandStatus_OK);
@@ -362,19 +418,7 @@ void rpc_system_gui_free(void* context) {
     }
 
     if(rpc_gui->is_streaming) {
-        rpc_gui->is_streaming = false;
-        // Remove GUI framebuffer callback
-        gui_remove_framebuffer_callback(
-            rpc_gui->gui, rpc_system_gui_screen_stream_frame_callback, context);
-        // Stop and release worker thread
-        osThreadFlagsSet(
-            furi_thread_get_thread_id(rpc_gui->transmit_thread), RpcGuiWorkerFlagExit);
-        furi_thread_join(rpc_gui->transmit_thread);
-        furi_thread_free(rpc_gui->transmit_thread);
-        // Release frame
-        pb_release(&PB_Main_msg, rpc_gui->transmit_frame);
-        free(rpc_gui->transmit_frame);
-        rpc_gui->transmit_frame = NULL;
+        rpc_system_gui_screen_stream_stop(rpc_gui);
     }
     furi_record_close("gui");
     free(rpc_gui);
@@ -0,0 +1,105 @@
+#include "rpc_gui_frame.h"
+#include <furi.h>
+#include <furi_hal_compress.h>
+
+struct RpcGuiFrameEncoder {
+    size_t framebuffer_size;
+    size_t frame_count;
+    uint8_t* previous_frame; // last frame known by client
+    uint8_t* payload;
+    FuriHalCompress* compress;
+};
+
+RpcGuiFrameEncoder* rpc_gui_frame_encoder_alloc(size_t framebuffer_size, bool compress) {
+    furi_assert(framebuffer_size % RPC_GUI_FRAME_TILE_SIZE == 0);
+
+    RpcGuiFrameEncoder* encoder = malloc(sizeof(RpcGuiFrameEncoder));
+    encoder->framebuffer_size = framebuffer_size;
+    encoder->previous_frame = malloc(framebuffer_size);
+    encoder->payload = malloc(RPC_GUI_FRAME_MAP_SIZE(framebuffer_size) + framebuffer_size);
+    if(compress) {
+        encoder->compress = furi_hal_compress_alloc(framebuffer_size);
+    }
+
+    return encoder;
+}
+
+void rpc_gui_frame_encoder_free(RpcGuiFrameEncoder* encoder) {
+    furi_assert(encoder);
+
+    if(encoder->compress) {
+        furi_hal_compress_free(encoder->compress);
+    }
+    free(encoder->payload);
+    free(encoder->previous_frame);
+    free(encoder);
+}
+
+bool rpc_gui_frame_encode(
+    RpcGuiFrameEncoder* encoder,
+    const uint8_t* frame,
+    uint8_t* data,
+    size_t* data_size) {
+    furi_assert(encoder);
+    furi_assert(frame);
+    furi_assert(data);
+    furi_assert(data_size);
+
+    size_t size = encoder->framebuffer_size;
+    uint8_t* previous = encoder->previous_frame;
+    uint8_t* payload = encoder->payload;
+
+    uint8_t flags = 0;
+    size_t payload_size = 0;
+    if(encoder->frame_count % RPC_GUI_FRAME_KEYFRAME_INTERVAL) {
+        size_t tile_count = size / RPC_GUI_FRAME_TILE_SIZE;
+        size_t map_size = RPC_GUI_FRAME_MAP_SIZE(size);
+        memset(payload, 0, map_size);
+        payload_size = map_size;
+        for(size_t tile = 0; tile < tile_count; tile++) {
+            size_t offset = tile * RPC_GUI_FRAME_TILE_SIZE;
+            if(memcmp(&frame[offset], &previous[offset], RPC_GUI_FRAME_TILE_SIZE)) {
+                payload[tile / 8] |= 1 << (tile % 8);
+                for(size_t i = 0; i < RPC_GUI_FRAME_TILE_SIZE; i++) {
+                    payload[payload_size++] = frame[offset + i] ^ previous[offset + i];
+                }
+            }
+        }
+        if(payload_size == map_size) {
+            return false;
+        }
+        flags |= RpcGuiFrameFlagDelta;
+    }
+
+    if(!(flags & RpcGuiFrameFlagDelta) || (payload_size >= size)) {
+        flags &= ~RpcGuiFrameFlagDelta;
+        memcpy(payload, frame, size);
+        payload_size = size;
+        encoder->frame_count = 0;
+    }
+
+    bool compressed = false;
+    if(encoder->compress) {
+        compressed = furi_hal_compress_encode(
+            encoder->compress,
+            payload,
+            payload_size,
+            &data[1],
+            RPC_GUI_FRAME_COMPRESS_BOUND(payload_size),
+            data_size);
+        /* Encoder falls back to raw data with own one byte header, drop it then */
+        compressed = compressed && data[1];
+    }
+    if(compressed) {
+        flags |= RpcGuiFrameFlagCompressed;
+    } else {
+        memcpy(&data[1], payload, payload_size);
+        *data_size = payload_size;
+    }
+    data[0] = flags;
+    *data_size += 1;
+
+    memcpy(previous, frame, size);
+    encoder->frame_count++;
+    return true;
+}
@@ -0,0 +1,89 @@
+/**
+ * @file rpc_gui_frame.h
+ * RPC: screen frame encoding for RpcSessionFeatureScreenDelta sessions
+ *
+ * Without the feature PB_Gui_ScreenFrame.data is the framebuffer. With it:
+ *
+ *     byte 0      RpcGuiFrameFlag bitmask
+ *     byte 1..N   payload
+ *
+ * Keyframe payload is the framebuffer. Delta payload is a bitmap of changed
+ * tiles, bit N is set for tile N (LSB first, ceil(tiles / 8) bytes), followed
+ * by every changed tile XOR-ed with the same tile of previous frame. Tile is
+ * RPC_GUI_FRAME_TILE_SIZE consecutive framebuffer bytes.
+ *
+ * With RpcGuiFrameFlagCompressed the payload is heatshrink stream (window
+ * 2^FURI_HAL_COMPRESS_EXP_BUFF_SIZE_LOG, lookahead
+ * 2^FURI_HAL_COMPRESS_LOOKAHEAD_BUFF_SIZE_LOG) preceded by 4 byte header:
+ * 0x01, 0x00, uint16_t little endian size of header and stream, as produced
+ * by furi_hal_compress_encode().
+ *
+ * Frames without changes are not sent. Keyframe is sent first, at least
+ * every RPC_GUI_FRAME_KEYFRAME_INTERVAL frames and when delta is not smaller.
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum {
+    RpcGuiFrameFlagDelta = (1 << 0), /**< Payload is delta to previous frame */
+    RpcGuiFrameFlagCompressed = (1 << 1), /**< Payload is compressed */
+} RpcGuiFrameFlag;
+
+#define RPC_GUI_FRAME_TILE_SIZE (8)
+#define RPC_GUI_FRAME_KEYFRAME_INTERVAL (64)
+
+/** Size of changed tiles bitmap */
+#define RPC_GUI_FRAME_MAP_SIZE(framebuffer_size) \
+    (((framebuffer_size) / RPC_GUI_FRAME_TILE_SIZE + 7) / 8)
+
+/** furi_hal_compress_encode() output room for incompressible data: header,
+ * one flag bit per literal and margin kept free by encoder on finish */
+#define RPC_GUI_FRAME_COMPRESS_BOUND(size) (4 + (size) + (size) / 8 + 4)
+
+/** Buffer size for encoded frame: flags and the largest payload */
+#define RPC_GUI_FRAME_SIZE_MAX(framebuffer_size) \
+    (1 + RPC_GUI_FRAME_COMPRESS_BOUND(             \
+             RPC_GUI_FRAME_MAP_SIZE(framebuffer_size) + (framebuffer_size)))
+
+typedef struct RpcGuiFrameEncoder RpcGuiFrameEncoder;
+
+/** Allocate encoder, first frame will be a keyframe
+ *
+ * @param   framebuffer_size    size of every frame, multiple of tile size
+ * @param   compress            compress payload when it pays off
+ *
+ * @return  RpcGuiFrameEncoder instance
+ */
+RpcGuiFrameEncoder* rpc_gui_frame_encoder_alloc(size_t framebuffer_size, bool compress);
+
+/** Free encoder
+ *
+ * @param   encoder     RpcGuiFrameEncoder instance
+ */
+void rpc_gui_frame_encoder_free(RpcGuiFrameEncoder* encoder);
+
+/** Encode frame as delta to previously encoded one or as keyframe
+ *
+ * @param   encoder     RpcGuiFrameEncoder instance
+ * @param   frame       framebuffer
+ * @param   data        output, RPC_GUI_FRAME_SIZE_MAX(framebuffer_size) bytes
+ * @param   data_size   encoded frame size
+ *
+ * @return  false if frame hasn't changed and nothing has to be sent
+ */
+bool rpc_gui_frame_encode(
+    RpcGuiFrameEncoder* encoder,
+    const uint8_t* frame,
+    uint8_t* data,
+    size_t* data_size);
+
+#ifdef __cplusplus
+}
+#endif
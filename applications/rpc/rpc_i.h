@@ -7,6 +7,9 @@
 #include <flipper.pb.h>
 #include <cli/cli.h>
 
+/** Max size of a message apart from its chunk payload */
+#define RPC_MESSAGE_OVERHEAD (RPC_MAX_MESSAGE_SIZE - RPC_CHUNK_SIZE_DEFAULT)
+
 typedef void* (*RpcSystemAlloc)(RpcSession* session);
 typedef void (*RpcSystemFree)(void* context);
 typedef void (*PBMessageHandler)(const PB_Main* msg_request, void* context);
@@ -21,6 +24,22 @@ void rpc_send(RpcSession* session, PB_Main* main_message);
 
 void rpc_send_and_release(RpcSession* session, PB_Main* main_message);
 
+/** Encode message once into caller owned buffer and send it
+ * Intended for streams of messages (e.g. file chunks), so buffer can be
+ * allocated once and reused. rpc_send() does the same with session buffer,
+ * which is kept small. Falls back to rpc_send() if message doesn't fit.
+ *
+ * @param   session         pointer to RpcSession descriptor
+ * @param   main_message    message to send, not released
+ * @param   buffer          encode buffer
+ * @param   buffer_size     size of encode buffer
+ */
+void rpc_send_with_buffer(
+    RpcSession* session,
+    PB_Main* main_message,
+    uint8_t* buffer,
+    size_t buffer_size);
+
 void rpc_send_and_release_empty(RpcSession* session, uint32_t command_id, PB_CommandStatus status);
 
 void rpc_add_handler(RpcSession* session, pb_size_t message_tag, RpcHandler* handler);
@@ -16,7 +16,8 @@
 
 #define MAX_NAME_LENGTH 255
 
-static const size_t MAX_DATA_SIZE = 512;
+/* Read response fields apart from data, with length prefix */
+#define READ_RESPONSE_OVERHEAD (64)
 
 typedef enum {
     RpcStorageStateIdle = 0,
@@ -29,6 +30,7 @@ typedef struct {
     File* file;
     RpcStorageState state;
     uint32_t current_command_id;
+    size_t chunk_size;
 } RpcStorageSystem;
 
 void rpc_print_message(const PB_Main* message);
@@ -297,27 +299,32 @@ static void rpc_system_storage_read_process(const PB_Main* request, void* contex
 
     if(storage_file_open(file, path, FSAM_READ, FSOM_OPEN_EXISTING)) {
         size_t size_left = storage_file_size(file);
+        size_t chunk_size = MIN(size_left, rpc_storage->chunk_size);
+        /* same data and encode buffers serve all chunks of file */
+        pb_bytes_array_t* data = malloc(PB_BYTES_ARRAY_T_ALLOCSIZE(chunk_size));
+        size_t tx_buffer_size = chunk_size + READ_RESPONSE_OVERHEAD;
+        uint8_t* tx_buffer = malloc(tx_buffer_size);
+
+        response->command_id = request->command_id;
+        response->which_content = PB_Main_storage_read_response_tag;
+        response->command_status = PB_CommandStatus_OK;
+        response->content.storage_read_response.has_file = true;
+        response->content.storage_read_response.file.data = data;
         do {
-            response->command_id = request->command_id;
-            response->which_content = PB_Main_storage_read_response_tag;
-            response->command_status = PB_CommandStatus_OK;
-            response->content.storage_read_response.has_file = true;
-            response->content.storage_read_response.file.data =
-                malloc(PB_BYTES_ARRAY_T_ALLOCSIZE(MIN(size_left, MAX_DATA_SIZE)));
-            uint8_t* buffer = response->content.storage_read_response.file.data->bytes;
-            uint16_t* read_size_msg = &response->content.storage_read_response.file.data->size;
-
-            size_t read_size = MIN(size_left, MAX_DATA_SIZE);
-            *read_size_msg = storage_file_read(file, buffer, read_size);
+            size_t read_size = MIN(size_left, chunk_size);
+            data->size = storage_file_read(file, data->bytes, read_size);
             size_left -= read_size;
-            result = (*read_size_msg == read_size);
+            result = (data->size == read_size);
 
             if(result) {
                 response->has_next = (size_left > 0);
-                rpc_send_and_release(session, response);
+                rpc_send_with_buffer(session, response, tx_buffer, tx_buffer_size);
             }
         } while((size_left != 0) && result);
 
+        free(tx_buffer);
+        free(data);
+
         if(!result) {
             rpc_send_and_release_empty(
                 session, request->command_id, rpc_system_storage_get_file_error(file));
@@ -621,6 +628,7 @@ void* rpc_system_storage_alloc(RpcSession* session) {
     rpc_storage->api = furi_record_open("storage");
     rpc_storage->session = session;
     rpc_storage->state = RpcStorageStateIdle;
+    rpc_storage->chunk_size = rpc_session_get_chunk_size(session);
 
     RpcHandler rpc_handler = {
         .message_handler = NULL,
@@ -12,6 +12,7 @@
 typedef struct {
     RpcSession* session;
     PB_Main* response;
+    bool heap_profile;
 } RpcSystemContext;
 
 static void rpc_system_system_ping_process(const PB_Main* request, void* context) {
@@ -81,11 +82,19 @@ static void rpc_system_system_device_info_callback(
     char* str_key = strdup(key);
     char* str_value = strdup(value);
 
-    ctx->response->has_next = !last;
+    // Heap allocation profile follows device info when it was collected
+    bool heap_profile = last && ctx->heap_profile;
+
+    ctx->response->has_next = !last || heap_profile;
     ctx->response->content.system_device_info_response.key = str_key;
     ctx->response->content.system_device_info_response.value = str_value;
 
     rpc_send_and_release(ctx->session, ctx->response);
+
+    if(heap_profile) {
+        ctx->heap_profile = false;
+        memmgr_heap_profile_export(rpc_system_system_device_info_callback, ctx);
+    }
 }
 
 static void rpc_system_system_device_info_process(const PB_Main* request, void* context) {
@@ -105,6 +114,7 @@ static void rpc_system_system_device_info_process(const PB_Main* request, void*
     RpcSystemContext device_info_context = {
         .session = session,
         .response = response,
+        .heap_profile = memmgr_heap_profile_is_available(),
     };
     furi_hal_info_get(rpc_system_system_device_info_callback, &device_info_context);
 
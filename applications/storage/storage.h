@@ -25,6 +25,7 @@ typedef enum {
     StorageEventTypeCardMountError,
     StorageEventTypeFileClose,
     StorageEventTypeDirClose,
+    StorageEventTypeChange, /**< file written or removed, directory created */
 } StorageEventType;
 
 typedef struct {
@@ -265,7 +266,7 @@ FS_Error storage_sd_status(Storage* api);
 
 /******************* Internal LFS Functions *******************/
 
-/** Backs up internal storage to a tar archive
+/** Backs up internal storage to a heatshrink-compressed tar archive
  * @param api pointer to the api
  * @param dstmane destination archive path
  * @return FS_Error operation result
@@ -8,6 +8,7 @@ void storage_file_init(StorageFile* obj) {
     obj->type = ST_ERROR;
     obj->file_data = NULL;
     string_init(obj->path);
+    obj->write_access = false;
 }
 
 void storage_file_init_set(StorageFile* obj, const StorageFile* src) {
@@ -15,6 +16,7 @@ void storage_file_init_set(StorageFile* obj, const StorageFile* src) {
     obj->type = src->type;
     obj->file_data = src->file_data;
     string_init_set(obj->path, src->path);
+    obj->write_access = src->write_access;
 }
 
 void storage_file_set(StorageFile* obj, const StorageFile* src) {
@@ -22,6 +24,7 @@ void storage_file_set(StorageFile* obj, const StorageFile* src) {
     obj->type = src->type;
     obj->file_data = src->file_data;
     string_set(obj->path, src->path);
+    obj->write_access = src->write_access;
 }
 
 void storage_file_clear(StorageFile* obj) {
@@ -160,7 +163,30 @@ void* storage_get_storage_file_data(const File* file, StorageData* storage) {
     return founded_file->file_data;
 }
 
-void storage_push_storage_file(File* file, string_t path, StorageType type, StorageData* storage) {
+bool storage_get_storage_file_write_access(const File* file, StorageData* storage) {
+    const StorageFile* founded_file = NULL;
+
+    StorageFileList_it_t it;
+
+    for(StorageFileList_it(it, storage->files); !StorageFileList_end_p(it);
+        StorageFileList_next(it)) {
+        const StorageFile* storage_file = StorageFileList_cref(it);
+
+        if(storage_file->file->file_id == file->file_id) {
+            founded_file = storage_file;
+            break;
+        }
+    }
+
+    return founded_file && founded_file->write_access;
+}
+
+void storage_push_storage_file(
+    File* file,
+    string_t path,
+    StorageType type,
+    bool write_access,
+    StorageData* storage) {
     StorageFile* storage_file = StorageFileList_push_new(storage->files);
     furi_check(storage_file != NULL);
 
@@ -168,6 +194,7 @@ void storage_push_storage_file(File* file, string_t path, StorageType type, Stor
     storage_file->file = file;
     storage_file->type = type;
     string_set(storage_file->path, path);
+    storage_file->write_access = write_access;
 }
 
 bool storage_pop_storage_file(File* file, StorageData* storage) {
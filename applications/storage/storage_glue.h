@@ -22,6 +22,7 @@ typedef struct {
     StorageType type;
     void* file_data;
     string_t path;
+    bool write_access;
 } StorageFile;
 
 typedef enum {
@@ -67,7 +68,14 @@ bool storage_path_already_open(string_t path, StorageFileList_t files);
 void storage_set_storage_file_data(const File* file, void* file_data, StorageData* storage);
 void* storage_get_storage_file_data(const File* file, StorageData* storage);
 
-void storage_push_storage_file(File* file, string_t path, StorageType type, StorageData* storage);
+bool storage_get_storage_file_write_access(const File* file, StorageData* storage);
+
+void storage_push_storage_file(
+    File* file,
+    string_t path,
+    StorageType type,
+    bool write_access,
+    StorageData* storage);
 bool storage_pop_storage_file(File* file, StorageData* storage);
 
 #ifdef __cplusplus
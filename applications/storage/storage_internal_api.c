@@ -7,7 +7,7 @@
 
 FS_Error storage_int_backup(Storage* api, const char* dstname) {
     TarArchive* archive = tar_archive_alloc(api);
-    bool success = tar_archive_open(archive, dstname, TAR_OPEN_MODE_WRITE) &&
+    bool success = tar_archive_open(archive, dstname, TAR_OPEN_MODE_WRITE_HEATSHRINK) &&
                    tar_archive_add_dir(archive, INT_PATH, "") && tar_archive_finalize(archive);
     tar_archive_free(archive);
     return success ? FSE_OK : FSE_INTERNAL;
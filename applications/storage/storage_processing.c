@@ -112,7 +112,8 @@ bool storage_process_file_open(
         if(storage_path_already_open(real_path, storage->files)) {
             file->error_id = FSE_ALREADY_OPEN;
         } else {
-            storage_push_storage_file(file, real_path, type, storage);
+            storage_push_storage_file(
+                file, real_path, type, (access_mode & FSAM_WRITE) != 0, storage);
             FS_CALL(storage, file.open(storage, file, remove_vfs(path), access_mode, open_mode));
         }
 
@@ -129,11 +130,16 @@ bool storage_process_file_close(Storage* app, File* file) {
     if(storage == NULL) {
         file->error_id = FSE_INVALID_PARAMETER;
     } else {
+        bool changed = storage_get_storage_file_write_access(file, storage);
         FS_CALL(storage, file.close(storage, file));
         storage_pop_storage_file(file, storage);
 
         StorageEvent event = {.type = StorageEventTypeFileClose};
         furi_pubsub_publish(app->pubsub, &event);
+        if(changed) {
+            event.type = StorageEventTypeChange;
+            furi_pubsub_publish(app->pubsub, &event);
+        }
     }
 
     return ret;
@@ -271,7 +277,7 @@ bool storage_process_dir_open(Storage* app, File* file, const char* path) {
         if(storage_path_already_open(real_path, storage->files)) {
             file->error_id = FSE_ALREADY_OPEN;
         } else {
-            storage_push_storage_file(file, real_path, type, storage);
+            storage_push_storage_file(file, real_path, type, false, storage);
             FS_CALL(storage, dir.open(storage, file, remove_vfs(path)));
         }
         string_clear(real_path);
@@ -365,6 +371,10 @@ static FS_Error storage_process_common_remove(Storage* app, const char* path) {
         }
 
         FS_CALL(storage, common.remove(storage, remove_vfs(path)));
+        if(ret == FSE_OK) {
+            StorageEvent event = {.type = StorageEventTypeChange};
+            furi_pubsub_publish(app->pubsub, &event);
+        }
     } while(false);
 
     string_clear(real_path);
@@ -381,6 +391,10 @@ static FS_Error storage_process_common_mkdir(Storage* app, const char* path) {
     } else {
         StorageData* storage = storage_get_storage_by_type(app, type);
         FS_CALL(storage, common.mkdir(storage, remove_vfs(path)));
+        if(ret == FSE_OK) {
+            StorageEvent event = {.type = StorageEventTypeChange};
+            furi_pubsub_publish(app->pubsub, &event);
+        }
     }
 
     return ret;
@@ -23,10 +23,10 @@ static bool subghz_scene_receiver_info_update_parser(void* context) {
     subghz->txrx->decoder_result = subghz_receiver_search_decoder_base_by_name(
         subghz->txrx->receiver,
         subghz_history_get_protocol_name(subghz->txrx->history, subghz->txrx->idx_menu_chosen));
-    if(subghz->txrx->decoder_result) {
-        subghz_protocol_decoder_base_deserialize(
-            subghz->txrx->decoder_result,
-            subghz_history_get_raw_data(subghz->txrx->history, subghz->txrx->idx_menu_chosen));
+    FlipperFormat* raw_data =
+        subghz_history_get_raw_data(subghz->txrx->history, subghz->txrx->idx_menu_chosen);
+    if(subghz->txrx->decoder_result && raw_data &&
+       subghz_protocol_decoder_base_deserialize(subghz->txrx->decoder_result, raw_data)) {
         subghz->txrx->frequency =
             subghz_history_get_frequency(subghz->txrx->history, subghz->txrx->idx_menu_chosen);
         subghz->txrx->preset =
@@ -118,12 +118,14 @@ bool subghz_scene_receiver_info_on_event(void* context, SceneManagerEvent event)
             if(!subghz_scene_receiver_info_update_parser(subghz)) {
                 return false;
             }
+            FlipperFormat* raw_data =
+                subghz_history_get_raw_data(subghz->txrx->history, subghz->txrx->idx_menu_chosen);
+            if(!raw_data) {
+                return false;
+            }
             if(subghz->txrx->txrx_state == SubGhzTxRxStateIDLE ||
                subghz->txrx->txrx_state == SubGhzTxRxStateSleep) {
-                if(!subghz_tx_start(
-                       subghz,
-                       subghz_history_get_raw_data(
-                           subghz->txrx->history, subghz->txrx->idx_menu_chosen))) {
+                if(!subghz_tx_start(subghz, raw_data)) {
                     scene_manager_next_scene(subghz->scene_manager, SubGhzSceneShowOnlyRx);
                 } else {
                     subghz->state_notifications = SubGhzNotificationStateTX;
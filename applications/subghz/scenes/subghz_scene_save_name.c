@@ -91,11 +91,15 @@ bool subghz_scene_save_name_on_event(void* context, SceneManagerEvent event) {
                             SubGhzSceneSetType,
                             SubGhzCustomEventManagerNoSet);
                     } else {
-                        subghz_save_protocol_to_file(
-                            subghz,
-                            subghz_history_get_raw_data(
-                                subghz->txrx->history, subghz->txrx->idx_menu_chosen),
-                            subghz->file_path);
+                        FlipperFormat* raw_data = subghz_history_get_raw_data(
+                            subghz->txrx->history, subghz->txrx->idx_menu_chosen);
+                        if(!raw_data) {
+                            string_set(subghz->error_str, "Error history parse.");
+                            scene_manager_next_scene(
+                                subghz->scene_manager, SubGhzSceneShowErrorSub);
+                            return true;
+                        }
+                        subghz_save_protocol_to_file(subghz, raw_data, subghz->file_path);
                     }
                 }
 
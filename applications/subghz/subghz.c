@@ -149,8 +149,8 @@ SubGhz* subghz_alloc() {
 
     subghz_worker_set_overrun_callback(
         subghz->txrx->worker, (SubGhzWorkerOverrunCallback)subghz_receiver_reset);
-    subghz_worker_set_pair_callback(
-        subghz->txrx->worker, (SubGhzWorkerPairCallback)subghz_receiver_decode);
+    subghz_worker_set_batch_callback(
+        subghz->txrx->worker, (SubGhzWorkerBatchCallback)subghz_receiver_decode_batch);
     subghz_worker_set_context(subghz->txrx->worker, subghz->txrx->receiver);
 
     //Init Error_str
@@ -1,82 +1,83 @@
 #include "subghz_history.h"
 #include <lib/subghz/receiver.h>
-#include <lib/subghz/protocols/came.h>
+#include <lib/subghz/blocks/generic.h>
+#include <lib/subghz/protocols/registry.h>
+#include <lib/flipper_format/flipper_format_i.h>
+#include <lib/toolbox/stream/stream.h>
 
 #include <furi.h>
 #include <m-string.h>
 
-#define SUBGHZ_HISTORY_MAX 50
+#define SUBGHZ_HISTORY_MAX 300
 #define TAG "SubGhzHistory"
 
+/** Packed history record, serialized to FlipperFormat only on demand */
 typedef struct {
-    string_t item_str;
-    FlipperFormat* flipper_string;
-    uint8_t type;
-    FuriHalSubGhzPreset preset;
+    uint64_t key;
+    char* extra; /**< protocol specific fields following Key, NULL if none */
     uint32_t frequency;
+    uint8_t protocol; /**< index in subghz_protocol_registry */
+    uint8_t bit_count;
+    uint8_t type;
+    uint8_t preset;
 } SubGhzHistoryItem;
 
-ARRAY_DEF(SubGhzHistoryItemArray, SubGhzHistoryItem, M_POD_OPLIST)
-
-#define M_OPL_SubGhzHistoryItemArray_t() ARRAY_OPLIST(SubGhzHistoryItemArray, M_POD_OPLIST)
-
-typedef struct {
-    SubGhzHistoryItemArray_t data;
-} SubGhzHistoryStruct;
-
 struct SubGhzHistory {
     uint32_t last_update_timestamp;
     uint16_t last_index_write;
     uint8_t code_last_hash_data;
     string_t tmp_string;
-    SubGhzHistoryStruct* history;
+    FlipperFormat* flipper_string; /**< get_raw_data output, read on GUI thread */
+    FlipperFormat* add_flipper_string; /**< add_to_history scratch, used on worker thread */
+    SubGhzHistoryItem* items;
 };
 
 SubGhzHistory* subghz_history_alloc(void) {
     SubGhzHistory* instance = malloc(sizeof(SubGhzHistory));
     string_init(instance->tmp_string);
-    instance->history = malloc(sizeof(SubGhzHistoryStruct));
-    SubGhzHistoryItemArray_init(instance->history->data);
+    instance->flipper_string = flipper_format_string_alloc();
+    instance->add_flipper_string = flipper_format_string_alloc();
+    instance->items = malloc(sizeof(SubGhzHistoryItem) * SUBGHZ_HISTORY_MAX);
     return instance;
 }
 
+static void subghz_history_clear_items(SubGhzHistory* instance) {
+    for(uint16_t i = 0; i < instance->last_index_write; i++) {
+        free(instance->items[i].extra);
+        instance->items[i].extra = NULL;
+    }
+    instance->last_index_write = 0;
+}
+
 void subghz_history_free(SubGhzHistory* instance) {
     furi_assert(instance);
+    subghz_history_clear_items(instance);
     string_clear(instance->tmp_string);
-    for
-        M_EACH(item, instance->history->data, SubGhzHistoryItemArray_t) {
-            string_clear(item->item_str);
-            flipper_format_free(item->flipper_string);
-            item->type = 0;
-        }
-    SubGhzHistoryItemArray_clear(instance->history->data);
-    free(instance->history);
+    flipper_format_free(instance->flipper_string);
+    flipper_format_free(instance->add_flipper_string);
+    free(instance->items);
     free(instance);
 }
 
+static SubGhzHistoryItem* subghz_history_get(SubGhzHistory* instance, uint16_t idx) {
+    furi_check(idx < instance->last_index_write);
+    return &instance->items[idx];
+}
+
 uint32_t subghz_history_get_frequency(SubGhzHistory* instance, uint16_t idx) {
     furi_assert(instance);
-    SubGhzHistoryItem* item = SubGhzHistoryItemArray_get(instance->history->data, idx);
-    return item->frequency;
+    return subghz_history_get(instance, idx)->frequency;
 }
 
 FuriHalSubGhzPreset subghz_history_get_preset(SubGhzHistory* instance, uint16_t idx) {
     furi_assert(instance);
-    SubGhzHistoryItem* item = SubGhzHistoryItemArray_get(instance->history->data, idx);
-    return item->preset;
+    return (FuriHalSubGhzPreset)subghz_history_get(instance, idx)->preset;
 }
 
 void subghz_history_reset(SubGhzHistory* instance) {
     furi_assert(instance);
     string_reset(instance->tmp_string);
-    for
-        M_EACH(item, instance->history->data, SubGhzHistoryItemArray_t) {
-            string_clear(item->item_str);
-            flipper_format_free(item->flipper_string);
-            item->type = 0;
-        }
-    SubGhzHistoryItemArray_reset(instance->history->data);
-    instance->last_index_write = 0;
+    subghz_history_clear_items(instance);
     instance->code_last_hash_data = 0;
 }
 
@@ -87,30 +88,45 @@ uint16_t subghz_history_get_item(SubGhzHistory* instance) {
 
 uint8_t subghz_history_get_type_protocol(SubGhzHistory* instance, uint16_t idx) {
     furi_assert(instance);
-    SubGhzHistoryItem* item = SubGhzHistoryItemArray_get(instance->history->data, idx);
-    return item->type;
+    return subghz_history_get(instance, idx)->type;
 }
 
 const char* subghz_history_get_protocol_name(SubGhzHistory* instance, uint16_t idx) {
     furi_assert(instance);
-    SubGhzHistoryItem* item = SubGhzHistoryItemArray_get(instance->history->data, idx);
-    flipper_format_rewind(item->flipper_string);
-    if(!flipper_format_read_string(item->flipper_string, "Protocol", instance->tmp_string)) {
-        FURI_LOG_E(TAG, "Missing Protocol");
-        string_reset(instance->tmp_string);
-    }
-    return string_get_cstr(instance->tmp_string);
+    SubGhzHistoryItem* item = subghz_history_get(instance, idx);
+    return subghz_protocol_registry_get_by_index(item->protocol)->name;
 }
 
 FlipperFormat* subghz_history_get_raw_data(SubGhzHistory* instance, uint16_t idx) {
     furi_assert(instance);
-    SubGhzHistoryItem* item = SubGhzHistoryItemArray_get(instance->history->data, idx);
-    if(item->flipper_string) {
-        return item->flipper_string;
-    } else {
-        return NULL;
-    }
+    SubGhzHistoryItem* item = subghz_history_get(instance, idx);
+
+    SubGhzBlockGeneric generic = {
+        .protocol_name = subghz_protocol_registry_get_by_index(item->protocol)->name,
+        .data = item->key,
+        .data_count_bit = item->bit_count,
+    };
+
+    FlipperFormat* flipper_format = instance->flipper_string;
+    Stream* stream = flipper_format_get_raw_stream(flipper_format);
+    bool res = false;
+    do {
+        if(!subghz_block_generic_serialize(
+               &generic, flipper_format, item->frequency, (FuriHalSubGhzPreset)item->preset)) {
+            break;
+        }
+        if(item->extra && !stream_write_cstring(stream, item->extra)) {
+            FURI_LOG_E(TAG, "Unable to restore protocol fields");
+            break;
+        }
+        res = true;
+    } while(false);
+
+    if(!res) return NULL;
+    flipper_format_rewind(flipper_format);
+    return flipper_format;
 }
+
 bool subghz_history_get_text_space_left(SubGhzHistory* instance, string_t output) {
     furi_assert(instance);
     if(instance->last_index_write == SUBGHZ_HISTORY_MAX) {
@@ -122,9 +138,78 @@ bool subghz_history_get_text_space_left(SubGhzHistory* instance, string_t output
     return false;
 }
 
+/** Find "key: value" line in the item's protocol specific fields */
+static bool
+    subghz_history_get_extra_value(SubGhzHistoryItem* item, const char* key, string_t value) {
+    if(!item->extra) return false;
+
+    size_t key_len = strlen(key);
+    const char* line = item->extra;
+    while(*line) {
+        const char* eol = strchr(line, '\n');
+        if(!eol) eol = line + strlen(line);
+        if(((size_t)(eol - line) > key_len + 1) && !strncmp(line, key, key_len) &&
+           line[key_len] == ':') {
+            const char* start = line + key_len + 1;
+            if(*start == ' ') start++;
+            string_set_strn(value, start, eol - start);
+            return true;
+        }
+        line = *eol ? eol + 1 : eol;
+    }
+    return false;
+}
+
 void subghz_history_get_text_item_menu(SubGhzHistory* instance, string_t output, uint16_t idx) {
-    SubGhzHistoryItem* item = SubGhzHistoryItemArray_get(instance->history->data, idx);
-    string_set(output, item->item_str);
+    furi_assert(instance);
+    SubGhzHistoryItem* item = subghz_history_get(instance, idx);
+    const char* name = subghz_protocol_registry_get_by_index(item->protocol)->name;
+
+    string_set_str(instance->tmp_string, name);
+    const char* prefix = NULL;
+    if(!strcmp(name, "KeeLoq")) {
+        prefix = "KL ";
+    } else if(!strcmp(name, "Star Line")) {
+        prefix = "SL ";
+    }
+    if(prefix) {
+        string_t text;
+        string_init(text);
+        if(subghz_history_get_extra_value(item, "Manufacture", text)) {
+            string_set_str(instance->tmp_string, prefix);
+            string_cat(instance->tmp_string, text);
+        } else {
+            FURI_LOG_E(TAG, "Missing Manufacture");
+        }
+        string_clear(text);
+    }
+
+    if(!(uint32_t)(item->key >> 32)) {
+        string_printf(
+            output,
+            "%s %lX",
+            string_get_cstr(instance->tmp_string),
+            (uint32_t)(item->key & 0xFFFFFFFF));
+    } else {
+        string_printf(
+            output,
+            "%s %lX%08lX",
+            string_get_cstr(instance->tmp_string),
+            (uint32_t)(item->key >> 32),
+            (uint32_t)(item->key & 0xFFFFFFFF));
+    }
+}
+
+static bool subghz_history_get_protocol_index(const SubGhzProtocol* protocol, uint8_t* index) {
+    size_t count = subghz_protocol_registry_count();
+    furi_assert(count <= UINT8_MAX);
+    for(size_t i = 0; i < count; i++) {
+        if(subghz_protocol_registry_get_by_index(i) == protocol) {
+            *index = i;
+            return true;
+        }
+    }
+    return false;
 }
 
 bool subghz_history_add_to_history(
@@ -148,71 +233,67 @@ bool subghz_history_add_to_history(
     instance->code_last_hash_data = subghz_protocol_decoder_base_get_hash_data(decoder_base);
     instance->last_update_timestamp = furi_hal_get_tick();
 
-    string_t text;
-    string_init(text);
-    SubGhzHistoryItem* item = SubGhzHistoryItemArray_push_raw(instance->history->data);
-    item->type = decoder_base->protocol->type;
-    item->frequency = frequency;
-    item->preset = preset;
-
-    string_init(item->item_str);
-    item->flipper_string = flipper_format_string_alloc();
-    subghz_protocol_decoder_base_serialize(decoder_base, item->flipper_string, frequency, preset);
+    SubGhzHistoryItem item = {
+        .frequency = frequency,
+        .type = decoder_base->protocol->type,
+        .preset = preset,
+    };
 
+    // Serialize once into own scratch stream and keep only the packed fields,
+    // record returned by get_raw_data may be in use on GUI thread meanwhile
+    FlipperFormat* flipper_format = instance->add_flipper_string;
+    Stream* stream = flipper_format_get_raw_stream(flipper_format);
+    bool res = false;
     do {
-        if(!flipper_format_rewind(item->flipper_string)) {
-            FURI_LOG_E(TAG, "Rewind error");
+        if(!subghz_history_get_protocol_index(decoder_base->protocol, &item.protocol)) {
+            FURI_LOG_E(TAG, "Unknown protocol");
             break;
         }
-        if(!flipper_format_read_string(item->flipper_string, "Protocol", instance->tmp_string)) {
-            FURI_LOG_E(TAG, "Missing Protocol");
+        if(!subghz_protocol_decoder_base_serialize(
+               decoder_base, flipper_format, frequency, preset)) {
+            FURI_LOG_E(TAG, "Serialize error");
             break;
         }
-        if(!strcmp(string_get_cstr(instance->tmp_string), "KeeLoq")) {
-            string_set(instance->tmp_string, "KL ");
-            if(!flipper_format_read_string(item->flipper_string, "Manufacture", text)) {
-                FURI_LOG_E(TAG, "Missing Protocol");
-                break;
-            }
-            string_cat(instance->tmp_string, text);
-        } else if(!strcmp(string_get_cstr(instance->tmp_string), "Star Line")) {
-            string_set(instance->tmp_string, "SL ");
-            if(!flipper_format_read_string(item->flipper_string, "Manufacture", text)) {
-                FURI_LOG_E(TAG, "Missing Protocol");
-                break;
-            }
-            string_cat(instance->tmp_string, text);
-        }
-        if(!flipper_format_rewind(item->flipper_string)) {
+        if(!flipper_format_rewind(flipper_format)) {
             FURI_LOG_E(TAG, "Rewind error");
             break;
         }
+        uint32_t bit_count = 0;
+        if(!flipper_format_read_uint32(flipper_format, "Bit", &bit_count, 1)) {
+            FURI_LOG_E(TAG, "Missing Bit");
+            break;
+        }
+        item.bit_count = bit_count;
         uint8_t key_data[sizeof(uint64_t)] = {0};
-        if(!flipper_format_read_hex(item->flipper_string, "Key", key_data, sizeof(uint64_t))) {
+        if(!flipper_format_read_hex(flipper_format, "Key", key_data, sizeof(uint64_t))) {
             FURI_LOG_E(TAG, "Missing Key");
             break;
         }
-        uint64_t data = 0;
         for(uint8_t i = 0; i < sizeof(uint64_t); i++) {
-            data = (data << 8) | key_data[i];
+            item.key = (item.key << 8) | key_data[i];
         }
-        if(!(uint32_t)(data >> 32)) {
-            string_printf(
-                item->item_str,
-                "%s %lX",
-                string_get_cstr(instance->tmp_string),
-                (uint32_t)(data & 0xFFFFFFFF));
-        } else {
-            string_printf(
-                item->item_str,
-                "%s %lX%08lX",
-                string_get_cstr(instance->tmp_string),
-                (uint32_t)(data >> 32),
-                (uint32_t)(data & 0xFFFFFFFF));
+
+        // Everything after the Key line is protocol specific, keep it verbatim
+        if(!stream_seek(stream, 1, StreamOffsetFromCurrent)) {
+            FURI_LOG_E(TAG, "Seek error");
+            break;
         }
+        size_t extra_size = stream_size(stream) - stream_tell(stream);
+        if(extra_size > 0) {
+            item.extra = malloc(extra_size + 1);
+            if(stream_read(stream, (uint8_t*)item.extra, extra_size) != extra_size) {
+                FURI_LOG_E(TAG, "Read error");
+                free(item.extra);
+                break;
+            }
+            item.extra[extra_size] = '\0';
+        }
+        res = true;
     } while(false);
 
-    string_clear(text);
+    if(!res) return false;
+
+    instance->items[instance->last_index_write] = item;
     instance->last_index_write++;
     return true;
 }
@@ -95,10 +95,14 @@ bool subghz_history_add_to_history(
     uint32_t frequency,
     FuriHalSubGhzPreset preset);
 
-/** Get SubGhzProtocolCommonLoad to load into the protocol decoder bin data
+/** Get FlipperFormat to load into the protocol decoder bin data
+ * 
+ * Record is serialized on request into a buffer shared by all records,
+ * returned pointer stays valid until the next call. Records added meanwhile
+ * don't touch it.
  * 
  * @param instance  - SubGhzHistory instance
  * @param idx       - record index
- * @return SubGhzProtocolCommonLoad*
+ * @return FlipperFormat* or NULL on serialization error
  */
 FlipperFormat* subghz_history_get_raw_data(SubGhzHistory* instance, uint16_t idx);
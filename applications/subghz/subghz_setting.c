@@ -209,7 +209,8 @@ void subghz_setting_load(SubGhzSetting* instance, const char* file_path) {
     FrequenciesList_clear(instance->hopper_frequencies);
 
     Storage* storage = furi_record_open("storage");
-    FlipperFormat* fff_data_file = flipper_format_file_alloc(storage);
+    FlipperFormat* fff_data_file = flipper_format_buffered_file_alloc(storage);
+    flipper_format_set_key_index(fff_data_file, true);
 
     string_t temp_str;
     string_init(temp_str);
@@ -219,7 +220,7 @@ void subghz_setting_load(SubGhzSetting* instance, const char* file_path) {
 
     if(file_path) {
         do {
-            if(!flipper_format_file_open_existing(fff_data_file, file_path)) {
+            if(!flipper_format_buffered_file_open_existing(fff_data_file, file_path)) {
                 FURI_LOG_E(TAG, "Error open file %s", file_path);
                 break;
             }
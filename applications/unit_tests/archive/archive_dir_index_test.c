@@ -0,0 +1,150 @@
+#include <furi.h>
+#include <storage/storage.h>
+#include "../minunit.h"
+#include "archive/helpers/archive_dir_index.h"
+#include "archive/helpers/archive_files.h"
+#include "archive/views/archive_browser_view.h"
+
+#define ARCHIVE_DIR_INDEX_TEST_DIR "/ext/.archive_dir_index_test"
+#define ARCHIVE_DIR_INDEX_TEST_ITEMS 60
+#define ARCHIVE_DIR_INDEX_TEST_EXT ".sub"
+
+static Storage* storage;
+static ArchiveDirIndex* dir_index;
+
+static void archive_dir_index_test_create(const char* name) {
+    string_t path;
+    string_init_printf(path, "%s/%s", ARCHIVE_DIR_INDEX_TEST_DIR, name);
+    File* file = storage_file_alloc(storage);
+    mu_check(storage_file_open(file, string_get_cstr(path), FSAM_WRITE, FSOM_CREATE_ALWAYS));
+    mu_check(storage_file_write(file, name, strlen(name)) == strlen(name));
+    storage_file_free(file);
+    string_clear(path);
+}
+
+static void archive_dir_index_test_setup(void) {
+    storage = furi_record_open("storage");
+    storage_simply_remove_recursive(storage, ARCHIVE_DIR_INDEX_TEST_DIR);
+    mu_check(storage_simply_mkdir(storage, ARCHIVE_DIR_INDEX_TEST_DIR));
+
+    /* Every third item is a folder, the rest are files of two types */
+    string_t name;
+    string_init(name);
+    for(size_t i = 0; i < ARCHIVE_DIR_INDEX_TEST_ITEMS; i++) {
+        if(i % 3 == 0) {
+            string_printf(name, "%s/folder_%u", ARCHIVE_DIR_INDEX_TEST_DIR, i);
+            mu_check(storage_simply_mkdir(storage, string_get_cstr(name)));
+        } else {
+            string_printf(name, "file_%u%s", i, (i % 3 == 1) ? ARCHIVE_DIR_INDEX_TEST_EXT : ".ir");
+            archive_dir_index_test_create(string_get_cstr(name));
+        }
+    }
+    string_printf(name, "%s/assets", ARCHIVE_DIR_INDEX_TEST_DIR);
+    mu_check(storage_simply_mkdir(storage, string_get_cstr(name)));
+    string_clear(name);
+
+    dir_index = archive_dir_index_alloc();
+}
+
+static void archive_dir_index_test_teardown(void) {
+    archive_dir_index_free(dir_index);
+    mu_check(storage_simply_remove_recursive(storage, ARCHIVE_DIR_INDEX_TEST_DIR));
+    furi_record_close("storage");
+}
+
+/* Compare every item with directory read without index, visiting pages out of order */
+static void archive_dir_index_test_check(const char* tab_ext, uint32_t expected_count) {
+    mu_check(archive_dir_index_update(dir_index, ARCHIVE_DIR_INDEX_TEST_DIR, tab_ext));
+    mu_assert_int_eq(expected_count, archive_dir_index_get_count(dir_index));
+
+    string_t* names = malloc(sizeof(string_t) * expected_count);
+    uint8_t* flags = malloc(expected_count);
+    FileInfo file_info;
+    char path[MAX_NAME_LEN];
+    snprintf(path, MAX_NAME_LEN, "%s/", ARCHIVE_DIR_INDEX_TEST_DIR);
+    size_t path_len = strlen(path);
+
+    File* directory = storage_file_alloc(storage);
+    mu_check(storage_dir_open(directory, ARCHIVE_DIR_INDEX_TEST_DIR));
+    uint32_t count = 0;
+    while((count < expected_count) &&
+          archive_dir_read_next(directory, &file_info, path, path_len, tab_ext)) {
+        string_init_set_str(names[count], &path[path_len]);
+        flags[count] = file_info.flags;
+        count++;
+    }
+    mu_check(!archive_dir_read_next(directory, &file_info, path, path_len, tab_ext));
+    storage_dir_close(directory);
+    storage_file_free(directory);
+    mu_assert_int_eq(expected_count, count);
+
+    for(uint32_t i = 0; i < count; i++) {
+        uint32_t idx = (i % 2) ? (count - 1 - i / 2) : (i * 7 % count);
+        const char* name = archive_dir_index_get_item(dir_index, idx, &file_info);
+        mu_check(name != NULL);
+        mu_assert_string_eq(string_get_cstr(names[idx]), name);
+        mu_assert_int_eq(flags[idx], file_info.flags);
+    }
+
+    /* Sequential read, as the browser loads a page */
+    for(uint32_t i = count / 2; i < count; i++) {
+        const char* name = archive_dir_index_get_item(dir_index, i, NULL);
+        mu_check(name != NULL);
+        mu_assert_string_eq(string_get_cstr(names[i]), name);
+    }
+
+    for(uint32_t i = 0; i < count; i++) {
+        string_clear(names[i]);
+    }
+    free(names);
+    free(flags);
+}
+
+MU_TEST(archive_dir_index_test_paging) {
+    archive_dir_index_test_check("*", ARCHIVE_DIR_INDEX_TEST_ITEMS + 1);
+}
+
+MU_TEST(archive_dir_index_test_filter) {
+    /* Files of tab type and folders, except assets */
+    archive_dir_index_test_check(ARCHIVE_DIR_INDEX_TEST_EXT, ARCHIVE_DIR_INDEX_TEST_ITEMS * 2 / 3);
+
+    /* Only item name is matched, index file is hidden */
+    FileInfo file_info = {.flags = 0};
+    mu_check(archive_filter_by_extension(&file_info, ".sub", "/ext/subghz/test.sub"));
+    mu_check(archive_filter_by_extension(&file_info, ".sub", "test.sub"));
+    mu_check(!archive_filter_by_extension(&file_info, ".sub", "/ext/dir.sub/test.ir"));
+    mu_check(!archive_filter_by_extension(&file_info, "*", ARCHIVE_DIR_INDEX_PATH));
+    file_info.flags = FSF_DIRECTORY;
+    mu_check(!archive_filter_by_extension(&file_info, ".sub", "/ext/assets"));
+    mu_check(archive_filter_by_extension(&file_info, ".sub", "/ext/assets/folder"));
+}
+
+MU_TEST(archive_dir_index_test_invalidate) {
+    const uint32_t count = ARCHIVE_DIR_INDEX_TEST_ITEMS * 2 / 3;
+    archive_dir_index_test_check(ARCHIVE_DIR_INDEX_TEST_EXT, count);
+
+    archive_dir_index_test_create("new" ARCHIVE_DIR_INDEX_TEST_EXT);
+    archive_dir_index_test_check(ARCHIVE_DIR_INDEX_TEST_EXT, count + 1);
+
+    mu_assert_int_eq(
+        FSE_OK,
+        storage_common_remove(
+            storage, ARCHIVE_DIR_INDEX_TEST_DIR "/new" ARCHIVE_DIR_INDEX_TEST_EXT));
+    archive_dir_index_test_check(ARCHIVE_DIR_INDEX_TEST_EXT, count);
+
+    mu_check(storage_simply_mkdir(storage, ARCHIVE_DIR_INDEX_TEST_DIR "/new_folder"));
+    archive_dir_index_test_check(ARCHIVE_DIR_INDEX_TEST_EXT, count + 1);
+}
+
+MU_TEST_SUITE(archive_dir_index) {
+    MU_SUITE_CONFIGURE(&archive_dir_index_test_setup, &archive_dir_index_test_teardown);
+
+    MU_RUN_TEST(archive_dir_index_test_paging);
+    MU_RUN_TEST(archive_dir_index_test_filter);
+    MU_RUN_TEST(archive_dir_index_test_invalidate);
+}
+
+int run_minunit_test_archive_dir_index() {
+    MU_RUN_SUITE(archive_dir_index);
+    return MU_EXIT_CODE;
+}
@@ -34,6 +34,9 @@ static const char* test_hex_key = "Hex data";
 static const uint8_t test_hex_data[] = {0xDE, 0xAD, 0xBE};
 static const uint8_t test_hex_updated_data[] = {0xFE, 0xCA};
 
+// repeated keys, more than the distinct key names an index can hold
+#define TEST_MULTIKEY_COUNT 300
+
 #define READ_TEST_NIX "ff_nix.test"
 static const char* test_data_nix = "Filetype: Flipper File test\n"
                                    "Version: 666\n"
@@ -97,19 +100,15 @@ static void tests_teardown() {
     furi_record_close("storage");
 }
 
-static bool test_read(const char* file_name) {
-    Storage* storage = furi_record_open("storage");
+static bool test_read_opened(FlipperFormat* file) {
     bool result = false;
 
-    FlipperFormat* file = flipper_format_file_alloc(storage);
     string_t string_value;
     string_init(string_value);
     uint32_t uint32_value;
     void* scratchpad = malloc(512);
 
     do {
-        if(!flipper_format_file_open_existing(file, file_name)) break;
-
         if(!flipper_format_read_header(file, string_value, &uint32_value)) break;
         if(string_cmp_str(string_value, test_filetype) != 0) break;
         if(uint32_value != test_version) break;
@@ -152,8 +151,29 @@ static bool test_read(const char* file_name) {
     free(scratchpad);
     string_clear(string_value);
 
+    return result;
+}
+
+static bool test_read(const char* file_name) {
+    Storage* storage = furi_record_open("storage");
+    FlipperFormat* file = flipper_format_file_alloc(storage);
+
+    bool result = flipper_format_file_open_existing(file, file_name) && test_read_opened(file);
+
     flipper_format_free(file);
+    furi_record_close("storage");
+
+    return result;
+}
+
+static bool test_read_buffered(const char* file_name) {
+    Storage* storage = furi_record_open("storage");
+    FlipperFormat* file = flipper_format_buffered_file_alloc(storage);
+
+    bool result = flipper_format_buffered_file_open_existing(file, file_name) &&
+                  test_read_opened(file);
 
+    flipper_format_free(file);
     furi_record_close("storage");
 
     return result;
@@ -369,6 +389,76 @@ static bool test_update_backward(const char* file_name) {
     return result;
 }
 
+static bool test_update_transaction(const char* file_name, bool updated) {
+    Storage* storage = furi_record_open("storage");
+    bool result = false;
+    FlipperFormat* file = flipper_format_file_alloc(storage);
+
+    const char* string_data = updated ? test_string_updated_data : test_string_data;
+    const int32_t* int_data = updated ? test_int_updated_data : test_int_data;
+    uint16_t int_count = updated ? COUNT_OF(test_int_updated_data) : COUNT_OF(test_int_data);
+    const uint8_t* hex_data = updated ? test_hex_updated_data : test_hex_data;
+    uint16_t hex_count = updated ? COUNT_OF(test_hex_updated_data) : COUNT_OF(test_hex_data);
+
+    do {
+        if(!flipper_format_file_open_existing(file, file_name)) break;
+
+        // missing key is rejected when queued, the rest is applied on commit
+        flipper_format_transaction_begin(file);
+        if(!flipper_format_update_string_cstr(file, test_string_key, string_data)) break;
+        if(flipper_format_update_string_cstr(file, "Missing key", string_data)) break;
+        if(!flipper_format_update_hex(file, test_hex_key, hex_data, hex_count)) break;
+        if(!flipper_format_update_int32(file, test_int_key, int_data, int_count)) break;
+        if(!flipper_format_transaction_commit(file)) break;
+
+        result = true;
+    } while(false);
+
+    flipper_format_free(file);
+    furi_record_close("storage");
+
+    return result;
+}
+
+static bool test_read_transaction(const char* file_name, bool updated) {
+    Storage* storage = furi_record_open("storage");
+    bool result = false;
+    FlipperFormat* file = flipper_format_file_alloc(storage);
+    string_t string_value;
+    string_init(string_value);
+    int32_t int_value[COUNT_OF(test_int_data)];
+    uint8_t hex_value[COUNT_OF(test_hex_data)];
+    uint32_t uint32_value;
+
+    const char* string_data = updated ? test_string_updated_data : test_string_data;
+    const int32_t* int_data = updated ? test_int_updated_data : test_int_data;
+    uint16_t int_count = updated ? COUNT_OF(test_int_updated_data) : COUNT_OF(test_int_data);
+    const uint8_t* hex_data = updated ? test_hex_updated_data : test_hex_data;
+    uint16_t hex_count = updated ? COUNT_OF(test_hex_updated_data) : COUNT_OF(test_hex_data);
+
+    do {
+        if(!flipper_format_file_open_existing(file, file_name)) break;
+        if(!flipper_format_read_string(file, test_string_key, string_value)) break;
+        if(string_cmp_str(string_value, string_data) != 0) break;
+        if(!flipper_format_get_value_count(file, test_int_key, &uint32_value)) break;
+        if(uint32_value != int_count) break;
+        if(!flipper_format_read_int32(file, test_int_key, int_value, int_count)) break;
+        if(memcmp(int_value, int_data, sizeof(int32_t) * int_count) != 0) break;
+        if(!flipper_format_get_value_count(file, test_hex_key, &uint32_value)) break;
+        if(uint32_value != hex_count) break;
+        if(!flipper_format_read_hex(file, test_hex_key, hex_value, hex_count)) break;
+        if(memcmp(hex_value, hex_data, hex_count) != 0) break;
+
+        result = true;
+    } while(false);
+
+    string_clear(string_value);
+    flipper_format_free(file);
+    furi_record_close("storage");
+
+    return result;
+}
+
 static bool test_write_multikey(const char* file_name) {
     Storage* storage = furi_record_open("storage");
     bool result = false;
@@ -379,8 +469,9 @@ static bool test_write_multikey(const char* file_name) {
         if(!flipper_format_write_header_cstr(file, test_filetype, test_version)) break;
 
         bool error = false;
-        for(uint8_t index = 0; index < 100; index++) {
-            if(!flipper_format_write_hex(file, test_hex_key, &index, 1)) {
+        for(uint16_t index = 0; index < TEST_MULTIKEY_COUNT; index++) {
+            uint8_t uint8_value = index;
+            if(!flipper_format_write_hex(file, test_hex_key, &uint8_value, 1)) {
                 error = true;
                 break;
             }
@@ -396,10 +487,11 @@ static bool test_write_multikey(const char* file_name) {
     return result;
 }
 
-static bool test_read_multikey(const char* file_name) {
+static bool test_read_multikey(const char* file_name, bool indexed) {
     Storage* storage = furi_record_open("storage");
     bool result = false;
     FlipperFormat* file = flipper_format_file_alloc(storage);
+    flipper_format_set_key_index(file, indexed);
 
     string_t string_value;
     string_init(string_value);
@@ -413,13 +505,13 @@ static bool test_read_multikey(const char* file_name) {
 
         bool error = false;
         uint8_t uint8_value;
-        for(uint8_t index = 0; index < 100; index++) {
+        for(uint16_t index = 0; index < TEST_MULTIKEY_COUNT; index++) {
             if(!flipper_format_read_hex(file, test_hex_key, &uint8_value, 1)) {
                 error = true;
                 break;
             }
 
-            if(uint8_value != index) {
+            if(uint8_value != (uint8_t)index) {
                 error = true;
                 break;
             }
@@ -437,6 +529,58 @@ static bool test_read_multikey(const char* file_name) {
     return result;
 }
 
+static bool test_read_indexed(const char* file_name) {
+    Storage* storage = furi_record_open("storage");
+    bool result = false;
+
+    FlipperFormat* file = flipper_format_file_alloc(storage);
+    flipper_format_set_key_index(file, true);
+    string_t string_value;
+    string_init(string_value);
+    uint32_t uint32_value;
+    uint8_t hex_value[COUNT_OF(test_hex_data)];
+
+    do {
+        if(!flipper_format_file_open_existing(file, file_name)) break;
+
+        // last key first, then rewind for the first one
+        if(!flipper_format_read_hex(file, test_hex_key, hex_value, COUNT_OF(hex_value))) break;
+        if(memcmp(hex_value, test_hex_data, sizeof(hex_value)) != 0) break;
+        if(!flipper_format_rewind(file)) break;
+        if(!flipper_format_read_string(file, test_string_key, string_value)) break;
+        if(string_cmp_str(string_value, test_string_data) != 0) break;
+
+        // keys behind the current position are not visible
+        if(flipper_format_read_string(file, test_string_key, string_value)) break;
+        if(!flipper_format_rewind(file)) break;
+
+        if(!flipper_format_key_exist(file, test_uint_key)) break;
+        if(flipper_format_key_exist(file, "Missing key")) break;
+        if(!flipper_format_get_value_count(file, test_uint_key, &uint32_value)) break;
+        if(uint32_value != COUNT_OF(test_uint_data)) break;
+        if(!flipper_format_read_string(file, test_string_key, string_value)) break;
+
+        // index must follow the modified file
+        if(!flipper_format_update_string_cstr(file, test_string_key, test_string_updated_data))
+            break;
+        if(!flipper_format_rewind(file)) break;
+        if(!flipper_format_read_string(file, test_string_key, string_value)) break;
+        if(string_cmp_str(string_value, test_string_updated_data) != 0) break;
+        if(!flipper_format_read_hex(file, test_hex_key, hex_value, COUNT_OF(hex_value))) break;
+        if(memcmp(hex_value, test_hex_data, sizeof(hex_value)) != 0) break;
+        if(!flipper_format_update_string_cstr(file, test_string_key, test_string_data)) break;
+
+        result = true;
+    } while(false);
+
+    string_clear(string_value);
+
+    flipper_format_free(file);
+    furi_record_close("storage");
+
+    return result;
+}
+
 MU_TEST(flipper_format_write_test) {
     mu_assert(storage_write_string(test_file_linux, test_data_nix), "Write test error [Linux]");
     mu_assert(
@@ -450,6 +594,12 @@ MU_TEST(flipper_format_read_test) {
     mu_assert(test_read(test_file_flipper), "Read test error [Flipper]");
 }
 
+MU_TEST(flipper_format_buffered_read_test) {
+    mu_assert(test_read_buffered(test_file_linux), "Buffered read test error [Linux]");
+    mu_assert(test_read_buffered(test_file_windows), "Buffered read test error [Windows]");
+    mu_assert(test_read_buffered(test_file_flipper), "Buffered read test error [Flipper]");
+}
+
 MU_TEST(flipper_format_delete_test) {
     mu_assert(test_delete_last_key(test_file_linux), "Cannot delete key [Linux]");
     mu_assert(test_delete_last_key(test_file_windows), "Cannot delete key [Windows]");
@@ -500,13 +650,35 @@ MU_TEST(flipper_format_update_2_result_test) {
 
 MU_TEST(flipper_format_multikey_test) {
     mu_assert(test_write_multikey(TEST_DIR "ff_multiline.test"), "Multikey write test error");
-    mu_assert(test_read_multikey(TEST_DIR "ff_multiline.test"), "Multikey read test error");
+    mu_assert(
+        test_read_multikey(TEST_DIR "ff_multiline.test", false), "Multikey read test error");
+    mu_assert(
+        test_read_multikey(TEST_DIR "ff_multiline.test", true),
+        "Multikey indexed read test error");
+}
+
+MU_TEST(flipper_format_transaction_test) {
+    const char* files[] = {test_file_linux, test_file_windows, test_file_flipper};
+    for(size_t i = 0; i < COUNT_OF(files); i++) {
+        mu_assert(test_update_transaction(files[i], true), "Cannot commit transaction #1");
+        mu_assert(test_read_transaction(files[i], true), "Transaction #1 applied incorrectly");
+        mu_assert(test_update_transaction(files[i], false), "Cannot commit transaction #2");
+        mu_assert(test_read(files[i]), "Transaction #2 applied incorrectly");
+    }
+}
+
+MU_TEST(flipper_format_index_test) {
+    mu_assert(test_read_indexed(test_file_linux), "Indexed read test error [Linux]");
+    mu_assert(test_read_indexed(test_file_windows), "Indexed read test error [Windows]");
+    mu_assert(test_read_indexed(test_file_flipper), "Indexed read test error [Flipper]");
+    mu_assert(test_read(test_file_flipper), "Indexed update test error [Flipper]");
 }
 
 MU_TEST_SUITE(flipper_format) {
     tests_setup();
     MU_RUN_TEST(flipper_format_write_test);
     MU_RUN_TEST(flipper_format_read_test);
+    MU_RUN_TEST(flipper_format_buffered_read_test);
     MU_RUN_TEST(flipper_format_delete_test);
     MU_RUN_TEST(flipper_format_delete_result_test);
     MU_RUN_TEST(flipper_format_append_test);
@@ -516,6 +688,8 @@ MU_TEST_SUITE(flipper_format) {
     MU_RUN_TEST(flipper_format_update_2_test);
     MU_RUN_TEST(flipper_format_update_2_result_test);
     MU_RUN_TEST(flipper_format_multikey_test);
+    MU_RUN_TEST(flipper_format_index_test);
+    MU_RUN_TEST(flipper_format_transaction_test);
     tests_teardown();
 }
 
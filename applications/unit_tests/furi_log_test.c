@@ -0,0 +1,120 @@
+#include <stdio.h>
+#include <string.h>
+#include <furi.h>
+#include <furi_hal.h>
+#include "minunit.h"
+
+#define TEST_LOG_TIMEOUT 1000
+
+static string_t test_log_output;
+static osSemaphoreId_t test_log_semaphore;
+
+static void test_log_puts(const char* data) {
+    string_cat_str(test_log_output, data);
+    if(strchr(data, '\n')) {
+        osSemaphoreRelease(test_log_semaphore);
+    }
+}
+
+static uint32_t test_log_timestamp() {
+    return 42;
+}
+
+static void test_log_expect(const char* expected) {
+    mu_check(osSemaphoreAcquire(test_log_semaphore, TEST_LOG_TIMEOUT) == osOK);
+    mu_assert(strstr(string_get_cstr(test_log_output), expected), "unexpected log output");
+    string_reset(test_log_output);
+}
+
+void test_furi_log_deferred() {
+    bool deferred = furi_log_is_deferred();
+    FuriLogLevel level = furi_log_get_level();
+
+    string_init(test_log_output);
+    test_log_semaphore = osSemaphoreNew(UINT32_MAX, 0, NULL);
+    // Keep other threads quiet
+    furi_log_set_level(FuriLogLevelError);
+    furi_log_set_puts(test_log_puts);
+    furi_log_set_timestamp(test_log_timestamp);
+    furi_log_set_deferred(true);
+
+    // arguments are packed by value and formatted later
+    char string[] = "volatile";
+    furi_log_print(FuriLogLevelError, "int %d str %s hex %08lX %%\r\n", -5, string, 0xABCDUL);
+    strcpy(string, "changed");
+    test_log_expect("42 int -5 str volatile hex 0000ABCD %\r\n");
+
+    // star width and precision
+    furi_log_print(FuriLogLevelError, "[%*d][%.*s]\r\n", 4, 7, 3, "abcdef");
+    test_log_expect("42 [   7][abc]\r\n");
+
+    // long strings are truncated
+    furi_log_print(FuriLogLevelError, "%s\r\n", "0123456789abcdefghij");
+    test_log_expect("42 0123456789abcde\r\n");
+
+    // filtered by level
+    furi_log_print(FuriLogLevelDebug, "hidden\r\n");
+    furi_log_print(FuriLogLevelError, "shown\r\n");
+    mu_check(osSemaphoreAcquire(test_log_semaphore, TEST_LOG_TIMEOUT) == osOK);
+    mu_check(strstr(string_get_cstr(test_log_output), "42 shown\r\n"));
+    mu_check(!strstr(string_get_cstr(test_log_output), "hidden"));
+    string_reset(test_log_output);
+
+    furi_log_set_deferred(deferred);
+    furi_log_set_timestamp(furi_hal_get_tick);
+    furi_log_set_puts(furi_hal_console_puts);
+    furi_log_set_level(level);
+    osSemaphoreDelete(test_log_semaphore);
+    string_clear(test_log_output);
+}
+
+static uint8_t test_log_frame[64];
+static size_t test_log_frame_size;
+
+static void test_log_trace_write(const uint8_t* data, size_t size) {
+    if(size <= sizeof(test_log_frame)) {
+        memcpy(test_log_frame, data, size);
+        test_log_frame_size = size;
+    }
+    osSemaphoreRelease(test_log_semaphore);
+}
+
+void test_furi_log_trace() {
+    FuriLogLevel level = furi_log_get_level();
+    static const char format[] = "trace %d %s\r\n";
+
+    test_log_semaphore = osSemaphoreNew(UINT32_MAX, 0, NULL);
+    furi_log_set_level(FuriLogLevelError);
+    furi_log_set_timestamp(test_log_timestamp);
+    furi_log_set_trace(test_log_trace_write);
+
+    furi_log_print(FuriLogLevelError, format, 7, "ab");
+    mu_check(osSemaphoreAcquire(test_log_semaphore, TEST_LOG_TIMEOUT) == osOK);
+
+    // sync, length, token, timestamp, int, "ab\0", checksum
+    const size_t args_size = sizeof(int32_t) + 3;
+    mu_assert_int_eq(2 + 8 + args_size + 1, test_log_frame_size);
+    mu_assert_int_eq(0xA5, test_log_frame[0]);
+    mu_assert_int_eq(8 + args_size, test_log_frame[1]);
+
+    uint32_t token, timestamp;
+    int32_t value;
+    memcpy(&token, &test_log_frame[2], sizeof(token));
+    memcpy(&timestamp, &test_log_frame[6], sizeof(timestamp));
+    memcpy(&value, &test_log_frame[10], sizeof(value));
+    mu_check(token == (uint32_t)format);
+    mu_assert_int_eq(42, timestamp);
+    mu_assert_int_eq(7, value);
+    mu_assert_string_eq("ab", (const char*)&test_log_frame[14]);
+
+    uint8_t checksum = 0;
+    for(size_t i = 1; i < test_log_frame_size - 1; i++) {
+        checksum ^= test_log_frame[i];
+    }
+    mu_assert_int_eq(checksum, test_log_frame[test_log_frame_size - 1]);
+
+    furi_log_set_trace(NULL);
+    furi_log_set_timestamp(furi_hal_get_tick);
+    furi_log_set_level(level);
+    osSemaphoreDelete(test_log_semaphore);
+}
@@ -0,0 +1,58 @@
+#include <stdio.h>
+#include <string.h>
+#include <furi.h>
+#include "minunit.h"
+
+#define TEST_PROFILE_ALLOCATIONS 16
+
+static void* __attribute__((noinline)) test_memmgr_heap_profile_alloc(size_t size) {
+    return malloc(size);
+}
+
+void test_furi_memmgr_heap_profile() {
+    void* blocks[TEST_PROFILE_ALLOCATIONS];
+    MemmgrHeapProfile* profile = malloc(sizeof(MemmgrHeapProfile));
+
+    memmgr_heap_profile_start(1);
+    for(size_t i = 0; i < TEST_PROFILE_ALLOCATIONS; i++) {
+        blocks[i] = test_memmgr_heap_profile_alloc(100);
+    }
+    for(size_t i = 0; i < TEST_PROFILE_ALLOCATIONS; i += 2) {
+        free(blocks[i]);
+    }
+    memmgr_heap_profile_stop();
+    memmgr_heap_profile_get(profile);
+
+    mu_check(!profile->enabled);
+    mu_assert_int_eq(1, profile->sample_rate);
+    mu_check(profile->allocations >= TEST_PROFILE_ALLOCATIONS);
+    mu_check(profile->frees >= TEST_PROFILE_ALLOCATIONS / 2);
+    // 100 bytes and header go to 128 bytes class
+    mu_check(profile->size_class_allocations[4] >= TEST_PROFILE_ALLOCATIONS);
+    mu_check(profile->size_class_live[4] >= TEST_PROFILE_ALLOCATIONS / 2);
+    mu_check(profile->used_peak > 0);
+    mu_check(profile->max_free_block <= profile->free);
+    mu_check(profile->fragmentation <= 100);
+
+    // every allocation was sampled from the same call site and thread
+    bool found = false;
+    for(size_t i = 0; i < MEMMGR_HEAP_PROFILE_CALLERS; i++) {
+        MemmgrHeapProfileCaller* caller = &profile->callers[i];
+        if(caller->count >= TEST_PROFILE_ALLOCATIONS &&
+           caller->bytes >= TEST_PROFILE_ALLOCATIONS * 100 &&
+           caller->thread_id == (uint32_t)osThreadGetId()) {
+            found = true;
+        }
+    }
+    mu_check(found);
+
+    // profile is frozen after stop
+    uint32_t allocations = profile->allocations;
+    for(size_t i = 1; i < TEST_PROFILE_ALLOCATIONS; i += 2) {
+        free(blocks[i]);
+    }
+    memmgr_heap_profile_get(profile);
+    mu_assert_int_eq(allocations, profile->allocations);
+
+    free(profile);
+}
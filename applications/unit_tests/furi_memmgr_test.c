@@ -1,5 +1,6 @@
 #include "minunit.h"
 #include <stdlib.h>
+#include <stdint.h>
 #include <string.h>
 #include <stdbool.h>
 
@@ -10,6 +11,9 @@
 // we also test that we are linking against stdlib
 extern size_t memmgr_get_free_heap(void);
 extern size_t memmgr_get_minimum_free_heap(void);
+extern void memmgr_heap_set_pool_enabled(bool enabled);
+extern bool memmgr_heap_is_pool_block(const void* pointer);
+extern uint32_t furi_hal_get_tick(void);
 
 // current heap managment realization consume:
 // X bytes after allocate and 0 bytes after allocate and free,
@@ -35,7 +39,8 @@ bool heap_equal(size_t heap_size, size_t heap_size_old) {
 void test_furi_memmgr() {
     size_t heap_size = 0;
     size_t heap_size_old = 0;
-    const int alloc_size = 128;
+    // bigger than small object pools, so heap size accounting is tested
+    const int alloc_size = 256;
 
     void* ptr = NULL;
     void* original_ptr = NULL;
@@ -98,3 +103,121 @@ void test_furi_memmgr() {
     free(original_ptr);
     free(ptr);
 }
+
+#define POOL_TEST_CLASSES 4
+#define POOL_TEST_OBJECTS 6
+#define POOL_TEST_EXHAUST 256
+#define POOL_BENCH_LIVE 64
+#define POOL_BENCH_ROUNDS 200
+
+static bool pool_test_is_zero(const uint8_t* data, size_t size) {
+    for(size_t i = 0; i < size; i++) {
+        if(data[i]) return false;
+    }
+    return true;
+}
+
+void test_furi_memmgr_pool() {
+    uint8_t* objects[POOL_TEST_OBJECTS];
+
+    for(size_t size_class = 0; size_class < POOL_TEST_CLASSES; size_class++) {
+        const size_t size = 16 << size_class;
+
+        // objects are pooled, aligned, zeroed and do not overlap
+        size_t heap_size_old = memmgr_get_free_heap();
+        for(size_t i = 0; i < POOL_TEST_OBJECTS; i++) {
+            objects[i] = malloc(size - i % 4);
+            mu_assert_pointers_not_eq(objects[i], NULL);
+            mu_check(memmgr_heap_is_pool_block(objects[i]));
+            mu_assert_int_eq(0, (size_t)objects[i] % 8);
+            mu_check(pool_test_is_zero(objects[i], size));
+            memset(objects[i], i + 1, size);
+        }
+        // pooled objects are accounted in free heap, so small leaks are visible
+        mu_assert(
+            heap_equal(memmgr_get_free_heap(), heap_size_old - size * POOL_TEST_OBJECTS),
+            "pool allocation not accounted");
+        for(size_t i = 0; i < POOL_TEST_OBJECTS; i++) {
+            for(size_t j = 0; j < size; j++) {
+                mu_assert_int_eq(i + 1, objects[i][j]);
+            }
+        }
+        for(size_t i = 0; i < POOL_TEST_OBJECTS; i++) {
+            free(objects[i]);
+        }
+        // pools don't take anything from heap
+        mu_assert(heap_equal(memmgr_get_free_heap(), heap_size_old), "pool used heap");
+
+        // freed object comes back zeroed
+        uint8_t* object = malloc(size);
+        mu_check(memmgr_heap_is_pool_block(object));
+        mu_check(pool_test_is_zero(object, size));
+        free(object);
+    }
+
+    // bigger objects go to heap
+    void* ptr = malloc(16 << POOL_TEST_CLASSES);
+    mu_check(!memmgr_heap_is_pool_block(ptr));
+    free(ptr);
+
+    // exhausted pools fall back to heap
+    void** many = malloc(sizeof(void*) * POOL_TEST_EXHAUST);
+    bool fallback = false;
+    for(size_t i = 0; i < POOL_TEST_EXHAUST; i++) {
+        many[i] = malloc(128);
+        mu_assert_pointers_not_eq(many[i], NULL);
+        fallback |= !memmgr_heap_is_pool_block(many[i]);
+    }
+    mu_check(fallback);
+    for(size_t i = 0; i < POOL_TEST_EXHAUST; i++) {
+        free(many[i]);
+    }
+    free(many);
+
+    // pool blocks allocated while pools are enabled are freed to pools
+    ptr = malloc(32);
+    memmgr_heap_set_pool_enabled(false);
+    void* heap_ptr = malloc(32);
+    mu_check(!memmgr_heap_is_pool_block(heap_ptr));
+    free(ptr);
+    free(heap_ptr);
+    memmgr_heap_set_pool_enabled(true);
+}
+
+static uint32_t test_furi_memmgr_pool_bench_run(bool pool) {
+    void* live[POOL_BENCH_LIVE] = {0};
+    void* fence[POOL_BENCH_LIVE] = {0};
+
+    memmgr_heap_set_pool_enabled(pool);
+    // keep heap fragmented: interleave long living blocks with short living ones
+    for(size_t i = 0; i < POOL_BENCH_LIVE; i++) {
+        live[i] = malloc(24);
+        fence[i] = malloc(200);
+    }
+
+    uint32_t start = furi_hal_get_tick();
+    for(size_t round = 0; round < POOL_BENCH_ROUNDS; round++) {
+        for(size_t i = 0; i < POOL_BENCH_LIVE; i++) {
+            free(live[i]);
+            live[i] = malloc(16 + (round + i) % 48);
+        }
+    }
+    uint32_t time = furi_hal_get_tick() - start;
+
+    for(size_t i = 0; i < POOL_BENCH_LIVE; i++) {
+        free(live[i]);
+        free(fence[i]);
+    }
+    memmgr_heap_set_pool_enabled(true);
+    return time;
+}
+
+void test_furi_memmgr_pool_bench() {
+    uint32_t heap_time = test_furi_memmgr_pool_bench_run(false);
+    uint32_t pool_time = test_furi_memmgr_pool_bench_run(true);
+    printf(
+        "%u small alloc/free pairs: heap %lums, pools %lums\r\n",
+        POOL_BENCH_LIVE * POOL_BENCH_ROUNDS,
+        heap_time,
+        pool_time);
+}
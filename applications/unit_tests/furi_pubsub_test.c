@@ -42,4 +42,128 @@ void test_furi_pubsub() {
 
     // delete pubsub case
     furi_pubsub_free(test_pubsub);
-}
\ No newline at end of file
+}
+
+typedef struct {
+    FuriPubSub* pubsub;
+    FuriPubSubSubscription* other;
+    uint32_t calls;
+} TestPubSubReentrant;
+
+static void test_pubsub_unsubscribe_other(const void* arg, void* ctx) {
+    UNUSED(arg);
+    TestPubSubReentrant* context = ctx;
+    context->calls++;
+    if(context->other) {
+        furi_pubsub_unsubscribe(context->pubsub, context->other);
+        context->other = NULL;
+    }
+}
+
+static void test_pubsub_count(const void* arg, void* ctx) {
+    UNUSED(arg);
+    (*(uint32_t*)ctx)++;
+}
+
+void test_furi_pubsub_reentrant() {
+    TestPubSubReentrant context = {.pubsub = furi_pubsub_alloc()};
+    uint32_t other_calls = 0;
+
+    FuriPubSubSubscription* subscription =
+        furi_pubsub_subscribe(context.pubsub, test_pubsub_unsubscribe_other, &context);
+    context.other = furi_pubsub_subscribe(context.pubsub, test_pubsub_count, &other_calls);
+
+    // subscription removed from callback is not called even by publish in progress
+    furi_pubsub_publish(context.pubsub, NULL);
+    mu_assert_int_eq(1, context.calls);
+    mu_assert_int_eq(0, other_calls);
+
+    furi_pubsub_publish(context.pubsub, NULL);
+    mu_assert_int_eq(2, context.calls);
+
+    FuriPubSubStats stats;
+    furi_pubsub_get_stats(context.pubsub, &stats);
+    mu_assert_int_eq(2, stats.publishes);
+    mu_assert_int_eq(1, stats.subscribers);
+
+    furi_pubsub_unsubscribe(context.pubsub, subscription);
+    furi_pubsub_reset_stats(context.pubsub);
+    furi_pubsub_get_stats(context.pubsub, &stats);
+    mu_assert_int_eq(0, stats.publishes);
+    mu_assert_int_eq(0, stats.subscribers);
+
+    furi_pubsub_free(context.pubsub);
+}
+
+typedef struct {
+    FuriPubSub* pubsub;
+    osSemaphoreId_t entered;
+    osSemaphoreId_t release;
+    osSemaphoreId_t done;
+    volatile bool finished;
+} TestPubSubSlow;
+
+static void test_pubsub_slow_handler(const void* arg, void* ctx) {
+    TestPubSubSlow* context = ctx;
+    if(*(const bool*)arg) {
+        osSemaphoreRelease(context->entered);
+        osSemaphoreAcquire(context->release, osWaitForever);
+        context->finished = true;
+    }
+}
+
+static void test_pubsub_slow_publisher(void* ctx) {
+    TestPubSubSlow* context = ctx;
+    const bool block = true;
+    furi_pubsub_publish(context->pubsub, (void*)&block);
+    osSemaphoreRelease(context->done);
+    osThreadExit();
+}
+
+static void test_pubsub_slow_releaser(void* ctx) {
+    TestPubSubSlow* context = ctx;
+    osDelay(10);
+    osSemaphoreRelease(context->release);
+    osThreadExit();
+}
+
+void test_furi_pubsub_slow_subscriber() {
+    TestPubSubSlow context = {
+        .pubsub = furi_pubsub_alloc(),
+        .entered = osSemaphoreNew(1, 0, NULL),
+        .release = osSemaphoreNew(1, 0, NULL),
+        .done = osSemaphoreNew(1, 0, NULL),
+    };
+    FuriPubSubSubscription* slow =
+        furi_pubsub_subscribe(context.pubsub, test_pubsub_slow_handler, &context);
+
+    const osThreadAttr_t attr = {.name = "PubSubTest", .stack_size = 1024};
+    mu_check(osThreadNew(test_pubsub_slow_publisher, &context, &attr));
+    mu_check(osSemaphoreAcquire(context.entered, 1000) == osOK);
+
+    // slow subscriber in other thread doesn't block subscribe and publish
+    uint32_t calls = 0;
+    FuriPubSubSubscription* fast =
+        furi_pubsub_subscribe(context.pubsub, test_pubsub_count, &calls);
+    const bool block = false;
+    furi_pubsub_publish(context.pubsub, (void*)&block);
+    mu_assert_int_eq(1, calls);
+    furi_pubsub_unsubscribe(context.pubsub, fast);
+
+    // unsubscribe of slow subscriber waits for its callback to complete
+    mu_check(osThreadNew(test_pubsub_slow_releaser, &context, &attr));
+    furi_pubsub_unsubscribe(context.pubsub, slow);
+    mu_check(context.finished);
+    mu_check(osSemaphoreAcquire(context.done, 1000) == osOK);
+
+    FuriPubSubStats stats;
+    furi_pubsub_get_stats(context.pubsub, &stats);
+    mu_assert_int_eq(2, stats.publishes);
+    mu_check(stats.max_callback == test_pubsub_slow_handler);
+    mu_check(stats.max_callback_time >= 10000);
+
+    furi_pubsub_free(context.pubsub);
+    osSemaphoreDelete(context.entered);
+    osSemaphoreDelete(context.release);
+    osSemaphoreDelete(context.done);
+}
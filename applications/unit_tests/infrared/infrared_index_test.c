@@ -0,0 +1,177 @@
+#include <furi.h>
+#include <storage/storage.h>
+#include "../minunit.h"
+#include "infrared/helpers/infrared_index.h"
+
+#define INFRARED_INDEX_TEST_FILE "/ext/.infrared_index_test.idx"
+#define INFRARED_INDEX_TEST_TIMINGS 67
+
+static Storage* storage;
+static File* file;
+
+static void infrared_index_test_setup(void) {
+    storage = furi_record_open("storage");
+    file = storage_file_alloc(storage);
+}
+
+static void infrared_index_test_teardown(void) {
+    storage_file_free(file);
+    storage_common_remove(storage, INFRARED_INDEX_TEST_FILE);
+    furi_record_close("storage");
+}
+
+static void infrared_index_test_open(bool write) {
+    if(storage_file_is_open(file)) {
+        storage_file_close(file);
+    }
+    mu_check(storage_file_open(
+        file,
+        INFRARED_INDEX_TEST_FILE,
+        write ? FSAM_WRITE : FSAM_READ,
+        write ? FSOM_CREATE_ALWAYS : FSOM_OPEN_EXISTING));
+}
+
+static void infrared_index_test_write_signal(const InfraredIndexSignal* signal, uint32_t* offset) {
+    if(offset) *offset = storage_file_tell(file);
+    mu_check(infrared_index_write_signal(file, signal));
+}
+
+MU_TEST(infrared_index_test_roundtrip) {
+    uint32_t timings[INFRARED_INDEX_TEST_TIMINGS];
+    for(size_t i = 0; i < COUNT_OF(timings); i++) {
+        timings[i] = 500 + i * 10;
+    }
+    const InfraredIndexSignal raw = {
+        .is_raw = true,
+        .frequency = 38000,
+        .duty_cycle = 0.33f,
+        .timings_cnt = COUNT_OF(timings),
+        .timings = timings,
+    };
+    const InfraredIndexSignal parsed = {
+        .is_raw = false,
+        .message = {.protocol = InfraredProtocolNEC, .address = 0x04, .command = 0x08},
+    };
+    InfraredIndexHeader header = {
+        .magic = 0,
+        .version = INFRARED_INDEX_VERSION,
+        .db_size = 12345,
+        .db_crc = 0xDEADBEEF,
+    };
+
+    infrared_index_test_open(true);
+    mu_check(infrared_index_write_header(file, &header));
+    uint32_t power[2];
+    uint32_t mute[1];
+    infrared_index_test_write_signal(&raw, &power[0]);
+    infrared_index_test_write_signal(&parsed, &mute[0]);
+    infrared_index_test_write_signal(&parsed, &power[1]);
+    header.table_offset = storage_file_tell(file);
+    header.record_count = 2;
+    mu_check(infrared_index_write_record(file, "POWER", power, COUNT_OF(power)));
+    mu_check(infrared_index_write_record(file, "MUTE", mute, COUNT_OF(mute)));
+    header.magic = INFRARED_INDEX_MAGIC;
+    mu_check(infrared_index_write_header(file, &header));
+
+    infrared_index_test_open(false);
+    InfraredIndexHeader read_header;
+    mu_check(infrared_index_read_header(file, &read_header));
+    mu_check(!memcmp(&header, &read_header, sizeof(header)));
+    mu_check(storage_file_seek(file, read_header.table_offset, true));
+
+    char name[INFRARED_INDEX_NAME_SIZE];
+    uint32_t count = 0;
+    uint32_t offsets[2];
+    mu_check(infrared_index_read_record(file, &read_header, name, &count));
+    mu_assert_string_eq("POWER", name);
+    mu_assert_int_eq(COUNT_OF(power), count);
+    mu_check(infrared_index_read_record_offsets(file, &read_header, offsets, count));
+    mu_check(!memcmp(power, offsets, sizeof(power)));
+    mu_check(infrared_index_read_record(file, &read_header, name, &count));
+    mu_assert_string_eq("MUTE", name);
+    mu_assert_int_eq(COUNT_OF(mute), count);
+    mu_check(infrared_index_skip_record_offsets(file, count));
+    mu_assert_int_eq(storage_file_size(file), storage_file_tell(file));
+
+    uint32_t* read_timings = malloc(sizeof(uint32_t) * MAX_TIMINGS_AMOUNT);
+    InfraredIndexSignal signal = {.timings = read_timings};
+    mu_check(storage_file_seek(file, power[0], true));
+    mu_check(infrared_index_read_signal(file, &signal));
+    mu_check(signal.is_raw);
+    mu_assert_int_eq(raw.frequency, signal.frequency);
+    mu_check(raw.duty_cycle == signal.duty_cycle);
+    mu_assert_int_eq(raw.timings_cnt, signal.timings_cnt);
+    mu_check(!memcmp(timings, read_timings, sizeof(timings)));
+
+    mu_check(storage_file_seek(file, power[1], true));
+    mu_check(infrared_index_read_signal(file, &signal));
+    mu_check(!signal.is_raw);
+    mu_assert_int_eq(parsed.message.protocol, signal.message.protocol);
+    mu_assert_int_eq(parsed.message.address, signal.message.address);
+    mu_assert_int_eq(parsed.message.command, signal.message.command);
+    free(read_timings);
+}
+
+MU_TEST(infrared_index_test_corrupted) {
+    const InfraredIndexSignal parsed = {
+        .is_raw = false,
+        .message = {.protocol = InfraredProtocolNEC, .address = 0x04, .command = 0x08},
+    };
+    InfraredIndexHeader header = {
+        .magic = INFRARED_INDEX_MAGIC,
+        .version = INFRARED_INDEX_VERSION,
+        .record_count = 1,
+    };
+    uint32_t offset = 0;
+    char name[INFRARED_INDEX_NAME_SIZE];
+    uint32_t count = 0;
+
+    /* Table past the end of file */
+    header.table_offset = sizeof(header) + 1;
+    infrared_index_test_open(true);
+    mu_check(infrared_index_write_header(file, &header));
+    infrared_index_test_open(false);
+    mu_check(!infrared_index_read_header(file, &header));
+
+    /* Signals count bigger than file */
+    infrared_index_test_open(true);
+    mu_check(infrared_index_write_header(file, &header));
+    infrared_index_test_write_signal(&parsed, &offset);
+    header.table_offset = storage_file_tell(file);
+    mu_check(infrared_index_write_record(file, "POWER", &offset, 1));
+    mu_check(storage_file_seek(file, storage_file_tell(file) - sizeof(uint32_t) * 2, true));
+    count = UINT32_MAX / sizeof(uint32_t);
+    mu_check(storage_file_write(file, &count, sizeof(count)) == sizeof(count));
+    mu_check(infrared_index_write_header(file, &header));
+    infrared_index_test_open(false);
+    mu_check(infrared_index_read_header(file, &header));
+    mu_check(storage_file_seek(file, header.table_offset, true));
+    mu_check(!infrared_index_read_record(file, &header, name, &count));
+
+    /* Signal offset inside of table */
+    infrared_index_test_open(true);
+    mu_check(infrared_index_write_header(file, &header));
+    infrared_index_test_write_signal(&parsed, NULL);
+    header.table_offset = storage_file_tell(file);
+    offset = header.table_offset;
+    mu_check(infrared_index_write_record(file, "POWER", &offset, 1));
+    mu_check(infrared_index_write_header(file, &header));
+    infrared_index_test_open(false);
+    mu_check(infrared_index_read_header(file, &header));
+    mu_check(storage_file_seek(file, header.table_offset, true));
+    mu_check(infrared_index_read_record(file, &header, name, &count));
+    mu_assert_int_eq(1, count);
+    mu_check(!infrared_index_read_record_offsets(file, &header, &offset, count));
+}
+
+MU_TEST_SUITE(infrared_index) {
+    MU_SUITE_CONFIGURE(&infrared_index_test_setup, &infrared_index_test_teardown);
+
+    MU_RUN_TEST(infrared_index_test_roundtrip);
+    MU_RUN_TEST(infrared_index_test_corrupted);
+}
+
+int run_minunit_test_infrared_index() {
+    MU_RUN_SUITE(infrared_index);
+    return MU_EXIT_CODE;
+}
@@ -7,8 +7,15 @@ void test_furi_create_open();
 void test_furi_valuemutex();
 void test_furi_concurrent_access();
 void test_furi_pubsub();
+void test_furi_pubsub_reentrant();
+void test_furi_pubsub_slow_subscriber();
+void test_furi_log_deferred();
+void test_furi_log_trace();
 
 void test_furi_memmgr();
+void test_furi_memmgr_pool();
+void test_furi_memmgr_pool_bench();
+void test_furi_memmgr_heap_profile();
 
 static int foo = 0;
 
@@ -41,12 +48,40 @@ MU_TEST(mu_test_furi_pubsub) {
     test_furi_pubsub();
 }
 
+MU_TEST(mu_test_furi_pubsub_reentrant) {
+    test_furi_pubsub_reentrant();
+}
+
+MU_TEST(mu_test_furi_pubsub_slow_subscriber) {
+    test_furi_pubsub_slow_subscriber();
+}
+
+MU_TEST(mu_test_furi_log_deferred) {
+    test_furi_log_deferred();
+}
+
+MU_TEST(mu_test_furi_log_trace) {
+    test_furi_log_trace();
+}
+
 MU_TEST(mu_test_furi_memmgr) {
     // this test is not accurate, but gives a basic understanding
     // that memory management is working fine
     test_furi_memmgr();
 }
 
+MU_TEST(mu_test_furi_memmgr_pool) {
+    test_furi_memmgr_pool();
+}
+
+MU_TEST(mu_test_furi_memmgr_pool_bench) {
+    test_furi_memmgr_pool_bench();
+}
+
+MU_TEST(mu_test_furi_memmgr_heap_profile) {
+    test_furi_memmgr_heap_profile();
+}
+
 MU_TEST_SUITE(test_suite) {
     MU_SUITE_CONFIGURE(&test_setup, &test_teardown);
 
@@ -57,7 +92,14 @@ MU_TEST_SUITE(test_suite) {
     MU_RUN_TEST(mu_test_furi_valuemutex);
     MU_RUN_TEST(mu_test_furi_concurrent_access);
     MU_RUN_TEST(mu_test_furi_pubsub);
+    MU_RUN_TEST(mu_test_furi_pubsub_reentrant);
+    MU_RUN_TEST(mu_test_furi_pubsub_slow_subscriber);
+    MU_RUN_TEST(mu_test_furi_log_deferred);
+    MU_RUN_TEST(mu_test_furi_log_trace);
     MU_RUN_TEST(mu_test_furi_memmgr);
+    MU_RUN_TEST(mu_test_furi_memmgr_pool);
+    MU_RUN_TEST(mu_test_furi_memmgr_pool_bench);
+    MU_RUN_TEST(mu_test_furi_memmgr_heap_profile);
 }
 
 int run_minunit() {
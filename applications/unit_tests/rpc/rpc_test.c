@@ -5,6 +5,7 @@
 #include "pb_decode.h"
 #include <rpc/rpc.h>
 #include "rpc/rpc_i.h"
+#include "rpc/rpc_gui_frame.h"
 #include "storage.pb.h"
 #include "storage/filesystem_api_defines.h"
 #include "storage/storage.h"
@@ -20,6 +21,8 @@
 #include <loader/loader.h>
 #include <protobuf_version.h>
 #include <semphr.h>
+#include <furi_hal_compress.h>
+#include <gui/gui.h>
 
 LIST_DEF(MsgList, PB_Main, M_POD_OPLIST)
 #define M_OPL_MsgList_t() LIST_OPLIST(MsgList)
@@ -45,7 +48,8 @@ static RpcSessionContext rpc_session[TEST_RPC_SESSIONS];
 #define TAG "UnitTestsRpc"
 #define MAX_RECEIVE_OUTPUT_TIMEOUT 3000
 #define MAX_NAME_LENGTH 255
-#define MAX_DATA_SIZE 512 // have to be exact as in rpc_storage.c
+#define MAX_DATA_SIZE RPC_CHUNK_SIZE_DEFAULT
+#define THROUGHPUT_FILE_SIZE (16 * 1024)
 #define TEST_DIR TEST_DIR_NAME "/"
 #define TEST_DIR_NAME "/ext/unit_tests_tmp"
 #define MD5SUM_SIZE 16
@@ -79,18 +83,19 @@ static void test_rpc_free_msg_list(MsgList_t msg_list);
 static void test_rpc_session_close_callback(void* context);
 static void test_rpc_session_terminated_callback(void* context);
 
-static void test_rpc_setup(void) {
+static void test_rpc_setup_ex(size_t chunk_size) {
     furi_check(!rpc);
     furi_check(!(rpc_session[0].session));
 
     rpc = furi_record_open("rpc");
     for(int i = 0; !(rpc_session[0].session) && (i < 10000); ++i) {
-        rpc_session[0].session = rpc_session_open(rpc);
+        rpc_session[0].session = rpc_session_open_ex(rpc, chunk_size);
         furi_hal_delay_ms(1);
     }
     furi_check(rpc_session[0].session);
 
-    rpc_session[0].output_stream = xStreamBufferCreate(1000, 1);
+    /* has to hold any single response, e.g. list of long names or max chunk */
+    rpc_session[0].output_stream = xStreamBufferCreate(RPC_CHUNK_SIZE_MAX * 2, 1);
     rpc_session_set_send_bytes_callback(rpc_session[0].session, output_bytes_callback);
     rpc_session[0].close_session_semaphore = xSemaphoreCreateBinary();
     rpc_session[0].terminate_semaphore = xSemaphoreCreateBinary();
@@ -100,6 +105,10 @@ static void test_rpc_setup(void) {
     rpc_session_set_context(rpc_session[0].session, &rpc_session[0]);
 }
 
+static void test_rpc_setup(void) {
+    test_rpc_setup_ex(RPC_CHUNK_SIZE_DEFAULT);
+}
+
 static void test_rpc_setup_second_session(void) {
     furi_check(rpc);
     furi_check(!(rpc_session[1].session));
@@ -158,6 +167,14 @@ static void test_rpc_storage_setup(void) {
     furi_record_close("storage");
 }
 
+static void test_rpc_storage_bulk_setup(void) {
+    test_rpc_setup_ex(RPC_CHUNK_SIZE_MAX);
+
+    Storage* fs_api = furi_record_open("storage");
+    clean_directory(fs_api, TEST_DIR_NAME);
+    furi_record_close("storage");
+}
+
 static void test_rpc_storage_teardown(void) {
     test_rpc_teardown();
 
@@ -712,6 +729,7 @@ static void test_rpc_add_read_to_list_by_reading_real_file(
     const char* path,
     uint32_t command_id) {
     furi_check(MsgList_empty_p(msg_list));
+    size_t chunk_size = rpc_session_get_chunk_size(rpc_session[0].session);
     Storage* fs_api = furi_record_open("storage");
     File* file = storage_file_alloc(fs_api);
 
@@ -729,10 +747,10 @@ static void test_rpc_add_read_to_list_by_reading_real_file(
             response->content.storage_read_response.has_file = true;
 
             response->content.storage_read_response.file.data =
-                malloc(PB_BYTES_ARRAY_T_ALLOCSIZE(MIN(size_left, MAX_DATA_SIZE)));
+                malloc(PB_BYTES_ARRAY_T_ALLOCSIZE(MIN(size_left, chunk_size)));
             uint8_t* buffer = response->content.storage_read_response.file.data->bytes;
             uint16_t* read_size_msg = &response->content.storage_read_response.file.data->size;
-            size_t read_size = MIN(size_left, MAX_DATA_SIZE);
+            size_t read_size = MIN(size_left, chunk_size);
             *read_size_msg = storage_file_read(file, buffer, read_size);
             size_left -= read_size;
             result = (*read_size_msg == read_size);
@@ -770,6 +788,65 @@ static void test_storage_read_run(const char* path, uint32_t command_id) {
     test_rpc_free_msg_list(expected_msg_list);
 }
 
+static uint32_t test_rpc_bytes_per_second(size_t size, TickType_t ticks) {
+    return (uint64_t)size * configTICK_RATE_HZ / MAX(ticks, 1);
+}
+
+/* Write and read back file with chunks of negotiated size, report time spent
+ * on transfer only (expected messages are prepared in advance) */
+static void test_storage_throughput_run(const char* path, uint32_t* command_id) {
+    size_t chunk_size = rpc_session_get_chunk_size(rpc_session[0].session);
+    size_t chunk_count = THROUGHPUT_FILE_SIZE / chunk_size;
+    MsgList_t input_msg_list;
+    MsgList_init(input_msg_list);
+    MsgList_t expected_msg_list;
+    MsgList_init(expected_msg_list);
+
+    uint8_t* buf = malloc(chunk_size);
+    for(int i = 0; i < chunk_size; ++i) {
+        buf[i] = 'a' + (i % 26);
+    }
+
+    test_rpc_add_read_or_write_to_list(
+        input_msg_list, WRITE_REQUEST, path, buf, chunk_size, chunk_count, ++*command_id);
+    test_rpc_add_empty_to_list(expected_msg_list, PB_CommandStatus_OK, *command_id);
+
+    TickType_t start = xTaskGetTickCount();
+    test_rpc_encode_and_feed(input_msg_list, 0);
+    test_rpc_decode_and_compare(expected_msg_list, 0);
+    TickType_t write_ticks = xTaskGetTickCount() - start;
+
+    test_rpc_free_msg_list(input_msg_list);
+    test_rpc_free_msg_list(expected_msg_list);
+
+    PB_Main request;
+    MsgList_init(expected_msg_list);
+    test_rpc_add_read_or_write_to_list(
+        expected_msg_list, READ_RESPONSE, path, buf, chunk_size, chunk_count, ++*command_id);
+    test_rpc_create_simple_message(
+        &request, PB_Main_storage_read_request_tag, path, *command_id);
+
+    start = xTaskGetTickCount();
+    test_rpc_encode_and_feed_one(&request, 0);
+    test_rpc_decode_and_compare(expected_msg_list, 0);
+    TickType_t read_ticks = xTaskGetTickCount() - start;
+
+    pb_release(&PB_Main_msg, &request);
+    test_rpc_free_msg_list(expected_msg_list);
+    free(buf);
+
+    size_t size = chunk_size * chunk_count;
+    FURI_LOG_I(
+        TAG,
+        "Chunk %d: write %d bytes in %lu ticks (%lu B/s), read in %lu ticks (%lu B/s)",
+        chunk_size,
+        size,
+        write_ticks,
+        test_rpc_bytes_per_second(size, write_ticks),
+        read_ticks,
+        test_rpc_bytes_per_second(size, read_ticks));
+}
+
 static bool test_is_exists(const char* path) {
     Storage* fs_api = furi_record_open("storage");
     FileInfo fileinfo;
@@ -916,6 +993,23 @@ MU_TEST(test_storage_read) {
     test_storage_read_run(TEST_DIR "file4.txt", ++command_id);
 }
 
+#define TEST_DIR_LONG_NAMES_NAME TEST_DIR "long_names"
+MU_TEST(test_storage_list_long_names) {
+    /* list response gets bigger than initial session transmit buffer */
+    test_create_dir(TEST_DIR_LONG_NAMES_NAME);
+    char* name = malloc(strlen(TEST_DIR_LONG_NAMES_NAME) + 1 + 200 + 1);
+    for(int i = 0; i < 10; ++i) {
+        int length = sprintf(name, "%s/%d", TEST_DIR_LONG_NAMES_NAME, i);
+        memset(name + length, 'x', 200 - 1);
+        name[length + 200 - 1] = '\0';
+        test_create_file(name, i);
+    }
+    free(name);
+
+    test_rpc_storage_list_run(TEST_DIR_LONG_NAMES_NAME, ++command_id);
+    test_rpc_storage_list_run(TEST_DIR_LONG_NAMES_NAME, ++command_id);
+}
+
 static void test_storage_write_run(
     const char* path,
     size_t write_size,
@@ -987,6 +1081,29 @@ MU_TEST(test_storage_write_read) {
     test_storage_write_read_run(TEST_DIR "test3.txt", pattern1, 0, 1, &command_id);
 }
 
+MU_TEST(test_storage_throughput) {
+    test_storage_throughput_run(TEST_DIR "throughput.bin", &command_id);
+}
+
+MU_TEST(test_storage_bulk_read) {
+    test_create_file(TEST_DIR "file1.txt", RPC_CHUNK_SIZE_MAX - 1);
+    test_create_file(TEST_DIR "file2.txt", RPC_CHUNK_SIZE_MAX);
+    test_create_file(TEST_DIR "file3.txt", (RPC_CHUNK_SIZE_MAX * 3) + 1);
+
+    test_storage_read_run(TEST_DIR "file1.txt", ++command_id);
+    test_storage_read_run(TEST_DIR "file2.txt", ++command_id);
+    test_storage_read_run(TEST_DIR "file3.txt", ++command_id);
+}
+
+MU_TEST(test_storage_bulk_write) {
+    test_storage_write_run(
+        TEST_DIR "test1.txt", RPC_CHUNK_SIZE_MAX, 1, ++command_id, PB_CommandStatus_OK);
+    /* several chunks are fed back-to-back, only last one is answered */
+    test_storage_write_run(
+        TEST_DIR "test2.txt", RPC_CHUNK_SIZE_MAX, 4, ++command_id, PB_CommandStatus_OK);
+    test_storage_write_run(TEST_DIR "test3.txt", 100, 3, ++command_id, PB_CommandStatus_OK);
+}
+
 MU_TEST(test_storage_write) {
     test_storage_write_run(
         TEST_DIR "afaefo/aefaef/aef/aef/test1.txt",
@@ -1427,6 +1544,7 @@ MU_TEST_SUITE(test_rpc_storage) {
     MU_RUN_TEST(test_storage_stat);
     MU_RUN_TEST(test_storage_list);
     MU_RUN_TEST(test_storage_read);
+    MU_RUN_TEST(test_storage_list_long_names);
     MU_RUN_TEST(test_storage_write_read);
     MU_RUN_TEST(test_storage_write);
     MU_RUN_TEST(test_storage_delete);
@@ -1437,6 +1555,15 @@ MU_TEST_SUITE(test_rpc_storage) {
 
     DISABLE_TEST(MU_RUN_TEST(test_storage_interrupt_continuous_same_system););
     MU_RUN_TEST(test_storage_interrupt_continuous_another_system);
+    MU_RUN_TEST(test_storage_throughput);
+}
+
+MU_TEST_SUITE(test_rpc_storage_bulk) {
+    MU_SUITE_CONFIGURE(&test_rpc_storage_bulk_setup, &test_rpc_storage_teardown);
+
+    MU_RUN_TEST(test_storage_bulk_read);
+    MU_RUN_TEST(test_storage_bulk_write);
+    MU_RUN_TEST(test_storage_throughput);
 }
 
 static void test_app_create_request(
@@ -1767,17 +1894,258 @@ MU_TEST_SUITE(test_rpc_session) {
     furi_record_close("storage");
 }
 
+#define TEST_GUI_FRAME_SIZE (128 * 64 / 8)
+#define TEST_GUI_FRAME_MAP_SIZE RPC_GUI_FRAME_MAP_SIZE(TEST_GUI_FRAME_SIZE)
+
+/* Client side of rpc_gui_frame.h format, applies encoded frame to frame */
+static void test_rpc_gui_frame_decode(
+    uint8_t* frame,
+    uint8_t* data,
+    size_t data_size,
+    FuriHalCompress* compress,
+    uint8_t* buffer) {
+    uint8_t flags = data[0];
+    uint8_t* payload = &data[1];
+    size_t payload_size = data_size - 1;
+
+    if(flags & RpcGuiFrameFlagCompressed) {
+        mu_check(furi_hal_compress_decode(
+            compress,
+            payload,
+            payload_size,
+            buffer,
+            TEST_GUI_FRAME_MAP_SIZE + TEST_GUI_FRAME_SIZE,
+            &payload_size));
+        payload = buffer;
+    }
+
+    if(flags & RpcGuiFrameFlagDelta) {
+        size_t offset = TEST_GUI_FRAME_MAP_SIZE;
+        for(size_t tile = 0; tile < TEST_GUI_FRAME_SIZE / RPC_GUI_FRAME_TILE_SIZE; tile++) {
+            if(payload[tile / 8] & (1 << (tile % 8))) {
+                for(size_t i = 0; i < RPC_GUI_FRAME_TILE_SIZE; i++) {
+                    frame[tile * RPC_GUI_FRAME_TILE_SIZE + i] ^= payload[offset++];
+                }
+            }
+        }
+        mu_assert_int_eq(offset, payload_size);
+    } else {
+        mu_assert_int_eq(TEST_GUI_FRAME_SIZE, payload_size);
+        memcpy(frame, payload, TEST_GUI_FRAME_SIZE);
+    }
+}
+
+/* Encode frame, check its flags and that client gets the same frame */
+static void test_rpc_gui_frame_check(
+    RpcGuiFrameEncoder* encoder,
+    const uint8_t* frame,
+    uint8_t* client_frame,
+    uint8_t expected_flags,
+    uint8_t flags_mask,
+    size_t* data_size) {
+    const size_t data_max = RPC_GUI_FRAME_SIZE_MAX(TEST_GUI_FRAME_SIZE);
+    uint8_t* data = malloc(data_max);
+    uint8_t* buffer = malloc(TEST_GUI_FRAME_MAP_SIZE + TEST_GUI_FRAME_SIZE);
+    FuriHalCompress* compress = furi_hal_compress_alloc(TEST_GUI_FRAME_SIZE);
+    bool encoded = rpc_gui_frame_encode(encoder, frame, data, data_size);
+
+    if(encoded && (*data_size <= data_max)) {
+        test_rpc_gui_frame_decode(client_frame, data, *data_size, compress, buffer);
+    }
+    uint8_t flags = data[0];
+
+    furi_hal_compress_free(compress);
+    free(buffer);
+    free(data);
+
+    mu_check(encoded);
+    mu_check(*data_size <= data_max);
+    mu_assert_int_eq(expected_flags, flags & flags_mask);
+    mu_check(!memcmp(frame, client_frame, TEST_GUI_FRAME_SIZE));
+}
+
+static void test_rpc_gui_frame_run(bool compress) {
+    RpcGuiFrameEncoder* encoder = rpc_gui_frame_encoder_alloc(TEST_GUI_FRAME_SIZE, compress);
+    uint8_t* frame = malloc(TEST_GUI_FRAME_SIZE);
+    uint8_t* client_frame = malloc(TEST_GUI_FRAME_SIZE);
+    uint8_t* data = malloc(RPC_GUI_FRAME_SIZE_MAX(TEST_GUI_FRAME_SIZE));
+    const uint8_t delta = RpcGuiFrameFlagDelta;
+    const uint8_t all = RpcGuiFrameFlagDelta | RpcGuiFrameFlagCompressed;
+    size_t data_size = 0;
+
+    // First frame is a keyframe
+    for(size_t i = 0; i < TEST_GUI_FRAME_SIZE; i++) {
+        frame[i] = (i * 7) ^ (i >> 3);
+    }
+    test_rpc_gui_frame_check(encoder, frame, client_frame, 0, delta, &data_size);
+
+    // Unchanged frame is not sent
+    bool encoded = rpc_gui_frame_encode(encoder, frame, data, &data_size);
+
+    // One changed tile: bitmap and one tile
+    frame[100] ^= 0xFF;
+    test_rpc_gui_frame_check(encoder, frame, client_frame, delta, delta, &data_size);
+    size_t tile_delta_size = data_size;
+
+    // Delta bigger than frame is sent as keyframe
+    for(size_t i = 0; i < TEST_GUI_FRAME_SIZE; i++) {
+        frame[i] = ~frame[i];
+    }
+    test_rpc_gui_frame_check(encoder, frame, client_frame, 0, delta, &data_size);
+
+    // Keyframe is repeated after interval
+    for(size_t i = 1; i < RPC_GUI_FRAME_KEYFRAME_INTERVAL; i++) {
+        frame[(i * 37) % TEST_GUI_FRAME_SIZE] += i;
+        test_rpc_gui_frame_check(encoder, frame, client_frame, delta, delta, &data_size);
+    }
+    frame[0]++;
+    test_rpc_gui_frame_check(encoder, frame, client_frame, 0, delta, &data_size);
+
+    // Empty screen is compressed, noise is not
+    memset(frame, 0, TEST_GUI_FRAME_SIZE);
+    test_rpc_gui_frame_check(
+        encoder, frame, client_frame, compress ? RpcGuiFrameFlagCompressed : 0, all, &data_size);
+    size_t empty_size = data_size;
+    for(size_t i = 0; i < TEST_GUI_FRAME_SIZE; i++) {
+        frame[i] = rand();
+    }
+    test_rpc_gui_frame_check(encoder, frame, client_frame, 0, all, &data_size);
+
+    free(data);
+    free(client_frame);
+    free(frame);
+    rpc_gui_frame_encoder_free(encoder);
+
+    mu_check(!encoded);
+    if(compress) {
+        mu_check(empty_size < TEST_GUI_FRAME_SIZE / 8);
+    } else {
+        mu_assert_int_eq(1 + TEST_GUI_FRAME_MAP_SIZE + RPC_GUI_FRAME_TILE_SIZE, tile_delta_size);
+        mu_assert_int_eq(1 + TEST_GUI_FRAME_SIZE, empty_size);
+    }
+}
+
+MU_TEST(test_rpc_gui_frame_delta) {
+    test_rpc_gui_frame_run(false);
+}
+
+MU_TEST(test_rpc_gui_frame_delta_compressed) {
+    test_rpc_gui_frame_run(true);
+}
+
+/* Session features as set by BT service on BLE connection */
+static void test_rpc_gui_bt_setup(void) {
+    test_rpc_setup();
+    rpc_session_set_features(rpc_session[0].session, RPC_SESSION_FEATURES_BT);
+}
+
+static void test_rpc_gui_bt_draw_callback(Canvas* canvas, void* context) {
+    UNUSED(context);
+    canvas_draw_box(canvas, 0, 0, canvas_width(canvas), canvas_height(canvas));
+}
+
+static void test_rpc_gui_send_request(pb_size_t which_content, uint32_t command_id) {
+    PB_Main request = {
+        .command_id = command_id,
+        .which_content = which_content,
+        .cb_content.funcs.encode = NULL,
+    };
+    test_rpc_encode_and_feed_one(&request, 0);
+}
+
+static bool test_rpc_gui_receive(PB_Main* result) {
+    rpc_session[0].timeout = xTaskGetTickCount() + MAX_RECEIVE_OUTPUT_TIMEOUT;
+    pb_istream_t istream = {
+        .callback = test_rpc_pb_stream_read,
+        .state = &rpc_session[0],
+        .errmsg = NULL,
+        .bytes_left = 0x7FFFFFFF,
+    };
+    return pb_decode_ex(&istream, &PB_Main_msg, result, PB_DECODE_DELIMITED);
+}
+
+MU_TEST(test_rpc_gui_bt_screen_stream) {
+    Gui* gui = furi_record_open("gui");
+    ViewPort* view_port = view_port_alloc();
+    view_port_draw_callback_set(view_port, test_rpc_gui_bt_draw_callback, NULL);
+    uint8_t* frame = malloc(TEST_GUI_FRAME_SIZE);
+    uint8_t* black = malloc(TEST_GUI_FRAME_SIZE);
+    uint8_t* buffer = malloc(TEST_GUI_FRAME_MAP_SIZE + TEST_GUI_FRAME_SIZE);
+    FuriHalCompress* compress = furi_hal_compress_alloc(TEST_GUI_FRAME_SIZE);
+    memset(black, 0xFF, TEST_GUI_FRAME_SIZE);
+    PB_Main result = {.cb_content.funcs.decode = NULL};
+
+    // Response comes before any frame
+    test_rpc_gui_send_request(PB_Main_gui_start_screen_stream_request_tag, ++command_id);
+    mu_check(test_rpc_gui_receive(&result));
+    mu_assert_int_eq(command_id, result.command_id);
+    mu_assert_int_eq(PB_Main_empty_tag, result.which_content);
+    mu_assert_int_eq(PB_CommandStatus_OK, result.command_status);
+    pb_release(&PB_Main_msg, &result);
+
+    // Client rebuilds screen from keyframe and deltas in BLE session format
+    gui_add_view_port(gui, view_port, GuiLayerFullscreen);
+    size_t frame_count = 0;
+    bool received = false;
+    while(!received && test_rpc_gui_receive(&result)) {
+        mu_assert_int_eq(PB_Main_gui_screen_frame_tag, result.which_content);
+        pb_bytes_array_t* data = result.content.gui_screen_frame.data;
+        if(frame_count == 0) {
+            mu_assert_int_eq(0, data->bytes[0] & RpcGuiFrameFlagDelta);
+        }
+        test_rpc_gui_frame_decode(frame, data->bytes, data->size, compress, buffer);
+        frame_count++;
+        received = !memcmp(frame, black, TEST_GUI_FRAME_SIZE);
+        pb_release(&PB_Main_msg, &result);
+    }
+    gui_remove_view_port(gui, view_port);
+    mu_check(received);
+
+    // Frames sent meanwhile are skipped
+    test_rpc_gui_send_request(PB_Main_gui_stop_screen_stream_request_tag, ++command_id);
+    bool stopped = false;
+    while(!stopped && test_rpc_gui_receive(&result)) {
+        stopped = (result.which_content != PB_Main_gui_screen_frame_tag);
+        if(stopped) {
+            mu_assert_int_eq(command_id, result.command_id);
+            mu_assert_int_eq(PB_Main_empty_tag, result.which_content);
+        }
+        pb_release(&PB_Main_msg, &result);
+    }
+    mu_check(stopped);
+
+    furi_hal_compress_free(compress);
+    free(buffer);
+    free(black);
+    free(frame);
+    view_port_free(view_port);
+    furi_record_close("gui");
+}
+
+MU_TEST_SUITE(test_rpc_gui_frame) {
+    MU_RUN_TEST(test_rpc_gui_frame_delta);
+    MU_RUN_TEST(test_rpc_gui_frame_delta_compressed);
+}
+
+MU_TEST_SUITE(test_rpc_gui_bt) {
+    MU_SUITE_CONFIGURE(&test_rpc_gui_bt_setup, &test_rpc_teardown);
+    MU_RUN_TEST(test_rpc_gui_bt_screen_stream);
+}
+
 int run_minunit_test_rpc() {
     Storage* storage = furi_record_open("storage");
     if(storage_sd_status(storage) != FSE_OK) {
         FURI_LOG_E(TAG, "SD card not mounted - skip storage tests");
     } else {
         MU_RUN_SUITE(test_rpc_storage);
+        MU_RUN_SUITE(test_rpc_storage_bulk);
     }
     furi_record_close("storage");
     MU_RUN_SUITE(test_rpc_system);
     MU_RUN_SUITE(test_rpc_app);
     MU_RUN_SUITE(test_rpc_session);
+    MU_RUN_SUITE(test_rpc_gui_frame);
+    MU_RUN_SUITE(test_rpc_gui_bt);
 
     return MU_EXIT_CODE;
 }
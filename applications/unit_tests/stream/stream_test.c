@@ -2,6 +2,7 @@
 #include <toolbox/stream/stream.h>
 #include <toolbox/stream/string_stream.h>
 #include <toolbox/stream/file_stream.h>
+#include <toolbox/stream/buffered_file_stream.h>
 #include <storage/storage.h>
 #include "../minunit.h"
 
@@ -282,6 +283,13 @@ MU_TEST(stream_composite_test) {
     mu_check(file_stream_open(stream, "/ext/filestream.str", FSAM_READ_WRITE, FSOM_CREATE_ALWAYS));
     MU_RUN_TEST_1(stream_composite_subtest, stream);
     stream_free(stream);
+
+    // test buffered file stream, small window to get cache misses
+    stream = buffered_file_stream_alloc(storage, 16);
+    mu_check(buffered_file_stream_open(
+        stream, "/ext/filestream.str", FSAM_READ_WRITE, FSOM_CREATE_ALWAYS));
+    MU_RUN_TEST_1(stream_composite_subtest, stream);
+    stream_free(stream);
     furi_record_close("storage");
 }
 
@@ -369,10 +377,82 @@ MU_TEST(stream_split_test) {
     furi_record_close("storage");
 }
 
+MU_TEST_1(stream_delete_and_insert_large_subtest, Stream* stream) {
+    string_t expected;
+    string_t insert;
+    string_init(expected);
+    string_init(insert);
+
+    // data is larger than the stream cache, so the tail is moved in several chunks
+    for(size_t i = 0; i < 2000; i++) {
+        string_push_back(expected, 'a' + i % 26);
+    }
+    stream_clean(stream);
+    mu_assert_int_eq(string_size(expected), stream_write_string(stream, expected));
+
+    // same size, written in place
+    mu_check(stream_seek(stream, 100, StreamOffsetFromStart));
+    mu_check(stream_delete_and_insert_cstring(stream, 10, "0123456789"));
+    string_replace_at(expected, 100, 10, "0123456789");
+    mu_assert_int_eq(110, stream_tell(stream));
+    mu_assert_int_eq(string_size(expected), stream_size(stream));
+
+    // shorter, the tail moves towards the beginning
+    mu_check(stream_seek(stream, 50, StreamOffsetFromStart));
+    mu_check(stream_delete_and_insert_cstring(stream, 700, "short"));
+    string_replace_at(expected, 50, 700, "short");
+    mu_assert_int_eq(55, stream_tell(stream));
+    mu_assert_int_eq(string_size(expected), stream_size(stream));
+
+    // longer, the tail moves towards the end by more than the stream cache size
+    for(size_t i = 0; i < 1500; i++) {
+        string_push_back(insert, 'A' + i % 26);
+    }
+    mu_check(stream_seek(stream, 20, StreamOffsetFromStart));
+    mu_check(stream_delete_and_insert_string(stream, 3, insert));
+    string_replace_at(expected, 20, 3, string_get_cstr(insert));
+    mu_assert_int_eq(1520, stream_tell(stream));
+    mu_assert_int_eq(string_size(expected), stream_size(stream));
+
+    uint8_t* data = malloc(string_size(expected) + 1);
+    mu_check(stream_rewind(stream));
+    mu_assert_int_eq(string_size(expected), stream_read(stream, data, string_size(expected)));
+    data[string_size(expected)] = '\0';
+    mu_assert_string_eq(string_get_cstr(expected), (const char*)data);
+    free(data);
+
+    string_clear(insert);
+    string_clear(expected);
+}
+
+MU_TEST(stream_delete_and_insert_large_test) {
+    // test string stream
+    Stream* stream;
+    stream = string_stream_alloc();
+    MU_RUN_TEST_1(stream_delete_and_insert_large_subtest, stream);
+    stream_free(stream);
+
+    // test file stream
+    Storage* storage = furi_record_open("storage");
+    stream = file_stream_alloc(storage);
+    mu_check(file_stream_open(stream, "/ext/filestream.str", FSAM_READ_WRITE, FSOM_CREATE_ALWAYS));
+    MU_RUN_TEST_1(stream_delete_and_insert_large_subtest, stream);
+    stream_free(stream);
+
+    // test buffered file stream
+    stream = buffered_file_stream_alloc(storage, 0);
+    mu_check(buffered_file_stream_open(
+        stream, "/ext/filestream.str", FSAM_READ_WRITE, FSOM_CREATE_ALWAYS));
+    MU_RUN_TEST_1(stream_delete_and_insert_large_subtest, stream);
+    stream_free(stream);
+    furi_record_close("storage");
+}
+
 MU_TEST_SUITE(stream_suite) {
     MU_RUN_TEST(stream_write_read_save_load_test);
     MU_RUN_TEST(stream_composite_test);
     MU_RUN_TEST(stream_split_test);
+    MU_RUN_TEST(stream_delete_and_insert_large_test);
 }
 
 int run_minunit_test_stream() {
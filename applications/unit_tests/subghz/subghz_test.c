@@ -15,6 +15,7 @@
 #define TEST_RANDOM_DIR_NAME "/ext/unit_tests/subghz/test_random_raw.sub"
 #define TEST_RANDOM_COUNT_PARSE 101
 #define TEST_TIMEOUT 10000
+#define TEST_BATCH_SIZE 64 // as in SubGhzWorker
 
 static SubGhzEnvironment* environment_handler;
 static SubGhzReceiver* receiver_handler;
@@ -94,10 +95,12 @@ static bool subghz_decode_test(const char* path, const char* name_decoder) {
     }
 }
 
-static bool subghz_decode_ramdom_test(const char* path) {
+static bool subghz_decode_ramdom_test(const char* path, bool batch) {
     subghz_test_decoder_count = 0;
     subghz_receiver_reset(receiver_handler);
     uint32_t test_start = furi_hal_get_tick();
+    LevelDuration* batch_buffer = malloc(sizeof(LevelDuration) * TEST_BATCH_SIZE);
+    size_t batch_count = 0;
 
     file_worker_encoder_handler = subghz_file_encoder_worker_alloc();
     if(subghz_file_encoder_worker_start(file_worker_encoder_handler, path)) {
@@ -110,19 +113,31 @@ static bool subghz_decode_ramdom_test(const char* path) {
             level_duration =
                 subghz_file_encoder_worker_get_level_duration(file_worker_encoder_handler);
             if(!level_duration_is_reset(level_duration)) {
-                bool level = level_duration_get_level(level_duration);
-                uint32_t duration = level_duration_get_duration(level_duration);
-                subghz_receiver_decode(receiver_handler, level, duration);
+                if(batch) {
+                    batch_buffer[batch_count++] = level_duration;
+                    if(batch_count == TEST_BATCH_SIZE) {
+                        subghz_receiver_decode_batch(receiver_handler, batch_buffer, batch_count);
+                        batch_count = 0;
+                    }
+                } else {
+                    bool level = level_duration_get_level(level_duration);
+                    uint32_t duration = level_duration_get_duration(level_duration);
+                    subghz_receiver_decode(receiver_handler, level, duration);
+                }
             } else {
                 break;
             }
         }
+        if(batch_count) {
+            subghz_receiver_decode_batch(receiver_handler, batch_buffer, batch_count);
+        }
         furi_hal_delay_ms(10);
         if(subghz_file_encoder_worker_is_running(file_worker_encoder_handler)) {
             subghz_file_encoder_worker_stop(file_worker_encoder_handler);
         }
         subghz_file_encoder_worker_free(file_worker_encoder_handler);
     }
+    free(batch_buffer);
     FURI_LOG_I(TAG, "\r\n Decoder count parse \033[0;33m%d\033[0m ", subghz_test_decoder_count);
     if(furi_hal_get_tick() - test_start > TEST_TIMEOUT * 10) {
         printf("\033[0;31mRandom test ERROR TimeOut\033[0m\r\n");
@@ -359,7 +374,41 @@ MU_TEST(subghz_ecoder_keelog_test) {
 }
 
 MU_TEST(subghz_random_test) {
-    mu_assert(subghz_decode_ramdom_test(TEST_RANDOM_DIR_NAME), "Random test error\r\n");
+    SubGhzReceiverStats stats;
+    subghz_receiver_reset_stats(receiver_handler);
+    mu_assert(subghz_decode_ramdom_test(TEST_RANDOM_DIR_NAME, false), "Random test error\r\n");
+    subghz_receiver_get_stats(receiver_handler, &stats);
+    FURI_LOG_I(
+        TAG, "\r\n Pre-filter fed %lu, skipped %lu", stats.feed_count, stats.skip_count);
+    mu_assert(stats.skip_count > 0, "Pre-filter skipped nothing\r\n");
+}
+
+MU_TEST(subghz_random_no_prefilter_test) {
+    SubGhzReceiverStats stats;
+    subghz_receiver_set_prefilter(receiver_handler, false);
+    subghz_receiver_reset_stats(receiver_handler);
+    mu_assert(
+        subghz_decode_ramdom_test(TEST_RANDOM_DIR_NAME, false),
+        "Random test without pre-filter error\r\n");
+    subghz_receiver_get_stats(receiver_handler, &stats);
+    subghz_receiver_set_prefilter(receiver_handler, true);
+    mu_assert_int_eq(0, stats.skip_count);
+}
+
+MU_TEST(subghz_random_batch_test) {
+    SubGhzReceiverStats stats;
+    SubGhzReceiverStats batch_stats;
+    subghz_receiver_reset_stats(receiver_handler);
+    mu_assert(subghz_decode_ramdom_test(TEST_RANDOM_DIR_NAME, false), "Random test error\r\n");
+    subghz_receiver_get_stats(receiver_handler, &stats);
+
+    // Same capture fed in worker sized batches must decode the same way
+    subghz_receiver_reset_stats(receiver_handler);
+    mu_assert(
+        subghz_decode_ramdom_test(TEST_RANDOM_DIR_NAME, true), "Random batch test error\r\n");
+    subghz_receiver_get_stats(receiver_handler, &batch_stats);
+    mu_assert_int_eq(stats.feed_count, batch_stats.feed_count);
+    mu_assert_int_eq(stats.skip_count, batch_stats.skip_count);
 }
 
 MU_TEST_SUITE(subghz) {
@@ -395,6 +444,8 @@ MU_TEST_SUITE(subghz) {
     MU_RUN_TEST(subghz_ecoder_keelog_test);
 
     MU_RUN_TEST(subghz_random_test);
+    MU_RUN_TEST(subghz_random_no_prefilter_test);
+    MU_RUN_TEST(subghz_random_batch_test);
     subghz_test_deinit();
 }
 
@@ -0,0 +1,165 @@
+#include "../minunit.h"
+#include <furi.h>
+#include <furi_hal.h>
+#include <storage/storage.h>
+#include <toolbox/tar/tar_archive.h>
+
+#define TAR_TEST_DIR "/ext/.tar_test"
+#define TAR_TEST_SOURCE_DIR TAR_TEST_DIR "/src"
+#define TAR_TEST_DEST_DIR TAR_TEST_DIR "/dst"
+#define TAR_TEST_ARCHIVE TAR_TEST_DIR "/test.tar"
+#define TAR_TEST_FILES 24
+#define TAR_TEST_FILE_SIZE 1500
+
+static void tar_test_file_path(string_t path, const char* dir, uint8_t index) {
+    string_printf(path, "%s/file_%u.txt", dir, index);
+}
+
+/* Text-like contents, different for every file */
+static void tar_test_fill(uint8_t* data, size_t size, uint8_t index) {
+    for(size_t i = 0; i < size; i++) {
+        data[i] = (i % 64 == 63) ? '\n' : 'a' + (i / 64 + index) % 26;
+    }
+}
+
+static void tar_test_setup() {
+    Storage* storage = furi_record_open("storage");
+    storage_simply_remove_recursive(storage, TAR_TEST_DIR);
+    mu_check(storage_simply_mkdir(storage, TAR_TEST_DIR));
+    mu_check(storage_simply_mkdir(storage, TAR_TEST_SOURCE_DIR));
+
+    File* file = storage_file_alloc(storage);
+    uint8_t* data = malloc(TAR_TEST_FILE_SIZE);
+    string_t path;
+    string_init(path);
+    for(uint8_t i = 0; i < TAR_TEST_FILES; i++) {
+        tar_test_file_path(path, TAR_TEST_SOURCE_DIR, i);
+        tar_test_fill(data, TAR_TEST_FILE_SIZE, i);
+        mu_check(storage_file_open(file, string_get_cstr(path), FSAM_WRITE, FSOM_CREATE_ALWAYS));
+        mu_check(storage_file_write(file, data, TAR_TEST_FILE_SIZE) == TAR_TEST_FILE_SIZE);
+        storage_file_close(file);
+    }
+    string_clear(path);
+    free(data);
+    storage_file_free(file);
+    furi_record_close("storage");
+}
+
+static void tar_test_teardown() {
+    Storage* storage = furi_record_open("storage");
+    mu_check(storage_simply_remove_recursive(storage, TAR_TEST_DIR));
+    furi_record_close("storage");
+}
+
+static void tar_test_check_unpacked() {
+    Storage* storage = furi_record_open("storage");
+    File* file = storage_file_alloc(storage);
+    uint8_t* expected = malloc(TAR_TEST_FILE_SIZE);
+    uint8_t* data = malloc(TAR_TEST_FILE_SIZE + 1);
+    string_t path;
+    string_init(path);
+    for(uint8_t i = 0; i < TAR_TEST_FILES; i++) {
+        tar_test_file_path(path, TAR_TEST_DEST_DIR, i);
+        tar_test_fill(expected, TAR_TEST_FILE_SIZE, i);
+        mu_check(storage_file_open(file, string_get_cstr(path), FSAM_READ, FSOM_OPEN_EXISTING));
+        mu_check(storage_file_read(file, data, TAR_TEST_FILE_SIZE + 1) == TAR_TEST_FILE_SIZE);
+        mu_check(memcmp(data, expected, TAR_TEST_FILE_SIZE) == 0);
+        storage_file_close(file);
+    }
+    string_clear(path);
+    free(data);
+    free(expected);
+    storage_file_free(file);
+    furi_record_close("storage");
+}
+
+/* Packs test files and unpacks them back, returns archive size and unpack time */
+static void tar_test_roundtrip(
+    TarOpenMode mode,
+    uint16_t block_size,
+    uint32_t* archive_size,
+    uint32_t* unpack_time) {
+    Storage* storage = furi_record_open("storage");
+    storage_simply_remove_recursive(storage, TAR_TEST_DEST_DIR);
+    mu_check(storage_simply_mkdir(storage, TAR_TEST_DEST_DIR));
+
+    TarArchive* archive = tar_archive_alloc(storage);
+    mu_check(tar_archive_open(archive, TAR_TEST_ARCHIVE, mode));
+    mu_check(tar_archive_add_dir(archive, TAR_TEST_SOURCE_DIR, ""));
+    mu_check(tar_archive_finalize(archive));
+    tar_archive_free(archive);
+
+    FileInfo info;
+    mu_check(storage_common_stat(storage, TAR_TEST_ARCHIVE, &info) == FSE_OK);
+    *archive_size = info.size;
+
+    archive = tar_archive_alloc(storage);
+    mu_check(tar_archive_open(archive, TAR_TEST_ARCHIVE, TAR_OPEN_MODE_READ));
+    tar_archive_set_unpack_block_size(archive, block_size);
+    mu_assert_int_eq(TAR_TEST_FILES, tar_archive_get_entries_count(archive));
+    uint32_t start = furi_hal_get_tick();
+    mu_check(tar_archive_unpack_to(archive, TAR_TEST_DEST_DIR));
+    *unpack_time = furi_hal_get_tick() - start;
+    tar_archive_free(archive);
+
+    furi_record_close("storage");
+
+    tar_test_check_unpacked();
+}
+
+MU_TEST(tar_test_plain) {
+    uint32_t size, time;
+    tar_test_roundtrip(TAR_OPEN_MODE_WRITE, TAR_ARCHIVE_UNPACK_BLOCK_SIZE_DEFAULT, &size, &time);
+}
+
+MU_TEST(tar_test_heatshrink) {
+    uint32_t size, time;
+    tar_test_roundtrip(
+        TAR_OPEN_MODE_WRITE_HEATSHRINK, TAR_ARCHIVE_UNPACK_BLOCK_SIZE_DEFAULT, &size, &time);
+}
+
+MU_TEST(tar_test_small_blocks) {
+    uint32_t size, time;
+    /* File data is split into more blocks than writer queue holds */
+    tar_test_roundtrip(TAR_OPEN_MODE_WRITE_HEATSHRINK, 100, &size, &time);
+}
+
+/* Throughput of plain and compressed archives, reported, not asserted */
+MU_TEST(tar_test_bench) {
+    const uint16_t block_sizes[] = {512, TAR_ARCHIVE_UNPACK_BLOCK_SIZE_DEFAULT, 4096};
+    const uint32_t data_size = TAR_TEST_FILES * TAR_TEST_FILE_SIZE;
+
+    for(size_t i = 0; i < COUNT_OF(block_sizes); i++) {
+        uint32_t plain_size, plain_time, compressed_size, compressed_time;
+        tar_test_roundtrip(TAR_OPEN_MODE_WRITE, block_sizes[i], &plain_size, &plain_time);
+        tar_test_roundtrip(
+            TAR_OPEN_MODE_WRITE_HEATSHRINK,
+            block_sizes[i],
+            &compressed_size,
+            &compressed_time);
+
+        printf(
+            "\r\ntar: %lu bytes of data in %u byte blocks, plain %lu bytes in %lu ms, "
+            "compressed %lu bytes in %lu ms\r\n",
+            data_size,
+            block_sizes[i],
+            plain_size,
+            plain_time,
+            compressed_size,
+            compressed_time);
+    }
+}
+
+MU_TEST_SUITE(tar_archive) {
+    MU_SUITE_CONFIGURE(&tar_test_setup, &tar_test_teardown);
+
+    MU_RUN_TEST(tar_test_plain);
+    MU_RUN_TEST(tar_test_heatshrink);
+    MU_RUN_TEST(tar_test_small_blocks);
+    MU_RUN_TEST(tar_test_bench);
+}
+
+int run_minunit_test_tar() {
+    MU_RUN_SUITE(tar_archive);
+    return MU_EXIT_CODE;
+}
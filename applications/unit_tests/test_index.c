@@ -12,12 +12,15 @@
 
 int run_minunit();
 int run_minunit_test_infrared_decoder_encoder();
+int run_minunit_test_infrared_index();
 int run_minunit_test_rpc();
 int run_minunit_test_flipper_format();
 int run_minunit_test_flipper_format_string();
 int run_minunit_test_stream();
 int run_minunit_test_storage();
 int run_minunit_test_subghz();
+int run_minunit_test_tar();
+int run_minunit_test_archive_dir_index();
 
 void minunit_print_progress(void) {
     static char progress[] = {'\\', '|', '/', '-'};
@@ -60,8 +63,11 @@ void unit_tests_cli(Cli* cli, string_t args, void* context) {
         test_result |= run_minunit_test_flipper_format();
         test_result |= run_minunit_test_flipper_format_string();
         test_result |= run_minunit_test_infrared_decoder_encoder();
+        test_result |= run_minunit_test_infrared_index();
         test_result |= run_minunit_test_rpc();
         test_result |= run_minunit_test_subghz();
+        test_result |= run_minunit_test_tar();
+        test_result |= run_minunit_test_archive_dir_index();
 
         cycle_counter = (furi_hal_get_tick() - cycle_counter);
 
@@ -6,10 +6,13 @@
 #include <storage/storage.h>
 #include <toolbox/path.h>
 #include <update_util/dfu_file.h>
+#include <update_util/delta_file.h>
 #include <update_util/lfs_backup.h>
 #include <update_util/update_operation.h>
 #include <toolbox/tar/tar_archive.h>
 
+#define TAG "UpdWorker"
+
 #define CHECK_RESULT(x) \
     if(!(x)) {          \
         break;          \
@@ -41,6 +44,16 @@ static bool page_task_compare_flash(
     return (memcmp(update_block, (void*)page_addr, update_block_len) == 0);
 }
 
+/* Programs page and verifies it straight from the same buffer
+ */
+static bool page_task_program_verify(
+    const uint8_t i_page,
+    const uint8_t* update_block,
+    uint16_t update_block_len) {
+    return furi_hal_flash_program_page(i_page, update_block, update_block_len) &&
+           page_task_compare_flash(i_page, update_block, update_block_len);
+}
+
 /* Verifies a flash operation address for fitting into writable memory
  */
 static bool check_address_boundaries(const size_t address) {
@@ -49,6 +62,59 @@ static bool check_address_boundaries(const size_t address) {
     return ((address >= min_allowed_address) && (address < max_allowed_address));
 }
 
+/* Programs pages from delta file if flash holds the build it was made against.
+ * On failure after programming has started, flash is left partially updated:
+ * full image scan picks up every page that is still different.
+ */
+static bool update_task_apply_delta(UpdateTask* update_task, const DfuUpdateTask* page_task) {
+    bool success = false;
+    DeltaFileHeader header;
+
+    /* Delta validation, write and target check replace full image stages */
+    update_task->state.total_stages = update_task->state.current_stage_idx + 3;
+    do {
+        update_task_set_progress(update_task, UpdateTaskStageValidateDFUImage, 0);
+        if(!update_task_open_file(update_task, update_task->manifest->firmware_delta_image)) {
+            FURI_LOG_W(TAG, "Delta file is missing");
+            break;
+        }
+
+        if(!delta_file_validate(
+               update_task->file, &header, &update_task_dfu_progress, update_task) ||
+           (header.base_crc != update_task->manifest->firmware_delta_base_crc)) {
+            FURI_LOG_W(TAG, "Delta file is invalid");
+            break;
+        }
+
+        if(!delta_file_check_base(&header)) {
+            FURI_LOG_I(TAG, "Flash doesn't match delta base");
+            break;
+        }
+        FURI_LOG_I(TAG, "%lu pages to program from delta", header.page_count);
+
+        update_task_set_progress(update_task, UpdateTaskStageFlashWrite, 0);
+        if(!delta_file_process_pages(page_task, update_task->file, &header)) {
+            FURI_LOG_E(TAG, "Delta programming failed");
+            break;
+        }
+
+        update_task_set_progress(update_task, UpdateTaskStageFlashValidate, 0);
+        if(!delta_file_check_target(&header)) {
+            FURI_LOG_E(TAG, "Flash doesn't match delta target");
+            break;
+        }
+        update_task_set_progress(update_task, UpdateTaskStageProgress, 100);
+
+        success = true;
+    } while(false);
+
+    if(!success) {
+        /* Full image validation and write follow */
+        update_task->state.total_stages = update_task->state.current_stage_idx + 2;
+    }
+    return success;
+}
+
 int32_t update_task_worker_flash_writer(void* context) {
     furi_assert(context);
     UpdateTask* update_task = context;
@@ -56,22 +122,29 @@ int32_t update_task_worker_flash_writer(void* context) {
     DfuUpdateTask page_task = {
         .address_cb = &check_address_boundaries,
         .progress_cb = &update_task_dfu_progress,
-        .task_cb = &furi_hal_flash_program_page,
+        .task_cb = &page_task_program_verify,
         .context = update_task,
     };
+    DfuPageMap* page_map = malloc(sizeof(DfuPageMap));
 
     update_task->state.current_stage_idx = 0;
-    update_task->state.total_stages = 4;
+    update_task->state.total_stages = 3;
 
     do {
         CHECK_RESULT(update_task_parse_manifest(update_task));
 
-        if(!string_empty_p(update_task->manifest->firmware_dfu_image)) {
+        bool delta_applied = false;
+        if(!string_empty_p(update_task->manifest->firmware_delta_image)) {
+            delta_applied = update_task_apply_delta(update_task, &page_task);
+            if(!delta_applied) {
+                FURI_LOG_W(TAG, "Falling back to full image");
+            }
+        }
+
+        if(!delta_applied && !string_empty_p(update_task->manifest->firmware_dfu_image)) {
             update_task_set_progress(update_task, UpdateTaskStageValidateDFUImage, 0);
             CHECK_RESULT(
                 update_task_open_file(update_task, update_task->manifest->firmware_dfu_image));
-            CHECK_RESULT(
-                dfu_file_validate_crc(update_task->file, &update_task_dfu_progress, update_task));
 
             const uint8_t valid_targets =
                 dfu_file_validate_headers(update_task->file, &flipper_dfu_params);
@@ -79,13 +152,18 @@ int32_t update_task_worker_flash_writer(void* context) {
                 break;
             }
 
-            update_task_set_progress(update_task, UpdateTaskStageFlashWrite, 0);
-            CHECK_RESULT(dfu_file_process_targets(&page_task, update_task->file, valid_targets));
-
-            page_task.task_cb = &page_task_compare_flash;
+            /* Single read of the image: CRC and lookup of pages that differ from flash.
+             * Nothing is programmed until CRC is known to be valid. */
+            CHECK_RESULT(dfu_file_scan(&page_task, update_task->file, valid_targets, page_map));
+            FURI_LOG_I(
+                TAG,
+                "%u of %u pages to program",
+                page_map->pages_changed,
+                page_map->pages_total);
 
-            update_task_set_progress(update_task, UpdateTaskStageFlashValidate, 0);
-            CHECK_RESULT(dfu_file_process_targets(&page_task, update_task->file, valid_targets));
+            update_task_set_progress(update_task, UpdateTaskStageFlashWrite, 0);
+            CHECK_RESULT(dfu_file_process_targets(
+                &page_task, update_task->file, valid_targets, page_map));
         }
 
         update_task_set_progress(update_task, UpdateTaskStageCompleted, 100);
@@ -95,6 +173,8 @@ int32_t update_task_worker_flash_writer(void* context) {
         success = true;
     } while(false);
 
+    free(page_map);
+
     if(!success) {
         update_task_set_progress(update_task, UpdateTaskStageError, update_task->state.progress);
     }
@@ -1,17 +1,67 @@
 #include "log.h"
 #include "check.h"
+#include "common_defines.h"
 #include <cmsis_os2.h>
 #include <furi_hal.h>
+#include <string.h>
 
 #define FURI_LOG_LEVEL_DEFAULT FuriLogLevelInfo
 
+/* Deferred mode: amount of queued records, has to be power of 2 */
+#define FURI_LOG_DEFERRED_RECORDS (64)
+/* Deferred mode: space for packed arguments of one record */
+#define FURI_LOG_DEFERRED_ARGS_SIZE (32)
+/* Deferred mode: %s arguments are copied and truncated to this size */
+#define FURI_LOG_DEFERRED_STRING_SIZE (16)
+/* Deferred mode: max length of formatted record */
+#define FURI_LOG_DEFERRED_LINE_SIZE (256)
+#define FURI_LOG_DEFERRED_THREAD_STACK_SIZE (2048)
+
+#define FURI_LOG_DEFERRED_FLAG_NEW (1 << 0)
+
+/* Trace frame: sync, length, token, timestamp, packed arguments, checksum.
+ * Length covers token, timestamp and arguments, checksum is XOR of length
+ * and everything it covers. Token is address of format literal in firmware
+ * image, 0 reports dropped records with their count as argument. */
+#define FURI_LOG_TRACE_SYNC (0xA5)
+#define FURI_LOG_TRACE_TOKEN_DROPPED (0)
+#define FURI_LOG_TRACE_FRAME_SIZE (2 + 4 + 4 + FURI_LOG_DEFERRED_ARGS_SIZE + 1)
+
+typedef struct {
+    volatile uint32_t sequence; /**< index + 1 of record once it is complete */
+    uint32_t timestamp;
+    const char* format;
+    uint8_t args_size;
+    bool truncated;
+    uint8_t args[FURI_LOG_DEFERRED_ARGS_SIZE];
+} FuriLogRecord;
+
+typedef struct {
+    FuriLogRecord records[FURI_LOG_DEFERRED_RECORDS];
+    volatile uint32_t head; /**< next index to reserve, shared by producers */
+    volatile uint32_t tail; /**< next index to print, owned by drain thread */
+    volatile uint32_t dropped; /**< dropped since last drain */
+    volatile uint32_t dropped_total;
+    osThreadId_t thread;
+} FuriLogRing;
+
 typedef struct {
     FuriLogLevel log_level;
     FuriLogPuts puts;
     FuriLogTimestamp timetamp;
     osMutexId_t mutex;
+    FuriLogRing* ring;
+    volatile bool deferred;
+    volatile FuriLogTraceWrite trace_write;
 } FuriLogParams;
 
+/* Conversion specification, as found in format */
+typedef struct {
+    char conversion;
+    bool is_wide; /**< ll or j modifier, 64 bit argument */
+    uint8_t star_count; /**< width and precision passed as arguments */
+} FuriLogSpec;
+
 static FuriLogParams furi_log;
 
 void furi_log_init() {
@@ -22,8 +72,325 @@ void furi_log_init() {
     furi_log.mutex = osMutexNew(NULL);
 }
 
+/** Parse conversion specification
+ *
+ * @param format pointer right after '%'
+ * @param spec parsed specification
+ * @return pointer right after specification
+ */
+static const char* furi_log_parse_spec(const char* format, FuriLogSpec* spec) {
+    spec->conversion = '\0';
+    spec->is_wide = false;
+    spec->star_count = 0;
+
+    while(*format) {
+        char c = *format++;
+        if(c == '*') {
+            spec->star_count++;
+        } else if(c == 'j' || (c == 'l' && *format == 'l')) {
+            spec->is_wide = true;
+        } else if(strchr("diouxXcspfFeEgGaAn%", c)) {
+            spec->conversion = c;
+            break;
+        }
+    }
+
+    return format;
+}
+
+static bool furi_log_put_arg(FuriLogRecord* record, const void* data, size_t size) {
+    if(record->args_size + size > FURI_LOG_DEFERRED_ARGS_SIZE) {
+        record->truncated = true;
+        return false;
+    }
+    memcpy(&record->args[record->args_size], data, size);
+    record->args_size += size;
+    return true;
+}
+
+static bool
+    furi_log_get_arg(const FuriLogRecord* record, size_t* offset, void* data, size_t size) {
+    if(*offset + size > record->args_size) return false;
+    memcpy(data, &record->args[*offset], size);
+    *offset += size;
+    return true;
+}
+
+/* Pack arguments in the order they are used by format, strings by value */
+static void furi_log_pack_args(FuriLogRecord* record, va_list args) {
+    const char* format = record->format;
+    while(*format && !record->truncated) {
+        if(*format++ != '%') continue;
+
+        FuriLogSpec spec;
+        format = furi_log_parse_spec(format, &spec);
+        for(uint8_t i = 0; i < spec.star_count; i++) {
+            int value = va_arg(args, int);
+            furi_log_put_arg(record, &value, sizeof(value));
+        }
+
+        switch(spec.conversion) {
+        case 's': {
+            const char* value = va_arg(args, const char*);
+            char string[FURI_LOG_DEFERRED_STRING_SIZE] = {0};
+            if(value) {
+                strncpy(string, value, sizeof(string) - 1);
+            }
+            furi_log_put_arg(record, string, strlen(string) + 1);
+            break;
+        }
+        case 'f':
+        case 'F':
+        case 'e':
+        case 'E':
+        case 'g':
+        case 'G':
+        case 'a':
+        case 'A': {
+            double value = va_arg(args, double);
+            furi_log_put_arg(record, &value, sizeof(value));
+            break;
+        }
+        case 'p':
+        case 'n': {
+            void* value = va_arg(args, void*);
+            furi_log_put_arg(record, &value, sizeof(value));
+            break;
+        }
+        case '%':
+        case '\0':
+            break;
+        default:
+            if(spec.is_wide) {
+                long long value = va_arg(args, long long);
+                furi_log_put_arg(record, &value, sizeof(value));
+            } else {
+                int value = va_arg(args, int);
+                furi_log_put_arg(record, &value, sizeof(value));
+            }
+            break;
+        }
+    }
+}
+
+/* Format one conversion of record, write to line, return written size */
+static int furi_log_format_spec(
+    const FuriLogRecord* record,
+    size_t* offset,
+    const char* spec_start,
+    const char* spec_end,
+    const FuriLogSpec* spec,
+    char* line,
+    size_t line_size) {
+    // Copy specification, replacing '*' with argument values
+    char spec_str[24];
+    size_t spec_size = 0;
+    for(const char* c = spec_start; c < spec_end && spec_size < sizeof(spec_str) - 12; c++) {
+        if(*c == '*') {
+            int value = 0;
+            if(!furi_log_get_arg(record, offset, &value, sizeof(value))) return -1;
+            spec_size += snprintf(&spec_str[spec_size], 12, "%d", value);
+        } else {
+            spec_str[spec_size++] = *c;
+        }
+    }
+    spec_str[spec_size] = '\0';
+
+    switch(spec->conversion) {
+    case 's': {
+        const char* value = (const char*)&record->args[*offset];
+        size_t size = strnlen(value, record->args_size - *offset);
+        if(*offset + size >= record->args_size) return -1;
+        *offset += size + 1;
+        return snprintf(line, line_size, spec_str, value);
+    }
+    case 'f':
+    case 'F':
+    case 'e':
+    case 'E':
+    case 'g':
+    case 'G':
+    case 'a':
+    case 'A': {
+        double value;
+        if(!furi_log_get_arg(record, offset, &value, sizeof(value))) return -1;
+        return snprintf(line, line_size, spec_str, value);
+    }
+    case 'p': {
+        void* value;
+        if(!furi_log_get_arg(record, offset, &value, sizeof(value))) return -1;
+        return snprintf(line, line_size, spec_str, value);
+    }
+    case 'n': {
+        void* value;
+        if(!furi_log_get_arg(record, offset, &value, sizeof(value))) return -1;
+        return 0;
+    }
+    default:
+        if(spec->is_wide) {
+            long long value;
+            if(!furi_log_get_arg(record, offset, &value, sizeof(value))) return -1;
+            return snprintf(line, line_size, spec_str, value);
+        } else {
+            int value;
+            if(!furi_log_get_arg(record, offset, &value, sizeof(value))) return -1;
+            return snprintf(line, line_size, spec_str, value);
+        }
+    }
+}
+
+static void furi_log_format_record(const FuriLogRecord* record, char* line, size_t line_size) {
+    size_t position = snprintf(line, line_size, "%lu ", record->timestamp);
+    size_t offset = 0;
+    const char* format = record->format;
+
+    while(*format && position < line_size - 1) {
+        if(*format != '%') {
+            line[position++] = *format++;
+            continue;
+        }
+
+        const char* spec_start = format++;
+        FuriLogSpec spec;
+        format = furi_log_parse_spec(format, &spec);
+        if(spec.conversion == '%') {
+            line[position++] = '%';
+            continue;
+        }
+
+        int written = furi_log_format_spec(
+            record, &offset, spec_start, format, &spec, &line[position], line_size - position);
+        if(written < 0) {
+            // Arguments didn't fit into record, keep the rest of format as is
+            written = snprintf(&line[position], line_size - position, "~%s", spec_start);
+            position += MIN((size_t)MAX(written, 0), line_size - position - 1);
+            break;
+        }
+        position += MIN((size_t)written, line_size - position - 1);
+    }
+
+    line[position] = '\0';
+}
+
+static void furi_log_puts_locked(const char* string) {
+    if(osMutexAcquire(furi_log.mutex, osWaitForever) == osOK) {
+        furi_log.puts(string);
+        osMutexRelease(furi_log.mutex);
+    }
+}
+
+static void furi_log_trace(
+    FuriLogTraceWrite write,
+    uint32_t token,
+    uint32_t timestamp,
+    const uint8_t* args,
+    size_t args_size) {
+    uint8_t frame[FURI_LOG_TRACE_FRAME_SIZE];
+    size_t size = 0;
+
+    frame[size++] = FURI_LOG_TRACE_SYNC;
+    frame[size++] = sizeof(token) + sizeof(timestamp) + args_size;
+    memcpy(&frame[size], &token, sizeof(token));
+    size += sizeof(token);
+    memcpy(&frame[size], &timestamp, sizeof(timestamp));
+    size += sizeof(timestamp);
+    memcpy(&frame[size], args, args_size);
+    size += args_size;
+
+    uint8_t checksum = 0;
+    for(size_t i = 1; i < size; i++) {
+        checksum ^= frame[i];
+    }
+    frame[size++] = checksum;
+
+    if(osMutexAcquire(furi_log.mutex, osWaitForever) == osOK) {
+        write(frame, size);
+        osMutexRelease(furi_log.mutex);
+    }
+}
+
+static void furi_log_drain(FuriLogRing* ring, char* line) {
+    FuriLogTraceWrite trace_write = furi_log.trace_write;
+
+    uint32_t dropped = __atomic_exchange_n(&ring->dropped, 0, __ATOMIC_RELAXED);
+    if(dropped && trace_write) {
+        furi_log_trace(
+            trace_write,
+            FURI_LOG_TRACE_TOKEN_DROPPED,
+            furi_log.timetamp(),
+            (const uint8_t*)&dropped,
+            sizeof(dropped));
+    } else if(dropped) {
+        snprintf(line, FURI_LOG_DEFERRED_LINE_SIZE, "%lu log records dropped\r\n", dropped);
+        furi_log_puts_locked(line);
+    }
+
+    while(true) {
+        uint32_t tail = ring->tail;
+        FuriLogRecord* record = &ring->records[tail % FURI_LOG_DEFERRED_RECORDS];
+        // Stop at first record that is not complete yet, its producer will wake us up
+        if(__atomic_load_n(&record->sequence, __ATOMIC_ACQUIRE) != tail + 1) break;
+
+        if(trace_write) {
+            furi_log_trace(
+                trace_write,
+                (uint32_t)record->format,
+                record->timestamp,
+                record->args,
+                record->args_size);
+            __atomic_store_n(&ring->tail, tail + 1, __ATOMIC_RELEASE);
+        } else {
+            furi_log_format_record(record, line, FURI_LOG_DEFERRED_LINE_SIZE);
+            __atomic_store_n(&ring->tail, tail + 1, __ATOMIC_RELEASE);
+            furi_log_puts_locked(line);
+        }
+    }
+}
+
+static void furi_log_drain_thread(void* context) {
+    FuriLogRing* ring = context;
+    char* line = malloc(FURI_LOG_DEFERRED_LINE_SIZE);
+
+    while(true) {
+        osThreadFlagsWait(FURI_LOG_DEFERRED_FLAG_NEW, osFlagsWaitAny, osWaitForever);
+        furi_log_drain(ring, line);
+    }
+}
+
+/* Reserve record, fill it and publish, without locks and allocation */
+static void furi_log_push(const char* format, va_list args) {
+    FuriLogRing* ring = furi_log.ring;
+
+    uint32_t head = __atomic_load_n(&ring->head, __ATOMIC_RELAXED);
+    do {
+        if(head - __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE) >= FURI_LOG_DEFERRED_RECORDS) {
+            __atomic_fetch_add(&ring->dropped, 1, __ATOMIC_RELAXED);
+            __atomic_fetch_add(&ring->dropped_total, 1, __ATOMIC_RELAXED);
+            return;
+        }
+    } while(!__atomic_compare_exchange_n(
+        &ring->head, &head, head + 1, true, __ATOMIC_ACQ_REL, __ATOMIC_RELAXED));
+
+    FuriLogRecord* record = &ring->records[head % FURI_LOG_DEFERRED_RECORDS];
+    record->timestamp = furi_log.timetamp();
+    record->format = format;
+    record->args_size = 0;
+    record->truncated = false;
+    furi_log_pack_args(record, args);
+    __atomic_store_n(&record->sequence, head + 1, __ATOMIC_RELEASE);
+
+    osThreadFlagsSet(ring->thread, FURI_LOG_DEFERRED_FLAG_NEW);
+}
+
 void furi_log_print(FuriLogLevel level, const char* format, ...) {
-    if(level <= furi_log.log_level && osMutexAcquire(furi_log.mutex, osWaitForever) == osOK) {
+    if(level > furi_log.log_level) return;
+
+    if(furi_log.deferred || furi_log.trace_write) {
+        va_list args;
+        va_start(args, format);
+        furi_log_push(format, args);
+        va_end(args);
+    } else if(osMutexAcquire(furi_log.mutex, osWaitForever) == osOK) {
         string_t string;
 
         // Timestamp
@@ -63,3 +430,40 @@ void furi_log_set_timestamp(FuriLogTimestamp timestamp) {
     furi_assert(timestamp);
     furi_log.timetamp = timestamp;
 }
+
+static void furi_log_start_ring() {
+    if(!furi_log.ring) {
+        // Ring and drain thread are kept once started: producers may still hold records
+        FuriLogRing* ring = malloc(sizeof(FuriLogRing));
+        const osThreadAttr_t attr = {
+            .name = "LogDrain",
+            .stack_size = FURI_LOG_DEFERRED_THREAD_STACK_SIZE,
+            .priority = osPriorityLow,
+        };
+        ring->thread = osThreadNew(furi_log_drain_thread, ring, &attr);
+        furi_check(ring->thread);
+        furi_log.ring = ring;
+    }
+}
+
+void furi_log_set_deferred(bool deferred) {
+    if(deferred) {
+        furi_log_start_ring();
+    }
+    furi_log.deferred = deferred;
+}
+
+void furi_log_set_trace(FuriLogTraceWrite write) {
+    if(write) {
+        furi_log_start_ring();
+    }
+    furi_log.trace_write = write;
+}
+
+bool furi_log_is_deferred() {
+    return furi_log.deferred;
+}
+
+uint32_t furi_log_get_dropped() {
+    return furi_log.ring ? furi_log.ring->dropped_total : 0;
+}
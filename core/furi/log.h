@@ -3,6 +3,7 @@
 #include <stdio.h>
 #include <stdint.h>
 #include <stdarg.h>
+#include <stdbool.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -36,6 +37,7 @@ typedef enum {
 
 typedef void (*FuriLogPuts)(const char* data);
 typedef uint32_t (*FuriLogTimestamp)(void);
+typedef void (*FuriLogTraceWrite)(const uint8_t* data, size_t size);
 
 void furi_log_init();
 void furi_log_print(FuriLogLevel level, const char* format, ...);
@@ -44,6 +46,41 @@ FuriLogLevel furi_log_get_level();
 void furi_log_set_puts(FuriLogPuts puts);
 void furi_log_set_timestamp(FuriLogTimestamp timestamp);
 
+/** Enable or disable deferred logging
+ *
+ * In deferred mode furi_log_print only queues timestamp, format pointer and
+ * packed arguments into ring buffer, without locks or allocation, so it is
+ * cheap for time critical code and safe in ISR. Low priority thread formats
+ * and prints queued records. Records are dropped when ring is full, strings
+ * are truncated to 15 characters and format has to be a literal.
+ *
+ * @param deferred true to enable deferred mode
+ */
+void furi_log_set_deferred(bool deferred);
+
+/** Enable or disable binary trace output
+ *
+ * Records are queued as in deferred mode, but instead of being formatted
+ * they are written as binary frames carrying format token (address of format
+ * literal in firmware image), timestamp and packed arguments. Frames are
+ * decoded back to text on host with scripts/log_decode.py and firmware ELF.
+ *
+ * @param write output for trace frames, NULL to get back to text output
+ */
+void furi_log_set_trace(FuriLogTraceWrite write);
+
+/** Check whether deferred logging is enabled
+ *
+ * @return true if enabled
+ */
+bool furi_log_is_deferred();
+
+/** Get amount of records dropped in deferred mode because ring was full
+ *
+ * @return dropped records count since deferred mode was first enabled
+ */
+uint32_t furi_log_get_dropped();
+
 #define FURI_LOG_FORMAT(log_letter, tag, format) \
     FURI_LOG_CLR_##log_letter "[" #log_letter "][" tag "]: " FURI_LOG_CLR_RESET format "\r\n"
 #define FURI_LOG_SHOW(tag, format, log_level, log_letter, ...) \
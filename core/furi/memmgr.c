@@ -1,4 +1,5 @@
 #include "memmgr.h"
+#include "memmgr_heap.h"
 #include <string.h>
 
 extern void* pvPortMalloc(size_t xSize);
@@ -8,7 +9,7 @@ extern size_t xPortGetTotalHeapSize(void);
 extern size_t xPortGetMinimumEverFreeHeapSize(void);
 
 void* malloc(size_t size) {
-    return pvPortMalloc(size);
+    return memmgr_heap_malloc(size, __builtin_return_address(0));
 }
 
 void free(void* ptr) {
@@ -21,7 +22,7 @@ void* realloc(void* ptr, size_t size) {
         return NULL;
     }
 
-    void* p = pvPortMalloc(size);
+    void* p = memmgr_heap_malloc(size, __builtin_return_address(0));
     if(ptr != NULL) {
         memcpy(p, ptr, size);
         vPortFree(ptr);
@@ -31,7 +32,7 @@ void* realloc(void* ptr, size_t size) {
 }
 
 void* calloc(size_t count, size_t size) {
-    return pvPortMalloc(count * size);
+    return memmgr_heap_malloc(count * size, __builtin_return_address(0));
 }
 
 char* strdup(const char* s) {
@@ -41,7 +42,7 @@ char* strdup(const char* s) {
     }
 
     size_t siz = strlen(s) + 1;
-    char* y = pvPortMalloc(siz);
+    char* y = memmgr_heap_malloc(siz, __builtin_return_address(0));
     memcpy(y, s, siz);
 
     return y;
@@ -60,7 +61,7 @@ size_t memmgr_get_minimum_free_heap(void) {
 }
 
 void* __wrap__malloc_r(struct _reent* r, size_t size) {
-    return pvPortMalloc(size);
+    return memmgr_heap_malloc(size, __builtin_return_address(0));
 }
 
 void __wrap__free_r(struct _reent* r, void* ptr) {
@@ -68,7 +69,7 @@ void __wrap__free_r(struct _reent* r, void* ptr) {
 }
 
 void* __wrap__calloc_r(struct _reent* r, size_t count, size_t size) {
-    return calloc(count, size);
+    return memmgr_heap_malloc(count * size, __builtin_return_address(0));
 }
 
 void* __wrap__realloc_r(struct _reent* r, void* ptr, size_t size) {
@@ -37,6 +37,8 @@
 #include "memmgr_heap.h"
 #include "check.h"
 #include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
 #include <cmsis_os2.h>
 #include <stm32wbxx.h>
 #include <furi_hal_console.h>
@@ -114,6 +116,95 @@ static size_t xBlockAllocatedBit = 0;
 /* Furi heap extension */
 #include <m-dict.h>
 
+/* Size class pools in front of heap: small objects live in slabs carved from one
+region at heap init, alloc and free are O(1). Slab is assigned to size class on
+demand and returned to empty list once all its objects are freed. Allocations
+fall back to heap when region is exhausted. Region space not taken by objects is
+reported as free heap, so small allocations are visible in free heap size. */
+#define MEMMGR_HEAP_POOL_CLASSES 4
+#define MEMMGR_HEAP_POOL_OBJECT_MIN 16
+#define MEMMGR_HEAP_POOL_OBJECT_MAX (MEMMGR_HEAP_POOL_OBJECT_MIN << (MEMMGR_HEAP_POOL_CLASSES - 1))
+#define MEMMGR_HEAP_POOL_SLAB_SIZE 1024
+#define MEMMGR_HEAP_POOL_SLABS 16
+#define MEMMGR_HEAP_POOL_REGION_SIZE (MEMMGR_HEAP_POOL_SLAB_SIZE * MEMMGR_HEAP_POOL_SLABS)
+
+typedef struct MemmgrHeapPoolSlab {
+    struct MemmgrHeapPoolSlab* next;
+    struct MemmgrHeapPoolSlab* prev;
+    uint64_t allocated; /* objects bitmap */
+    uint16_t used;
+    uint16_t capacity;
+    uint16_t object_size;
+} MemmgrHeapPoolSlab;
+
+#define MEMMGR_HEAP_POOL_SLAB_HEADER \
+    ((sizeof(MemmgrHeapPoolSlab) + portBYTE_ALIGNMENT_MASK) & ~((size_t)portBYTE_ALIGNMENT_MASK))
+
+static uint8_t* memmgr_heap_pool_region = NULL;
+static MemmgrHeapPoolSlab* memmgr_heap_pool_partial[MEMMGR_HEAP_POOL_CLASSES] = {0};
+static MemmgrHeapPoolSlab* memmgr_heap_pool_empty = NULL;
+static volatile bool memmgr_heap_pool_enabled = true;
+static MemmgrHeapPoolStats memmgr_heap_pool_stats = {0};
+
+static void memmgr_heap_pool_list_push(MemmgrHeapPoolSlab** head, MemmgrHeapPoolSlab* slab) {
+    slab->prev = NULL;
+    slab->next = *head;
+    if(*head) (*head)->prev = slab;
+    *head = slab;
+}
+
+static void memmgr_heap_pool_list_remove(MemmgrHeapPoolSlab** head, MemmgrHeapPoolSlab* slab) {
+    if(slab->prev) {
+        slab->prev->next = slab->next;
+    } else {
+        *head = slab->next;
+    }
+    if(slab->next) slab->next->prev = slab->prev;
+    slab->next = NULL;
+    slab->prev = NULL;
+}
+
+/* Free heap bytes including pool space not taken by objects */
+static inline size_t memmgr_heap_free_bytes() {
+    size_t pool_free = 0;
+    if(memmgr_heap_pool_region) {
+        pool_free = MEMMGR_HEAP_POOL_REGION_SIZE - memmgr_heap_pool_stats.used;
+    }
+    return xFreeBytesRemaining + pool_free;
+}
+
+static inline void memmgr_heap_update_minimum_free() {
+    size_t free_bytes = memmgr_heap_free_bytes();
+    if(free_bytes < xMinimumEverFreeBytesRemaining) {
+        xMinimumEverFreeBytesRemaining = free_bytes;
+    }
+}
+
+/* Must be called with scheduler suspended, right after heap init */
+static void memmgr_heap_pool_init() {
+    memmgr_heap_pool_region = memmgr_heap_malloc(MEMMGR_HEAP_POOL_REGION_SIZE, NULL);
+    for(size_t i = 0; i < MEMMGR_HEAP_POOL_SLABS; i++) {
+        MemmgrHeapPoolSlab* slab =
+            (void*)(memmgr_heap_pool_region + i * MEMMGR_HEAP_POOL_SLAB_SIZE);
+        memmgr_heap_pool_list_push(&memmgr_heap_pool_empty, slab);
+    }
+    memmgr_heap_pool_stats.slabs_total = MEMMGR_HEAP_POOL_SLABS;
+    // Empty region is free memory, don't count it as ever used
+    xMinimumEverFreeBytesRemaining = memmgr_heap_free_bytes();
+}
+
+static inline MemmgrHeapPoolSlab* memmgr_heap_pool_get_slab(const void* pointer) {
+    if(!memmgr_heap_pool_region) return NULL;
+    size_t offset = (const uint8_t*)pointer - memmgr_heap_pool_region;
+    if(offset >= MEMMGR_HEAP_POOL_REGION_SIZE) return NULL;
+    return (void*)(memmgr_heap_pool_region + offset - offset % MEMMGR_HEAP_POOL_SLAB_SIZE);
+}
+
+static inline size_t memmgr_heap_pool_get_index(MemmgrHeapPoolSlab* slab, const void* pointer) {
+    return ((const uint8_t*)pointer - ((uint8_t*)slab + MEMMGR_HEAP_POOL_SLAB_HEADER)) /
+           slab->object_size;
+}
+
 /* Allocation tracking types */
 DICT_DEF2(MemmgrHeapAllocDict, uint32_t, uint32_t)
 DICT_DEF2(
@@ -171,7 +262,13 @@ size_t memmgr_heap_get_thread_memory(osThreadId_t thread_id) {
                 !MemmgrHeapAllocDict_end_p(alloc_dict_it);
                 MemmgrHeapAllocDict_next(alloc_dict_it)) {
                 MemmgrHeapAllocDict_itref_t* data = MemmgrHeapAllocDict_ref(alloc_dict_it);
-                if(data->key != 0) {
+                MemmgrHeapPoolSlab* slab = memmgr_heap_pool_get_slab((void*)data->key);
+                if(slab) {
+                    size_t index = memmgr_heap_pool_get_index(slab, (void*)data->key);
+                    if(slab->allocated & (1ULL << index)) {
+                        leftovers += data->value;
+                    }
+                } else if(data->key != 0) {
                     uint8_t* puc = (uint8_t*)data->key;
                     puc -= xHeapStructSize;
                     BlockLink_t* pxLink = (void*)puc;
@@ -217,6 +314,289 @@ static inline void traceFREE(void* pointer, size_t size) {
     }
 }
 
+/* Allocation profiler state, updated with scheduler suspended */
+static MemmgrHeapProfile memmgr_heap_profile = {0};
+static uint32_t memmgr_heap_profile_counter = 0;
+
+static inline size_t memmgr_heap_profile_used() {
+    return ((size_t)&__heap_end__ - (size_t)&__heap_start__) - memmgr_heap_free_bytes();
+}
+
+static uint8_t memmgr_heap_profile_size_class(size_t size) {
+    uint8_t size_class = 0;
+    size_t class_size = 8;
+    while(size > class_size && size_class < MEMMGR_HEAP_PROFILE_SIZE_CLASSES - 1) {
+        class_size <<= 1;
+        size_class++;
+    }
+    return size_class;
+}
+
+/* Must be called with scheduler suspended */
+static uint8_t memmgr_heap_fragmentation(size_t* max_free_block, uint32_t* free_blocks) {
+    size_t max_size = 0;
+    uint32_t count = 0;
+    for(BlockLink_t* pxBlock = xStart.pxNextFreeBlock; pxBlock->pxNextFreeBlock != NULL;
+        pxBlock = pxBlock->pxNextFreeBlock) {
+        if(pxBlock->xBlockSize > max_size) max_size = pxBlock->xBlockSize;
+        count++;
+    }
+    if(max_free_block) *max_free_block = max_size;
+    if(free_blocks) *free_blocks = count;
+    if(xFreeBytesRemaining == 0) return 0;
+    return 100 - (max_size * 100) / xFreeBytesRemaining;
+}
+
+static void memmgr_heap_profile_sample(size_t size, void* caller) {
+    osThreadId_t thread_id = osThreadGetId();
+    MemmgrHeapProfileCaller* entry = NULL;
+    MemmgrHeapProfileCaller* min_entry = &memmgr_heap_profile.callers[0];
+
+    for(size_t i = 0; i < MEMMGR_HEAP_PROFILE_CALLERS; i++) {
+        MemmgrHeapProfileCaller* item = &memmgr_heap_profile.callers[i];
+        if(item->caller == (uint32_t)caller && item->thread_id == (uint32_t)thread_id) {
+            entry = item;
+            break;
+        }
+        if(item->count < min_entry->count) min_entry = item;
+    }
+
+    if(!entry) {
+        // Space saving: evict least sampled call site, new one inherits its count
+        entry = min_entry;
+        entry->caller = (uint32_t)caller;
+        entry->thread_id = (uint32_t)thread_id;
+        const char* name = thread_id ? osThreadGetName(thread_id) : NULL;
+        strncpy(entry->thread_name, name ? name : "", MEMMGR_HEAP_PROFILE_THREAD_NAME_SIZE - 1);
+        entry->thread_name[MEMMGR_HEAP_PROFILE_THREAD_NAME_SIZE - 1] = '\0';
+        entry->bytes = 0;
+    }
+    entry->count++;
+    entry->bytes += size;
+}
+
+static inline void memmgr_heap_profile_malloc(size_t size, size_t block_size, void* caller) {
+    if(!memmgr_heap_profile.enabled) return;
+
+    uint8_t size_class = memmgr_heap_profile_size_class(block_size - xHeapStructSize);
+    memmgr_heap_profile.allocations++;
+    memmgr_heap_profile.size_class_allocations[size_class]++;
+    memmgr_heap_profile.size_class_live[size_class]++;
+
+    size_t used = memmgr_heap_profile_used();
+    if(used > memmgr_heap_profile.used_peak) memmgr_heap_profile.used_peak = used;
+
+    if(++memmgr_heap_profile_counter >= memmgr_heap_profile.sample_rate) {
+        memmgr_heap_profile_counter = 0;
+        memmgr_heap_profile_sample(size, caller);
+    }
+}
+
+static inline void memmgr_heap_profile_free(size_t block_size) {
+    if(!memmgr_heap_profile.enabled) return;
+
+    uint8_t size_class = memmgr_heap_profile_size_class(block_size - xHeapStructSize);
+    memmgr_heap_profile.frees++;
+    // Blocks allocated before start are not accounted
+    if(memmgr_heap_profile.size_class_live[size_class]) {
+        memmgr_heap_profile.size_class_live[size_class]--;
+    }
+}
+
+void memmgr_heap_profile_start(uint32_t sample_rate) {
+    vTaskSuspendAll();
+    {
+        memset(&memmgr_heap_profile, 0, sizeof(MemmgrHeapProfile));
+        memmgr_heap_profile.sample_rate =
+            sample_rate ? sample_rate : MEMMGR_HEAP_PROFILE_SAMPLE_RATE_DEFAULT;
+        memmgr_heap_profile.used_peak = memmgr_heap_profile_used();
+        memmgr_heap_profile_counter = 0;
+        memmgr_heap_profile.enabled = true;
+    }
+    (void)xTaskResumeAll();
+}
+
+void memmgr_heap_profile_stop() {
+    vTaskSuspendAll();
+    { memmgr_heap_profile.enabled = false; }
+    (void)xTaskResumeAll();
+}
+
+bool memmgr_heap_profile_is_available() {
+    return memmgr_heap_profile.enabled || memmgr_heap_profile.sample_rate;
+}
+
+void memmgr_heap_profile_get(MemmgrHeapProfile* profile) {
+    furi_assert(profile);
+    vTaskSuspendAll();
+    {
+        *profile = memmgr_heap_profile;
+        profile->free = memmgr_heap_free_bytes();
+        profile->fragmentation =
+            memmgr_heap_fragmentation(&profile->max_free_block, &profile->free_blocks);
+        // Free list walk is too slow for allocation path, peak is tracked on snapshots
+        if(memmgr_heap_profile.enabled &&
+           profile->fragmentation > memmgr_heap_profile.fragmentation_peak) {
+            memmgr_heap_profile.fragmentation_peak = profile->fragmentation;
+        }
+        profile->fragmentation_peak = memmgr_heap_profile.fragmentation_peak;
+    }
+    (void)xTaskResumeAll();
+}
+
+void memmgr_heap_profile_export(MemmgrHeapProfileCallback callback, void* context) {
+    furi_assert(callback);
+
+    MemmgrHeapProfile* profile = malloc(sizeof(MemmgrHeapProfile));
+    memmgr_heap_profile_get(profile);
+
+    char key[32];
+    char value[48];
+
+    callback("heap_profile_enabled", profile->enabled ? "true" : "false", false, context);
+    snprintf(value, sizeof(value), "%lu", profile->sample_rate);
+    callback("heap_profile_sample_rate", value, false, context);
+    snprintf(value, sizeof(value), "%lu", profile->allocations);
+    callback("heap_profile_allocations", value, false, context);
+    snprintf(value, sizeof(value), "%lu", profile->frees);
+    callback("heap_profile_frees", value, false, context);
+    snprintf(value, sizeof(value), "%u", profile->used_peak);
+    callback("heap_profile_used_peak", value, false, context);
+    snprintf(value, sizeof(value), "%u", profile->free);
+    callback("heap_profile_free", value, false, context);
+    snprintf(value, sizeof(value), "%u", profile->max_free_block);
+    callback("heap_profile_max_free_block", value, false, context);
+    snprintf(value, sizeof(value), "%lu", profile->free_blocks);
+    callback("heap_profile_free_blocks", value, false, context);
+    snprintf(value, sizeof(value), "%u", profile->fragmentation);
+    callback("heap_profile_fragmentation", value, false, context);
+    snprintf(value, sizeof(value), "%u", profile->fragmentation_peak);
+    callback("heap_profile_fragmentation_peak", value, false, context);
+
+    // size class: allocations live
+    for(size_t i = 0; i < MEMMGR_HEAP_PROFILE_SIZE_CLASSES; i++) {
+        if(i < MEMMGR_HEAP_PROFILE_SIZE_CLASSES - 1) {
+            snprintf(key, sizeof(key), "heap_profile_size_%u", 8 << i);
+        } else {
+            snprintf(key, sizeof(key), "heap_profile_size_more");
+        }
+        snprintf(
+            value,
+            sizeof(value),
+            "%lu %lu",
+            profile->size_class_allocations[i],
+            profile->size_class_live[i]);
+        callback(key, value, false, context);
+    }
+
+    // caller: address thread count bytes
+    size_t last = MEMMGR_HEAP_PROFILE_CALLERS;
+    for(size_t i = 0; i < MEMMGR_HEAP_PROFILE_CALLERS; i++) {
+        if(profile->callers[i].count) last = i;
+    }
+    for(size_t i = 0; i < MEMMGR_HEAP_PROFILE_CALLERS; i++) {
+        MemmgrHeapProfileCaller* caller = &profile->callers[i];
+        if(!caller->count) continue;
+        snprintf(key, sizeof(key), "heap_profile_caller_%u", i);
+        snprintf(
+            value,
+            sizeof(value),
+            "0x%08lx %s %lu %lu",
+            caller->caller,
+            caller->thread_name,
+            caller->count,
+            caller->bytes);
+        callback(key, value, i == last, context);
+    }
+    if(last == MEMMGR_HEAP_PROFILE_CALLERS) {
+        callback("heap_profile_callers", "0", true, context);
+    }
+
+    free(profile);
+}
+
+/* Must be called with scheduler suspended */
+static void* memmgr_heap_pool_alloc(size_t size, void* caller) {
+    uint8_t size_class = 0;
+    while((size_t)(MEMMGR_HEAP_POOL_OBJECT_MIN << size_class) < size) {
+        size_class++;
+    }
+
+    MemmgrHeapPoolSlab* slab = memmgr_heap_pool_partial[size_class];
+    if(!slab) {
+        slab = memmgr_heap_pool_empty;
+        if(!slab) {
+            memmgr_heap_pool_stats.fallbacks++;
+            return NULL;
+        }
+        memmgr_heap_pool_list_remove(&memmgr_heap_pool_empty, slab);
+        slab->object_size = MEMMGR_HEAP_POOL_OBJECT_MIN << size_class;
+        slab->capacity =
+            (MEMMGR_HEAP_POOL_SLAB_SIZE - MEMMGR_HEAP_POOL_SLAB_HEADER) / slab->object_size;
+        furi_assert(slab->capacity <= 64);
+        slab->allocated = 0;
+        slab->used = 0;
+        memmgr_heap_pool_list_push(&memmgr_heap_pool_partial[size_class], slab);
+        memmgr_heap_pool_stats.slabs_used++;
+    }
+
+    // Lowest free object, objects are zeroed on free
+    uint8_t index = __builtin_ctzll(~slab->allocated);
+    slab->allocated |= 1ULL << index;
+    slab->used++;
+    if(slab->used == slab->capacity) {
+        memmgr_heap_pool_list_remove(&memmgr_heap_pool_partial[size_class], slab);
+    }
+
+    void* pointer =
+        (uint8_t*)slab + MEMMGR_HEAP_POOL_SLAB_HEADER + (size_t)index * slab->object_size;
+    memmgr_heap_pool_stats.allocations++;
+    memmgr_heap_pool_stats.used += slab->object_size;
+    memmgr_heap_update_minimum_free();
+    traceMALLOC(pointer, slab->object_size);
+    memmgr_heap_profile_malloc(size, slab->object_size + xHeapStructSize, caller);
+    return pointer;
+}
+
+/* Must be called with scheduler suspended */
+static void memmgr_heap_pool_free(MemmgrHeapPoolSlab* slab, void* pointer) {
+    size_t index = memmgr_heap_pool_get_index(slab, pointer);
+    furi_check(index < slab->capacity);
+    furi_check(slab->allocated & (1ULL << index));
+
+    traceFREE(pointer, slab->object_size);
+    memmgr_heap_profile_free(slab->object_size + xHeapStructSize);
+    memset(pointer, 0, slab->object_size);
+    memmgr_heap_pool_stats.used -= slab->object_size;
+
+    uint8_t size_class = __builtin_ctz(slab->object_size / MEMMGR_HEAP_POOL_OBJECT_MIN);
+    if(slab->used == slab->capacity) {
+        memmgr_heap_pool_list_push(&memmgr_heap_pool_partial[size_class], slab);
+    }
+    slab->allocated &= ~(1ULL << index);
+    slab->used--;
+    if(slab->used == 0) {
+        memmgr_heap_pool_list_remove(&memmgr_heap_pool_partial[size_class], slab);
+        memmgr_heap_pool_list_push(&memmgr_heap_pool_empty, slab);
+        memmgr_heap_pool_stats.slabs_used--;
+    }
+}
+
+void memmgr_heap_set_pool_enabled(bool enabled) {
+    memmgr_heap_pool_enabled = enabled;
+}
+
+bool memmgr_heap_is_pool_block(const void* pointer) {
+    return memmgr_heap_pool_get_slab(pointer) != NULL;
+}
+
+void memmgr_heap_get_pool_stats(MemmgrHeapPoolStats* stats) {
+    furi_assert(stats);
+    vTaskSuspendAll();
+    { *stats = memmgr_heap_pool_stats; }
+    (void)xTaskResumeAll();
+}
+
 size_t memmgr_heap_get_max_free_block() {
     size_t max_free_size = 0;
     BlockLink_t* pxBlock;
@@ -335,6 +715,10 @@ static void print_heap_free(void* ptr) {
 /*-----------------------------------------------------------*/
 
 void* pvPortMalloc(size_t xWantedSize) {
+    return memmgr_heap_malloc(xWantedSize, __builtin_return_address(0));
+}
+
+void* memmgr_heap_malloc(size_t xWantedSize, void* caller) {
     BlockLink_t *pxBlock, *pxPreviousBlock, *pxNewBlockLink;
     void* pvReturn = NULL;
     size_t to_wipe = xWantedSize;
@@ -354,12 +738,21 @@ void* pvPortMalloc(size_t xWantedSize) {
         {
             prvHeapInit();
             memmgr_heap_init();
+            memmgr_heap_pool_init();
         }
         (void)xTaskResumeAll();
     } else {
         mtCOVERAGE_TEST_MARKER();
     }
 
+    if(xWantedSize > 0 && xWantedSize <= MEMMGR_HEAP_POOL_OBJECT_MAX &&
+       memmgr_heap_pool_enabled) {
+        vTaskSuspendAll();
+        { pvReturn = memmgr_heap_pool_alloc(xWantedSize, caller); }
+        (void)xTaskResumeAll();
+        if(pvReturn) return pvReturn;
+    }
+
     vTaskSuspendAll();
     {
         /* Check the requested block size is not so large that the top bit is
@@ -430,14 +823,12 @@ void* pvPortMalloc(size_t xWantedSize) {
 
                     xFreeBytesRemaining -= pxBlock->xBlockSize;
 
-                    if(xFreeBytesRemaining < xMinimumEverFreeBytesRemaining) {
-                        xMinimumEverFreeBytesRemaining = xFreeBytesRemaining;
-                    } else {
-                        mtCOVERAGE_TEST_MARKER();
-                    }
+                    memmgr_heap_update_minimum_free();
 
                     /* The block is being returned - it is allocated and owned
                     by the application and has no "next" block. */
+                    memmgr_heap_profile_malloc(to_wipe, pxBlock->xBlockSize, caller);
+
                     pxBlock->xBlockSize |= xBlockAllocatedBit;
                     pxBlock->pxNextFreeBlock = NULL;
 
@@ -485,6 +876,14 @@ void vPortFree(void* pv) {
     uint8_t* puc = (uint8_t*)pv;
     BlockLink_t* pxLink;
 
+    MemmgrHeapPoolSlab* slab = memmgr_heap_pool_get_slab(pv);
+    if(slab) {
+        vTaskSuspendAll();
+        { memmgr_heap_pool_free(slab, pv); }
+        (void)xTaskResumeAll();
+        return;
+    }
+
     if(pv != NULL) {
         /* The memory being freed will have an BlockLink_t structure immediately
         before it. */
@@ -517,6 +916,7 @@ void vPortFree(void* pv) {
                     /* Add this block to the list of free blocks. */
                     xFreeBytesRemaining += pxLink->xBlockSize;
                     traceFREE(pv, pxLink->xBlockSize);
+                    memmgr_heap_profile_free(pxLink->xBlockSize);
                     memset(pv, 0, pxLink->xBlockSize - xHeapStructSize);
                     prvInsertBlockIntoFreeList(((BlockLink_t*)pxLink));
                 }
@@ -541,7 +941,7 @@ size_t xPortGetTotalHeapSize(void) {
 /*-----------------------------------------------------------*/
 
 size_t xPortGetFreeHeapSize(void) {
-    return xFreeBytesRemaining;
+    return memmgr_heap_free_bytes();
 }
 /*-----------------------------------------------------------*/
 
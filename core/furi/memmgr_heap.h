@@ -6,6 +6,7 @@
 #pragma once
 
 #include <stdint.h>
+#include <stdbool.h>
 #include <cmsis_os2.h>
 
 #ifdef __cplusplus
@@ -14,6 +15,66 @@ extern "C" {
 
 #define MEMMGR_HEAP_UNKNOWN 0xFFFFFFFF
 
+/** Profiler size classes: up to 8, 16, ... 4096 bytes and larger */
+#define MEMMGR_HEAP_PROFILE_SIZE_CLASSES 11
+#define MEMMGR_HEAP_PROFILE_CALLERS 24
+#define MEMMGR_HEAP_PROFILE_THREAD_NAME_SIZE 12
+#define MEMMGR_HEAP_PROFILE_SAMPLE_RATE_DEFAULT 8
+
+/** Sampled allocation call site */
+typedef struct {
+    uint32_t caller; /**< return address of malloc call */
+    uint32_t thread_id;
+    char thread_name[MEMMGR_HEAP_PROFILE_THREAD_NAME_SIZE];
+    uint32_t count; /**< sampled allocations, may be overestimated after eviction */
+    uint32_t bytes; /**< sampled requested bytes */
+} MemmgrHeapProfileCaller;
+
+/** Allocation profile, collected since memmgr_heap_profile_start */
+typedef struct {
+    bool enabled;
+    uint32_t sample_rate; /**< one of sample_rate allocations is recorded in callers */
+    uint32_t allocations;
+    uint32_t frees;
+    uint32_t size_class_allocations[MEMMGR_HEAP_PROFILE_SIZE_CLASSES];
+    uint32_t size_class_live[MEMMGR_HEAP_PROFILE_SIZE_CLASSES]; /**< approximate */
+    size_t used_peak; /**< max used heap bytes */
+    size_t free; /**< free heap bytes right now */
+    size_t max_free_block; /**< max contiguous free block right now */
+    uint32_t free_blocks; /**< free blocks count right now */
+    uint8_t fragmentation; /**< percent of free heap not in the largest block */
+    uint8_t fragmentation_peak; /**< worst fragmentation seen on snapshots */
+    MemmgrHeapProfileCaller callers[MEMMGR_HEAP_PROFILE_CALLERS];
+} MemmgrHeapProfile;
+
+/** Small object pools statistics */
+typedef struct {
+    uint32_t allocations; /**< allocations served by pools */
+    uint32_t fallbacks; /**< small allocations passed to heap: pools were exhausted */
+    uint32_t slabs_used; /**< slabs assigned to size classes */
+    uint32_t slabs_total;
+    size_t used; /**< bytes taken by pooled objects, the rest of pools is free heap */
+} MemmgrHeapPoolStats;
+
+/** Profile export callback, called for every key-value pair
+ *
+ * @param      key      profile field name
+ * @param      value    profile field value
+ * @param      last     whether the passed key-value pair is the last one
+ * @param      context  context to pass to callback
+ */
+typedef void (
+    *MemmgrHeapProfileCallback)(const char* key, const char* value, bool last, void* context);
+
+/** Allocate memory from heap or small object pools
+ *
+ * @param      size    requested size
+ * @param      caller  call site to account allocation to in profile
+ *
+ * @return     pointer to allocated memory, NULL on failure
+ */
+void* memmgr_heap_malloc(size_t size, void* caller);
+
 /** Memmgr heap enable thread allocation tracking
  *
  * @param      thread_id  - thread id to track
@@ -44,6 +105,62 @@ size_t memmgr_heap_get_max_free_block();
  */
 void memmgr_heap_printf_free_blocks();
 
+/** Enable or disable small object pools for new allocations
+ *
+ * Pooled blocks are still freed to pools. Intended for benchmarking.
+ *
+ * @param      enabled  true to serve small allocations from pools
+ */
+void memmgr_heap_set_pool_enabled(bool enabled);
+
+/** Check if block belongs to small object pools
+ *
+ * @param      pointer  block pointer
+ *
+ * @return     true if block was allocated from pools
+ */
+bool memmgr_heap_is_pool_block(const void* pointer);
+
+/** Get small object pools statistics
+ *
+ * @param      stats  MemmgrHeapPoolStats to fill
+ */
+void memmgr_heap_get_pool_stats(MemmgrHeapPoolStats* stats);
+
+/** Start allocation profiling, resets previously collected profile
+ *
+ * Adds size class accounting to every allocation and records call site of
+ * every sample_rate allocation.
+ *
+ * @param      sample_rate  caller sampling rate, 0 for default
+ */
+void memmgr_heap_profile_start(uint32_t sample_rate);
+
+/** Stop allocation profiling, collected profile is kept
+ */
+void memmgr_heap_profile_stop();
+
+/** Check if there is allocation profile to export
+ *
+ * @return     true if profiling is running or was running since boot
+ */
+bool memmgr_heap_profile_is_available();
+
+/** Get allocation profile and current fragmentation
+ *
+ * @param      profile  MemmgrHeapProfile to fill
+ */
+void memmgr_heap_profile_get(MemmgrHeapProfile* profile);
+
+/** Export allocation profile as key-value pairs
+ *
+ * Suitable for CLI and RPC, callback is called outside of heap lock.
+ *
+ * @param      callback  callback to provide with data
+ * @param      context   context to pass to callback
+ */
+void memmgr_heap_profile_export(MemmgrHeapProfileCallback callback, void* context);
+
 #ifdef __cplusplus
 }
 #endif
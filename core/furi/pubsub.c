@@ -2,28 +2,85 @@
 #include "memmgr.h"
 #include "check.h"
 
-#include <m-list.h>
+#include <stdbool.h>
+#include <string.h>
 #include <cmsis_os2.h>
+#include <furi_hal_delay.h>
+#include <stm32wbxx.h>
 
 struct FuriPubSubSubscription {
     FuriPubSubCallback callback;
     void* callback_context;
+    size_t snapshots; /**< number of snapshots referencing subscription */
+    volatile bool active;
 };
 
-LIST_DEF(FuriPubSubSubscriptionList, FuriPubSubSubscription, M_POD_OPLIST);
+/* Immutable array of subscriptions: publishers iterate it without holding mutex,
+ * subscribe and unsubscribe build new one and swap it in under mutex. */
+typedef struct {
+    size_t count;
+    FuriPubSubSubscription* items[];
+} FuriPubSubSnapshot;
+
+/* Publish in progress, lives on publisher stack */
+typedef struct FuriPubSubPublisher {
+    osThreadId_t thread;
+    FuriPubSubSnapshot* snapshot;
+    const FuriPubSubSubscription* running; /**< subscription which callback is being run */
+    struct FuriPubSubPublisher* next;
+} FuriPubSubPublisher;
 
 struct FuriPubSub {
-    FuriPubSubSubscriptionList_t items;
     osMutexId_t mutex;
+    FuriPubSubSnapshot* snapshot;
+    FuriPubSubPublisher* publishers;
+    FuriPubSubStats stats;
 };
 
+static FuriPubSubSnapshot* furi_pubsub_snapshot_alloc(size_t count) {
+    FuriPubSubSnapshot* snapshot =
+        malloc(sizeof(FuriPubSubSnapshot) + sizeof(FuriPubSubSubscription*) * count);
+    snapshot->count = count;
+    return snapshot;
+}
+
+static void furi_pubsub_snapshot_free(FuriPubSubSnapshot* snapshot) {
+    for(size_t i = 0; i < snapshot->count; i++) {
+        FuriPubSubSubscription* item = snapshot->items[i];
+        item->snapshots--;
+        if(item->snapshots == 0) free(item);
+    }
+    free(snapshot);
+}
+
+/* Must be called with mutex taken */
+static void furi_pubsub_swap_snapshot(FuriPubSub* pubsub, FuriPubSubSnapshot* snapshot) {
+    for(size_t i = 0; i < snapshot->count; i++) {
+        snapshot->items[i]->snapshots++;
+    }
+
+    FuriPubSubSnapshot* previous = pubsub->snapshot;
+    pubsub->snapshot = snapshot;
+
+    bool in_use = false;
+    for(FuriPubSubPublisher* publisher = pubsub->publishers; publisher;
+        publisher = publisher->next) {
+        if(publisher->snapshot == previous) {
+            in_use = true;
+            break;
+        }
+    }
+    // Otherwise last publisher using it frees it
+    if(!in_use) furi_pubsub_snapshot_free(previous);
+}
+
 FuriPubSub* furi_pubsub_alloc() {
     FuriPubSub* pubsub = malloc(sizeof(FuriPubSub));
 
     pubsub->mutex = osMutexNew(NULL);
     furi_assert(pubsub->mutex);
 
-    FuriPubSubSubscriptionList_init(pubsub->items);
+    pubsub->snapshot = furi_pubsub_snapshot_alloc(0);
 
     return pubsub;
 }
@@ -31,9 +88,10 @@ FuriPubSub* furi_pubsub_alloc() {
 void furi_pubsub_free(FuriPubSub* pubsub) {
     furi_assert(pubsub);
 
-    furi_check(FuriPubSubSubscriptionList_size(pubsub->items) == 0);
+    furi_check(pubsub->snapshot->count == 0);
+    furi_check(pubsub->publishers == NULL);
 
-    FuriPubSubSubscriptionList_clear(pubsub->items);
+    furi_pubsub_snapshot_free(pubsub->snapshot);
 
     furi_check(osMutexDelete(pubsub->mutex) == osOK);
 
@@ -42,13 +100,21 @@ void furi_pubsub_free(FuriPubSub* pubsub) {
 
 FuriPubSubSubscription*
     furi_pubsub_subscribe(FuriPubSub* pubsub, FuriPubSubCallback callback, void* callback_context) {
-    furi_check(osMutexAcquire(pubsub->mutex, osWaitForever) == osOK);
-    // put uninitialized item to the list
-    FuriPubSubSubscription* item = FuriPubSubSubscriptionList_push_raw(pubsub->items);
+    furi_assert(pubsub);
+    furi_assert(callback);
 
-    // initialize item
+    FuriPubSubSubscription* item = malloc(sizeof(FuriPubSubSubscription));
     item->callback = callback;
     item->callback_context = callback_context;
+    item->active = true;
+
+    furi_check(osMutexAcquire(pubsub->mutex, osWaitForever) == osOK);
+
+    FuriPubSubSnapshot* current = pubsub->snapshot;
+    FuriPubSubSnapshot* snapshot = furi_pubsub_snapshot_alloc(current->count + 1);
+    memcpy(snapshot->items, current->items, sizeof(FuriPubSubSubscription*) * current->count);
+    snapshot->items[current->count] = item;
+    furi_pubsub_swap_snapshot(pubsub, snapshot);
 
     furi_check(osMutexRelease(pubsub->mutex) == osOK);
 
@@ -60,36 +126,117 @@ void furi_pubsub_unsubscribe(FuriPubSub* pubsub, FuriPubSubSubscription* pubsub_
     furi_assert(pubsub_subscription);
 
     furi_check(osMutexAcquire(pubsub->mutex, osWaitForever) == osOK);
-    bool result = false;
-
-    // iterate over items
-    FuriPubSubSubscriptionList_it_t it;
-    for(FuriPubSubSubscriptionList_it(it, pubsub->items); !FuriPubSubSubscriptionList_end_p(it);
-        FuriPubSubSubscriptionList_next(it)) {
-        const FuriPubSubSubscription* item = FuriPubSubSubscriptionList_cref(it);
-
-        // if the iterator is equal to our element
-        if(item == pubsub_subscription) {
-            FuriPubSubSubscriptionList_remove(pubsub->items, it);
-            result = true;
-            break;
-        }
+
+    FuriPubSubSnapshot* current = pubsub->snapshot;
+    size_t index = 0;
+    while(index < current->count && current->items[index] != pubsub_subscription) {
+        index++;
     }
+    furi_check(index < current->count);
+
+    // Skipped by publishers still iterating older snapshots
+    __atomic_store_n(&pubsub_subscription->active, false, __ATOMIC_SEQ_CST);
+
+    FuriPubSubSnapshot* snapshot = furi_pubsub_snapshot_alloc(current->count - 1);
+    memcpy(snapshot->items, current->items, sizeof(FuriPubSubSubscription*) * index);
+    memcpy(
+        &snapshot->items[index],
+        &current->items[index + 1],
+        sizeof(FuriPubSubSubscription*) * (current->count - index - 1));
+    furi_pubsub_swap_snapshot(pubsub, snapshot);
 
     furi_check(osMutexRelease(pubsub->mutex) == osOK);
-    furi_check(result);
+
+    // Callback may be running in other thread right now: wait for it to complete,
+    // so caller can release callback context. Publish on our own thread is the caller.
+    // Publishers of other subscriptions, however slow, are not waited for.
+    osThreadId_t thread = osThreadGetId();
+    while(true) {
+        bool busy = false;
+        furi_check(osMutexAcquire(pubsub->mutex, osWaitForever) == osOK);
+        for(FuriPubSubPublisher* publisher = pubsub->publishers; publisher;
+            publisher = publisher->next) {
+            if(publisher->thread != thread &&
+               __atomic_load_n(&publisher->running, __ATOMIC_SEQ_CST) == pubsub_subscription) {
+                busy = true;
+                break;
+            }
+        }
+        furi_check(osMutexRelease(pubsub->mutex) == osOK);
+        if(!busy) break;
+        osDelay(1);
+    }
 }
 
 void furi_pubsub_publish(FuriPubSub* pubsub, void* message) {
+    furi_assert(pubsub);
+
+    FuriPubSubPublisher publisher = {.thread = osThreadGetId()};
+
+    furi_check(osMutexAcquire(pubsub->mutex, osWaitForever) == osOK);
+    publisher.snapshot = pubsub->snapshot;
+    publisher.next = pubsub->publishers;
+    pubsub->publishers = &publisher;
+    furi_check(osMutexRelease(pubsub->mutex) == osOK);
+
+    // iterate over subscribers without holding mutex
+    uint32_t max_time = 0;
+    FuriPubSubCallback max_callback = NULL;
+    FuriPubSubSnapshot* snapshot = publisher.snapshot;
+    for(size_t i = 0; i < snapshot->count; i++) {
+        const FuriPubSubSubscription* item = snapshot->items[i];
+        // Announce callback before checking active, unsubscribe does it in reverse order:
+        // either it sees callback running or we see subscription removed
+        __atomic_store_n(&publisher.running, item, __ATOMIC_SEQ_CST);
+        if(__atomic_load_n(&item->active, __ATOMIC_SEQ_CST)) {
+            uint32_t start = DWT->CYCCNT;
+            item->callback(message, item->callback_context);
+            uint32_t time = DWT->CYCCNT - start;
+            if(time > max_time) {
+                max_time = time;
+                max_callback = item->callback;
+            }
+        }
+        __atomic_store_n(&publisher.running, NULL, __ATOMIC_SEQ_CST);
+    }
+    max_time /= furi_hal_delay_instructions_per_microsecond();
+
     furi_check(osMutexAcquire(pubsub->mutex, osWaitForever) == osOK);
+    FuriPubSubPublisher** link = &pubsub->publishers;
+    while(*link != &publisher) {
+        link = &(*link)->next;
+    }
+    *link = publisher.next;
+
+    bool in_use = (snapshot == pubsub->snapshot);
+    for(FuriPubSubPublisher* other = pubsub->publishers; other && !in_use; other = other->next) {
+        in_use = (other->snapshot == snapshot);
+    }
+    // Snapshot was swapped while we were publishing and we are the last one using it
+    if(!in_use) furi_pubsub_snapshot_free(snapshot);
 
-    // iterate over subscribers
-    FuriPubSubSubscriptionList_it_t it;
-    for(FuriPubSubSubscriptionList_it(it, pubsub->items); !FuriPubSubSubscriptionList_end_p(it);
-        FuriPubSubSubscriptionList_next(it)) {
-        const FuriPubSubSubscription* item = FuriPubSubSubscriptionList_cref(it);
-        item->callback(message, item->callback_context);
+    pubsub->stats.publishes++;
+    if(max_callback && max_time >= pubsub->stats.max_callback_time) {
+        pubsub->stats.max_callback_time = max_time;
+        pubsub->stats.max_callback = max_callback;
     }
+    furi_check(osMutexRelease(pubsub->mutex) == osOK);
+}
+
+void furi_pubsub_get_stats(FuriPubSub* pubsub, FuriPubSubStats* stats) {
+    furi_assert(pubsub);
+    furi_assert(stats);
+
+    furi_check(osMutexAcquire(pubsub->mutex, osWaitForever) == osOK);
+    *stats = pubsub->stats;
+    stats->subscribers = pubsub->snapshot->count;
+    furi_check(osMutexRelease(pubsub->mutex) == osOK);
+}
 
+void furi_pubsub_reset_stats(FuriPubSub* pubsub) {
+    furi_assert(pubsub);
+
+    furi_check(osMutexAcquire(pubsub->mutex, osWaitForever) == osOK);
+    memset(&pubsub->stats, 0, sizeof(FuriPubSubStats));
     furi_check(osMutexRelease(pubsub->mutex) == osOK);
 }
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <stdint.h>
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -13,6 +15,14 @@ typedef struct FuriPubSub FuriPubSub;
 /** FuriPubSubSubscription type */
 typedef struct FuriPubSubSubscription FuriPubSubSubscription;
 
+/** FuriPubSub statistics */
+typedef struct {
+    uint32_t publishes; /**< messages published */
+    uint32_t subscribers; /**< current subscribers count */
+    uint32_t max_callback_time; /**< longest single callback run, microseconds */
+    FuriPubSubCallback max_callback; /**< callback that took max_callback_time */
+} FuriPubSubStats;
+
 /** Allocate FuriPubSub
  *
  * Reentrable, Not threadsafe, one owner
@@ -43,7 +53,8 @@ FuriPubSubSubscription*
 /** Unsubscribe from FuriPubSub
  * 
  * No use of `pubsub_subscription` allowed after call of this method
- * Threadsafe, Reentrable.
+ * Threadsafe, Reentrable. Waits for callback of this subscription to complete
+ * if it is being run by other thread, callback context can be released after call.
  *
  * @param      pubsub               pointer to FuriPubSub instance
  * @param      pubsub_subscription  pointer to FuriPubSubSubscription instance
@@ -52,13 +63,29 @@ void furi_pubsub_unsubscribe(FuriPubSub* pubsub, FuriPubSubSubscription* pubsub_
 
 /** Publish message to FuriPubSub
  *
- * Threadsafe, Reentrable.
+ * Threadsafe, Reentrable. Subscribers are called from snapshot taken at publish
+ * start, so slow subscriber doesn't block other publishers or (un)subscribe.
  * 
  * @param      pubsub   pointer to FuriPubSub instance
  * @param      message  message pointer to publish
  */
 void furi_pubsub_publish(FuriPubSub* pubsub, void* message);
 
+/** Get FuriPubSub statistics
+ *
+ * Threadsafe. Use max_callback address to find slow subscriber.
+ *
+ * @param      pubsub  pointer to FuriPubSub instance
+ * @param      stats   pointer to FuriPubSubStats to fill
+ */
+void furi_pubsub_get_stats(FuriPubSub* pubsub, FuriPubSubStats* stats);
+
+/** Reset FuriPubSub statistics
+ *
+ * @param      pubsub  pointer to FuriPubSub instance
+ */
+void furi_pubsub_reset_stats(FuriPubSub* pubsub);
+
 #ifdef __cplusplus
 }
 #endif
@@ -1,4 +1,5 @@
 #include <furi_hal_compress.h>
+#include <furi_hal_flash.h>
 
 #include <furi.h>
 #include <lib/heatshrink/heatshrink_encoder.h>
@@ -11,17 +12,39 @@
 
 #define FURI_HAL_COMPRESS_EXP_BUFF_SIZE (1 << FURI_HAL_COMPRESS_EXP_BUFF_SIZE_LOG)
 
+/* Icons bigger than this part of cache, like full screen animation frames,
+ * are not cached: cycling through them would evict everything else */
+#define FURI_HAL_COMPRESS_ICON_CACHE_ENTRY_DIV (8)
+
 typedef struct {
     uint8_t is_compressed;
     uint8_t reserved;
     uint16_t compressed_buff_size;
 } FuriHalCompressHeader;
 
+typedef struct FuriHalCompressIconCacheEntry FuriHalCompressIconCacheEntry;
+
+struct FuriHalCompressIconCacheEntry {
+    FuriHalCompressIconCacheEntry* next;
+    const uint8_t* icon_data;
+    size_t size;
+    uint8_t decoded[];
+};
+
+typedef struct {
+    FuriHalCompressIconCacheEntry* head; /**< most recently used first */
+    size_t size;
+    size_t used;
+    uint32_t hits;
+    uint32_t misses;
+} FuriHalCompressIconCache;
+
 typedef struct {
     heatshrink_decoder* decoder;
     uint8_t
         compress_buff[FURI_HAL_COMPRESS_EXP_BUFF_SIZE + FURI_HAL_COMPRESS_ICON_ENCODED_BUFF_SIZE];
     uint8_t decoded_buff[FURI_HAL_COMPRESS_ICON_DECODED_BUFF_SIZE];
+    FuriHalCompressIconCache cache;
 } FuriHalCompressIcon;
 
 struct FuriHalCompress {
@@ -49,34 +72,125 @@ void furi_hal_compress_icon_init() {
         FURI_HAL_COMPRESS_LOOKAHEAD_BUFF_SIZE_LOG);
     heatshrink_decoder_reset(icon_decoder->decoder);
     memset(icon_decoder->decoded_buff, 0, sizeof(icon_decoder->decoded_buff));
+    icon_decoder->cache.size = FURI_HAL_COMPRESS_ICON_CACHE_SIZE_DEFAULT;
     FURI_LOG_I(TAG, "Init OK");
 }
 
+static void furi_hal_compress_icon_cache_clear(FuriHalCompressIconCache* cache) {
+    while(cache->head) {
+        FuriHalCompressIconCacheEntry* entry = cache->head;
+        cache->head = entry->next;
+        free(entry);
+    }
+    cache->used = 0;
+}
+
+/* Returns decoded icon and makes it most recently used, NULL if icon is not cached */
+static const uint8_t*
+    furi_hal_compress_icon_cache_get(FuriHalCompressIconCache* cache, const uint8_t* icon_data) {
+    FuriHalCompressIconCacheEntry** link = &cache->head;
+    while(*link) {
+        FuriHalCompressIconCacheEntry* entry = *link;
+        if(entry->icon_data == icon_data) {
+            *link = entry->next;
+            entry->next = cache->head;
+            cache->head = entry;
+            return entry->decoded;
+        }
+        link = &entry->next;
+    }
+    return NULL;
+}
+
+static void furi_hal_compress_icon_cache_put(
+    FuriHalCompressIconCache* cache,
+    const uint8_t* icon_data,
+    const uint8_t* decoded,
+    size_t size) {
+    /* Data in RAM can be freed and its address reused, only icons
+     * built into firmware image are guaranteed to stay the same */
+    size_t address = (size_t)icon_data;
+    if((address < furi_hal_flash_get_base()) ||
+       (address >= (size_t)furi_hal_flash_get_free_start_address())) {
+        return;
+    }
+
+    size_t entry_size = sizeof(FuriHalCompressIconCacheEntry) + size;
+    if(entry_size > cache->size / FURI_HAL_COMPRESS_ICON_CACHE_ENTRY_DIV) return;
+
+    /* Evict least recently used icons from the end of list */
+    while(cache->used + entry_size > cache->size) {
+        FuriHalCompressIconCacheEntry** link = &cache->head;
+        while((*link)->next) {
+            link = &(*link)->next;
+        }
+        cache->used -= sizeof(FuriHalCompressIconCacheEntry) + (*link)->size;
+        free(*link);
+        *link = NULL;
+    }
+
+    FuriHalCompressIconCacheEntry* entry = malloc(entry_size);
+    entry->icon_data = icon_data;
+    entry->size = size;
+    memcpy(entry->decoded, decoded, size);
+    entry->next = cache->head;
+    cache->head = entry;
+    cache->used += entry_size;
+}
+
+void furi_hal_compress_icon_cache_set_size(size_t size) {
+    furi_assert(icon_decoder);
+    furi_hal_compress_icon_cache_clear(&icon_decoder->cache);
+    icon_decoder->cache.size = size;
+}
+
+void furi_hal_compress_icon_cache_get_stats(FuriHalCompressIconCacheStats* stats) {
+    furi_assert(icon_decoder);
+    furi_assert(stats);
+    stats->hits = icon_decoder->cache.hits;
+    stats->misses = icon_decoder->cache.misses;
+    stats->used = icon_decoder->cache.used;
+    stats->size = icon_decoder->cache.size;
+}
+
 void furi_hal_compress_icon_decode(const uint8_t* icon_data, uint8_t** decoded_buff) {
     furi_assert(icon_data);
     furi_assert(decoded_buff);
 
     FuriHalCompressHeader* header = (FuriHalCompressHeader*)icon_data;
     if(header->is_compressed) {
+        FuriHalCompressIconCache* cache = &icon_decoder->cache;
+        const uint8_t* cached = furi_hal_compress_icon_cache_get(cache, icon_data);
+        if(cached) {
+            cache->hits++;
+            *decoded_buff = (uint8_t*)cached;
+            return;
+        }
+        cache->misses++;
+
         size_t data_processed = 0;
+        size_t decoded_size = 0;
         heatshrink_decoder_sink(
             icon_decoder->decoder,
             (uint8_t*)&icon_data[4],
             header->compressed_buff_size,
             &data_processed);
-        while(1) {
+        while(decoded_size < sizeof(icon_decoder->decoded_buff)) {
             HSD_poll_res res = heatshrink_decoder_poll(
                 icon_decoder->decoder,
-                icon_decoder->decoded_buff,
-                sizeof(icon_decoder->decoded_buff),
+                &icon_decoder->decoded_buff[decoded_size],
+                sizeof(icon_decoder->decoded_buff) - decoded_size,
                 &data_processed);
             furi_assert((res == HSDR_POLL_EMPTY) || (res == HSDR_POLL_MORE));
+            decoded_size += data_processed;
             if(res != HSDR_POLL_MORE) {
                 break;
             }
         }
         heatshrink_decoder_reset(icon_decoder->decoder);
         memset(icon_decoder->compress_buff, 0, sizeof(icon_decoder->compress_buff));
+        furi_hal_compress_icon_cache_put(
+            cache, icon_data, icon_decoder->decoded_buff, decoded_size);
         *decoded_buff = icon_decoder->decoded_buff;
     } else {
         *decoded_buff = (uint8_t*)&icon_data[1];
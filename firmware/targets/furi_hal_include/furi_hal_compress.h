@@ -14,9 +14,20 @@
 /** Defines encoder and decoder lookahead buffer size */
 #define FURI_HAL_COMPRESS_LOOKAHEAD_BUFF_SIZE_LOG (4)
 
+/** Default size of decoded icon cache in bytes */
+#define FURI_HAL_COMPRESS_ICON_CACHE_SIZE_DEFAULT (4 * 1024)
+
 /** FuriHalCompress control structure */
 typedef struct FuriHalCompress FuriHalCompress;
 
+/** Decoded icon cache statistics */
+typedef struct {
+    uint32_t hits; /**< icons taken from cache */
+    uint32_t misses; /**< icons decoded */
+    size_t used; /**< bytes taken by cached icons */
+    size_t size; /**< cache size limit */
+} FuriHalCompressIconCacheStats;
+
 /** Initialize icon decoder
  */
 void furi_hal_compress_icon_init();
@@ -28,6 +39,22 @@ void furi_hal_compress_icon_init();
  */
 void furi_hal_compress_icon_decode(const uint8_t* icon_data, uint8_t** decoded_buff);
 
+/** Set decoded icon cache size, drops all cached icons
+ *
+ * Compressed icons built into firmware are kept decoded, least recently
+ * used ones are dropped when cache is full. Not thread safe, same as icon
+ * decoder.
+ *
+ * @param   size    cache size in bytes, 0 to disable cache
+ */
+void furi_hal_compress_icon_cache_set_size(size_t size);
+
+/** Get decoded icon cache statistics
+ *
+ * @param   stats   FuriHalCompressIconCacheStats to fill
+ */
+void furi_hal_compress_icon_cache_get_stats(FuriHalCompressIconCacheStats* stats);
+
 /** Allocate encoder and decoder
  *
  * @param   compress_buff_size  size of decoder and encoder buffer to allocate
@@ -0,0 +1,3 @@
+#pragma once
+
+/* Host build: no Cortex-M intrinsics */
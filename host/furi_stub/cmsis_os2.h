@@ -0,0 +1,43 @@
+/**
+ * @file cmsis_os2.h
+ * Host stub: minimal subset of CMSIS-RTOS2 used by furi headers
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define osWaitForever 0xFFFFFFFFU
+
+typedef enum {
+    osOK = 0,
+    osError = -1,
+    osErrorTimeout = -2,
+    osErrorResource = -3,
+    osErrorParameter = -4,
+    osErrorNoMemory = -5,
+    osErrorISR = -6,
+} osStatus_t;
+
+typedef enum {
+    osKernelInactive = 0,
+    osKernelReady = 1,
+    osKernelRunning = 2,
+} osKernelState_t;
+
+typedef void* osThreadId_t;
+typedef void* osMutexId_t;
+typedef void* osSemaphoreId_t;
+typedef void* osMessageQueueId_t;
+
+osStatus_t osDelay(uint32_t ticks);
+
+osKernelState_t osKernelGetState(void);
+
+#ifdef __cplusplus
+}
+#endif
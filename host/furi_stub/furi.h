@@ -0,0 +1,19 @@
+/**
+ * @file furi.h
+ * Host stub of the furi core: just enough to build protocol libraries with
+ * the host compiler. No threads, no records registry, no kernel.
+ */
+
+#pragma once
+
+#include <cmsis_os2.h>
+
+#include <furi/common_defines.h>
+#include <furi/check.h>
+#include <furi/memmgr.h>
+#include <furi/pubsub.h>
+#include <furi/record.h>
+#include <furi/stdglue.h>
+#include <furi/log.h>
+
+#include <stdlib.h>
@@ -0,0 +1,10 @@
+/**
+ * @file furi_hal.h
+ * Host stub of Furi HAL: only pure type headers and timing/crypto entry points
+ */
+
+#pragma once
+
+#include "furi_hal_crypto.h"
+#include "furi_hal_delay.h"
+#include "furi_hal_subghz.h"
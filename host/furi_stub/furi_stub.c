@@ -0,0 +1,114 @@
+#include <furi.h>
+#include <furi_hal.h>
+
+#include <stdio.h>
+#include <time.h>
+#include <unistd.h>
+
+static FuriLogLevel furi_stub_log_level = FuriLogLevelError;
+
+static uint64_t furi_stub_get_time_us() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+void furi_crash(const char* message) {
+    fprintf(stderr, "furi_crash: %s\n", message ? message : "Fatal Error");
+    abort();
+}
+
+void furi_halt(const char* message) {
+    fprintf(stderr, "furi_halt: %s\n", message ? message : "System halted");
+    abort();
+}
+
+void furi_log_init() {
+}
+
+void furi_log_print(FuriLogLevel level, const char* format, ...) {
+    if(level > furi_stub_log_level) return;
+
+    va_list args;
+    va_start(args, format);
+    vfprintf(stderr, format, args);
+    va_end(args);
+}
+
+void furi_log_set_level(FuriLogLevel level) {
+    if(level == FuriLogLevelDefault) {
+        level = FuriLogLevelError;
+    }
+    furi_stub_log_level = level;
+}
+
+FuriLogLevel furi_log_get_level() {
+    return furi_stub_log_level;
+}
+
+void furi_log_set_puts(FuriLogPuts puts) {
+    UNUSED(puts);
+}
+
+void furi_log_set_timestamp(FuriLogTimestamp timestamp) {
+    UNUSED(timestamp);
+}
+
+// Records: storage is the only record protocol libraries ask for and it is stateless here
+static uint8_t furi_stub_record_dummy;
+
+void* furi_record_open(const char* name) {
+    UNUSED(name);
+    return &furi_stub_record_dummy;
+}
+
+void furi_record_close(const char* name) {
+    UNUSED(name);
+}
+
+osStatus_t osDelay(uint32_t ticks) {
+    usleep(ticks * 1000);
+    return osOK;
+}
+
+osKernelState_t osKernelGetState(void) {
+    return osKernelInactive;
+}
+
+uint32_t furi_hal_get_tick(void) {
+    return furi_stub_get_time_us() / 1000;
+}
+
+void furi_hal_delay_ms(float milliseconds) {
+    usleep(milliseconds * 1000);
+}
+
+void furi_hal_delay_us(float microseconds) {
+    usleep(microseconds);
+}
+
+// Crypto enclave does not exist on host: encrypted keystores fail to load
+bool furi_hal_crypto_store_load_key(uint8_t slot, const uint8_t* iv) {
+    UNUSED(slot);
+    UNUSED(iv);
+    return false;
+}
+
+bool furi_hal_crypto_store_unload_key(uint8_t slot) {
+    UNUSED(slot);
+    return false;
+}
+
+bool furi_hal_crypto_encrypt(const uint8_t* input, uint8_t* output, size_t size) {
+    UNUSED(input);
+    UNUSED(output);
+    UNUSED(size);
+    return false;
+}
+
+bool furi_hal_crypto_decrypt(const uint8_t* input, uint8_t* output, size_t size) {
+    UNUSED(input);
+    UNUSED(output);
+    UNUSED(size);
+    return false;
+}
@@ -0,0 +1,20 @@
+/**
+ * @file furi_stub.h
+ * Host stub control API
+ */
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Set host directory that replaces /ext, /int and /any storage roots
+ *
+ * @param      path  host directory path, default is current directory
+ */
+void furi_stub_storage_set_root(const char* path);
+
+#ifdef __cplusplus
+}
+#endif
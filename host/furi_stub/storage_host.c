@@ -0,0 +1,266 @@
+#include <furi.h>
+#include <storage/storage.h>
+
+#include "furi_stub.h"
+
+#include <errno.h>
+#include <stdio.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+struct File {
+    FILE* fd;
+    FS_Error error;
+    int32_t internal_error;
+};
+
+static string_t storage_host_root;
+static bool storage_host_root_set = false;
+
+void furi_stub_storage_set_root(const char* path) {
+    if(!storage_host_root_set) {
+        string_init(storage_host_root);
+        storage_host_root_set = true;
+    }
+    string_set_str(storage_host_root, path);
+}
+
+static void storage_host_map_path(const char* path, string_t host_path) {
+    const char* roots[] = {"/ext/", "/int/", "/any/"};
+    for(size_t i = 0; i < COUNT_OF(roots); i++) {
+        if(strncmp(path, roots[i], strlen(roots[i])) == 0) {
+            string_printf(
+                host_path,
+                "%s/%s",
+                storage_host_root_set ? string_get_cstr(storage_host_root) : ".",
+                path + strlen(roots[i]));
+            return;
+        }
+    }
+    string_set_str(host_path, path);
+}
+
+static FS_Error storage_host_error_from_errno(int error) {
+    switch(error) {
+    case 0:
+        return FSE_OK;
+    case ENOENT:
+        return FSE_NOT_EXIST;
+    case EEXIST:
+        return FSE_EXIST;
+    case EACCES:
+    case EPERM:
+        return FSE_DENIED;
+    case EINVAL:
+        return FSE_INVALID_PARAMETER;
+    case ENAMETOOLONG:
+        return FSE_INVALID_NAME;
+    default:
+        return FSE_INTERNAL;
+    }
+}
+
+static void storage_host_set_error(File* file, int error) {
+    file->internal_error = error;
+    file->error = storage_host_error_from_errno(error);
+}
+
+File* storage_file_alloc(Storage* storage) {
+    UNUSED(storage);
+    File* file = malloc(sizeof(File));
+    file->fd = NULL;
+    file->error = FSE_OK;
+    file->internal_error = 0;
+    return file;
+}
+
+void storage_file_free(File* file) {
+    if(file->fd) {
+        storage_file_close(file);
+    }
+    free(file);
+}
+
+bool storage_file_open(
+    File* file,
+    const char* path,
+    FS_AccessMode access_mode,
+    FS_OpenMode open_mode) {
+    furi_assert(file->fd == NULL);
+
+    string_t host_path;
+    string_init(host_path);
+    storage_host_map_path(path, host_path);
+
+    struct stat st;
+    bool exists = (stat(string_get_cstr(host_path), &st) == 0);
+    const char* mode = NULL;
+
+    if(open_mode == FSOM_OPEN_EXISTING) {
+        mode = (access_mode & FSAM_WRITE) ? "r+b" : "rb";
+    } else if(open_mode == FSOM_CREATE_NEW) {
+        mode = exists ? NULL : "w+b";
+    } else if(open_mode == FSOM_CREATE_ALWAYS) {
+        mode = "w+b";
+    } else {
+        // FSOM_OPEN_ALWAYS and FSOM_OPEN_APPEND
+        mode = exists ? "r+b" : "w+b";
+    }
+
+    if(mode) {
+        file->fd = fopen(string_get_cstr(host_path), mode);
+        storage_host_set_error(file, file->fd ? 0 : errno);
+        if(file->fd && open_mode == FSOM_OPEN_APPEND) {
+            fseek(file->fd, 0, SEEK_END);
+        }
+    } else {
+        storage_host_set_error(file, EEXIST);
+    }
+
+    string_clear(host_path);
+    return file->fd != NULL;
+}
+
+bool storage_file_close(File* file) {
+    if(!file->fd) return false;
+    bool result = (fclose(file->fd) == 0);
+    storage_host_set_error(file, result ? 0 : errno);
+    file->fd = NULL;
+    return result;
+}
+
+bool storage_file_is_open(File* file) {
+    return file->fd != NULL;
+}
+
+uint16_t storage_file_read(File* file, void* buff, uint16_t bytes_to_read) {
+    size_t read = fread(buff, 1, bytes_to_read, file->fd);
+    storage_host_set_error(file, ferror(file->fd) ? errno : 0);
+    return read;
+}
+
+uint16_t storage_file_write(File* file, const void* buff, uint16_t bytes_to_write) {
+    size_t written = fwrite(buff, 1, bytes_to_write, file->fd);
+    storage_host_set_error(file, written == bytes_to_write ? 0 : errno);
+    return written;
+}
+
+bool storage_file_seek(File* file, uint32_t offset, bool from_start) {
+    bool result = (fseek(file->fd, offset, from_start ? SEEK_SET : SEEK_CUR) == 0);
+    storage_host_set_error(file, result ? 0 : errno);
+    return result;
+}
+
+uint64_t storage_file_tell(File* file) {
+    return ftell(file->fd);
+}
+
+bool storage_file_truncate(File* file) {
+    fflush(file->fd);
+    bool result = (ftruncate(fileno(file->fd), ftell(file->fd)) == 0);
+    storage_host_set_error(file, result ? 0 : errno);
+    return result;
+}
+
+uint64_t storage_file_size(File* file) {
+    long position = ftell(file->fd);
+    fseek(file->fd, 0, SEEK_END);
+    long size = ftell(file->fd);
+    fseek(file->fd, position, SEEK_SET);
+    return size;
+}
+
+bool storage_file_sync(File* file) {
+    return fflush(file->fd) == 0;
+}
+
+bool storage_file_eof(File* file) {
+    long position = ftell(file->fd);
+    return (uint64_t)position >= storage_file_size(file);
+}
+
+FS_Error storage_file_get_error(File* file) {
+    return file->error;
+}
+
+int32_t storage_file_get_internal_error(File* file) {
+    return file->internal_error;
+}
+
+FS_Error storage_common_stat(Storage* storage, const char* path, FileInfo* fileinfo) {
+    UNUSED(storage);
+    string_t host_path;
+    string_init(host_path);
+    storage_host_map_path(path, host_path);
+    FS_Error error = FSE_OK;
+    struct stat st;
+    if(stat(string_get_cstr(host_path), &st) != 0) {
+        error = storage_host_error_from_errno(errno);
+    } else if(fileinfo) {
+        fileinfo->flags = S_ISDIR(st.st_mode) ? FSF_DIRECTORY : 0;
+        fileinfo->size = st.st_size;
+    }
+    string_clear(host_path);
+    return error;
+}
+
+FS_Error storage_common_remove(Storage* storage, const char* path) {
+    UNUSED(storage);
+    string_t host_path;
+    string_init(host_path);
+    storage_host_map_path(path, host_path);
+    FS_Error error = FSE_OK;
+    if(remove(string_get_cstr(host_path)) != 0) {
+        error = storage_host_error_from_errno(errno);
+    }
+    string_clear(host_path);
+    return error;
+}
+
+FS_Error storage_common_mkdir(Storage* storage, const char* path) {
+    UNUSED(storage);
+    string_t host_path;
+    string_init(host_path);
+    storage_host_map_path(path, host_path);
+    FS_Error error = FSE_OK;
+    if(mkdir(string_get_cstr(host_path), 0755) != 0) {
+        error = storage_host_error_from_errno(errno);
+    }
+    string_clear(host_path);
+    return error;
+}
+
+bool storage_simply_remove(Storage* storage, const char* path) {
+    FS_Error result = storage_common_remove(storage, path);
+    return result == FSE_OK || result == FSE_NOT_EXIST;
+}
+
+bool storage_simply_mkdir(Storage* storage, const char* path) {
+    FS_Error result = storage_common_mkdir(storage, path);
+    return result == FSE_OK || result == FSE_EXIST;
+}
+
+void storage_get_next_filename(
+    Storage* storage,
+    const char* dirname,
+    const char* filename,
+    const char* fileextension,
+    string_t nextfilename,
+    uint8_t max_len) {
+    string_t temp_str;
+    uint16_t num = 0;
+
+    string_init_printf(temp_str, "%s/%s%s", dirname, filename, fileextension);
+
+    while(storage_common_stat(storage, string_get_cstr(temp_str), NULL) == FSE_OK) {
+        num++;
+        string_printf(temp_str, "%s/%s%d%s", dirname, filename, num, fileextension);
+    }
+    if(num && (max_len > strlen(filename))) {
+        string_printf(nextfilename, "%s%d", filename, num);
+    } else {
+        string_printf(nextfilename, "%s", filename);
+    }
+
+    string_clear(temp_str);
+}
@@ -0,0 +1,344 @@
+#include <furi.h>
+#include <furi_hal.h>
+#include <furi_stub.h>
+
+#include <lib/subghz/receiver.h>
+#include <lib/subghz/protocols/registry.h>
+#include <flipper_format/flipper_format.h>
+
+#include <m-array.h>
+
+#include <getopt.h>
+#include <stdio.h>
+#include <time.h>
+
+#define TAG "SubGhzBench"
+
+#define SUBGHZ_BENCH_RAW_DATA_KEY "RAW_Data"
+#define SUBGHZ_BENCH_RAW_DATA_MAX_COUNT 512
+
+ARRAY_DEF(SubGhzBenchPulseArray, LevelDuration, M_POD_OPLIST);
+
+typedef struct {
+    const char* name;
+    uint64_t pulses;
+    uint64_t time_ns;
+    uint32_t decodes;
+} SubGhzBenchProtocolStat;
+
+typedef struct {
+    SubGhzEnvironment* environment;
+    SubGhzReceiver* receiver;
+
+    size_t protocol_count;
+    SubGhzBenchProtocolStat* protocol_stat;
+
+    uint64_t receiver_pulses;
+    uint64_t receiver_time_ns;
+    uint32_t receiver_decodes;
+
+    uint32_t repeat;
+    bool verbose;
+    bool prefilter;
+} SubGhzBench;
+
+static uint64_t subghz_bench_get_time_ns() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+static SubGhzBenchProtocolStat*
+    subghz_bench_get_protocol_stat(SubGhzBench* instance, const char* name) {
+    for(size_t i = 0; i < instance->protocol_count; i++) {
+        if(strcmp(instance->protocol_stat[i].name, name) == 0) {
+            return &instance->protocol_stat[i];
+        }
+    }
+    return NULL;
+}
+
+static void subghz_bench_rx_callback(
+    SubGhzReceiver* receiver,
+    SubGhzProtocolDecoderBase* decoder_base,
+    void* context) {
+    UNUSED(receiver);
+    SubGhzBench* instance = context;
+
+    SubGhzBenchProtocolStat* stat =
+        subghz_bench_get_protocol_stat(instance, decoder_base->protocol->name);
+    if(stat) stat->decodes++;
+    instance->receiver_decodes++;
+
+    if(instance->verbose) {
+        string_t text;
+        string_init(text);
+        subghz_protocol_decoder_base_get_string(decoder_base, text);
+        printf("%s\n", string_get_cstr(text));
+        string_clear(text);
+    }
+}
+
+/** Same level merging as SubGhzFileEncoderWorker: consecutive samples of one sign are one pulse */
+static void subghz_bench_add_duration(SubGhzBenchPulseArray_t pulses, int32_t duration) {
+    if(duration == 0) return;
+
+    bool level = duration > 0;
+    uint32_t abs_duration = level ? duration : -duration;
+    size_t size = SubGhzBenchPulseArray_size(pulses);
+
+    if(size > 0) {
+        LevelDuration* last = SubGhzBenchPulseArray_get(pulses, size - 1);
+        if(level_duration_get_level(*last) == level) {
+            *last = level_duration_make(level, level_duration_get_duration(*last) + abs_duration);
+            return;
+        }
+    }
+    SubGhzBenchPulseArray_push_back(pulses, level_duration_make(level, abs_duration));
+}
+
+static bool subghz_bench_load_raw(const char* path, SubGhzBenchPulseArray_t pulses) {
+    FlipperFormat* flipper_format = flipper_format_file_alloc(furi_record_open("storage"));
+    int32_t* raw_data = malloc(SUBGHZ_BENCH_RAW_DATA_MAX_COUNT * sizeof(int32_t));
+    string_t temp_str;
+    string_init(temp_str);
+    uint32_t version = 0;
+    bool result = false;
+
+    do {
+        if(!flipper_format_file_open_existing(flipper_format, path)) {
+            FURI_LOG_E(TAG, "Unable to open %s", path);
+            break;
+        }
+        if(!flipper_format_read_header(flipper_format, temp_str, &version)) {
+            FURI_LOG_E(TAG, "Missing or incorrect header in %s", path);
+            break;
+        }
+        if(string_cmp_str(temp_str, SUBGHZ_RAW_FILE_TYPE) != 0) {
+            FURI_LOG_E(TAG, "%s is not a RAW file, nothing to replay", path);
+            break;
+        }
+
+        uint32_t count = 0;
+        while(flipper_format_get_value_count(flipper_format, SUBGHZ_BENCH_RAW_DATA_KEY, &count)) {
+            if(count == 0 || count > SUBGHZ_BENCH_RAW_DATA_MAX_COUNT) break;
+            if(!flipper_format_read_int32(
+                   flipper_format, SUBGHZ_BENCH_RAW_DATA_KEY, raw_data, count)) {
+                break;
+            }
+            for(uint32_t i = 0; i < count; i++) {
+                subghz_bench_add_duration(pulses, raw_data[i]);
+            }
+        }
+
+        result = SubGhzBenchPulseArray_size(pulses) > 0;
+    } while(false);
+
+    string_clear(temp_str);
+    free(raw_data);
+    flipper_format_free(flipper_format);
+    furi_record_close("storage");
+
+    return result;
+}
+
+static void subghz_bench_run_receiver(SubGhzBench* instance, SubGhzBenchPulseArray_t pulses) {
+    size_t size = SubGhzBenchPulseArray_size(pulses);
+    const LevelDuration* data = SubGhzBenchPulseArray_cget(pulses, 0);
+
+    for(uint32_t run = 0; run < instance->repeat; run++) {
+        subghz_receiver_reset(instance->receiver);
+        uint64_t start = subghz_bench_get_time_ns();
+        for(size_t i = 0; i < size; i++) {
+            subghz_receiver_decode(
+                instance->receiver,
+                level_duration_get_level(data[i]),
+                level_duration_get_duration(data[i]));
+        }
+        instance->receiver_time_ns += subghz_bench_get_time_ns() - start;
+        instance->receiver_pulses += size;
+    }
+}
+
+static void subghz_bench_run_decoders(SubGhzBench* instance, SubGhzBenchPulseArray_t pulses) {
+    size_t size = SubGhzBenchPulseArray_size(pulses);
+    const LevelDuration* data = SubGhzBenchPulseArray_cget(pulses, 0);
+
+    // Decode counts come from the receiver pass, isolated runs only measure time
+    bool verbose = instance->verbose;
+    uint32_t receiver_decodes = instance->receiver_decodes;
+    instance->verbose = false;
+
+    for(size_t index = 0; index < instance->protocol_count; index++) {
+        SubGhzBenchProtocolStat* stat = &instance->protocol_stat[index];
+        SubGhzProtocolDecoderBase* decoder =
+            subghz_receiver_search_decoder_base_by_name(instance->receiver, stat->name);
+        if(!decoder) continue;
+
+        uint32_t decodes = stat->decodes;
+        for(uint32_t run = 0; run < instance->repeat; run++) {
+            decoder->protocol->decoder->reset(decoder);
+            uint64_t start = subghz_bench_get_time_ns();
+            for(size_t i = 0; i < size; i++) {
+                decoder->protocol->decoder->feed(
+                    decoder,
+                    level_duration_get_level(data[i]),
+                    level_duration_get_duration(data[i]));
+            }
+            stat->time_ns += subghz_bench_get_time_ns() - start;
+            stat->pulses += size;
+        }
+        stat->decodes = decodes;
+    }
+
+    instance->verbose = verbose;
+    instance->receiver_decodes = receiver_decodes;
+}
+
+static void subghz_bench_print_report(SubGhzBench* instance) {
+    printf("\n%-16s %10s %12s %10s\n", "Protocol", "Decodes", "Pulses", "ns/pulse");
+    for(size_t i = 0; i < instance->protocol_count; i++) {
+        SubGhzBenchProtocolStat* stat = &instance->protocol_stat[i];
+        printf(
+            "%-16s %10u %12llu %10.1f\n",
+            stat->name,
+            stat->decodes,
+            (unsigned long long)stat->pulses,
+            stat->pulses ? (double)stat->time_ns / stat->pulses : 0.0);
+    }
+
+    double seconds = (double)instance->receiver_time_ns / 1000000000.0;
+    printf(
+        "\nReceiver: %llu pulses, %.1f ns/pulse, %.0f pulses/sec, %u decodes\n",
+        (unsigned long long)instance->receiver_pulses,
+        instance->receiver_pulses ? (double)instance->receiver_time_ns / instance->receiver_pulses :
+                                    0.0,
+        seconds > 0 ? instance->receiver_pulses / seconds : 0.0,
+        instance->receiver_decodes);
+
+    SubGhzReceiverStats stats;
+    subghz_receiver_get_stats(instance->receiver, &stats);
+    uint64_t total = (uint64_t)stats.feed_count + stats.skip_count;
+    printf(
+        "Pre-filter %s: %u feeds, %u skipped (%.1f%%)\n",
+        instance->prefilter ? "on" : "off",
+        stats.feed_count,
+        stats.skip_count,
+        total ? 100.0 * stats.skip_count / total : 0.0);
+}
+
+static void subghz_bench_usage(const char* name) {
+    printf(
+        "Usage: %s [-n repeat] [-a assets_dir] [-p] [-v] file.sub [file.sub ...]\n"
+        "\t-n repeat\treplay every file N times, default 1\n"
+        "\t-a assets_dir\tdirectory with keeloq_mfcodes, came_atomo and nice_flor_s\n"
+        "\t-p\t\tdisable receiver pre-filter\n"
+        "\t-v\t\tprint every decoded signal\n",
+        name);
+}
+
+int main(int argc, char* argv[]) {
+    SubGhzBench* instance = malloc(sizeof(SubGhzBench));
+    memset(instance, 0, sizeof(SubGhzBench));
+    instance->repeat = 1;
+    instance->prefilter = true;
+
+    const char* assets_dir = NULL;
+    int opt;
+    while((opt = getopt(argc, argv, "n:a:pvh")) != -1) {
+        switch(opt) {
+        case 'n':
+            instance->repeat = MAX(atoi(optarg), 1);
+            break;
+        case 'a':
+            assets_dir = optarg;
+            break;
+        case 'p':
+            instance->prefilter = false;
+            break;
+        case 'v':
+            instance->verbose = true;
+            break;
+        default:
+            subghz_bench_usage(argv[0]);
+            free(instance);
+            return 1;
+        }
+    }
+
+    if(optind >= argc) {
+        subghz_bench_usage(argv[0]);
+        free(instance);
+        return 1;
+    }
+
+    furi_log_set_level(FuriLogLevelError);
+
+    string_t came_atomo_path;
+    string_t nice_flor_s_path;
+    string_init(came_atomo_path);
+    string_init(nice_flor_s_path);
+
+    instance->environment = subghz_environment_alloc();
+    if(assets_dir) {
+        string_t keystore_path;
+        string_init_printf(keystore_path, "%s/keeloq_mfcodes", assets_dir);
+        if(!subghz_environment_load_keystore(
+               instance->environment, string_get_cstr(keystore_path))) {
+            printf("Keystore not loaded, KeeLoq manufacturer lookup disabled\n");
+        }
+        string_clear(keystore_path);
+
+        string_printf(came_atomo_path, "%s/came_atomo", assets_dir);
+        string_printf(nice_flor_s_path, "%s/nice_flor_s", assets_dir);
+        subghz_environment_set_came_atomo_rainbow_table_file_name(
+            instance->environment, string_get_cstr(came_atomo_path));
+        subghz_environment_set_nice_flor_s_rainbow_table_file_name(
+            instance->environment, string_get_cstr(nice_flor_s_path));
+    }
+
+    instance->receiver = subghz_receiver_alloc_init(instance->environment);
+    subghz_receiver_set_filter(instance->receiver, SubGhzProtocolFlag_Decodable);
+    subghz_receiver_set_rx_callback(instance->receiver, subghz_bench_rx_callback, instance);
+    subghz_receiver_set_prefilter(instance->receiver, instance->prefilter);
+
+    instance->protocol_count = subghz_protocol_registry_count();
+    instance->protocol_stat = malloc(sizeof(SubGhzBenchProtocolStat) * instance->protocol_count);
+    memset(instance->protocol_stat, 0, sizeof(SubGhzBenchProtocolStat) * instance->protocol_count);
+    for(size_t i = 0; i < instance->protocol_count; i++) {
+        instance->protocol_stat[i].name = subghz_protocol_registry_get_by_index(i)->name;
+    }
+
+    SubGhzBenchPulseArray_t pulses;
+    SubGhzBenchPulseArray_init(pulses);
+
+    int ret = 0;
+    for(int i = optind; i < argc; i++) {
+        SubGhzBenchPulseArray_reset(pulses);
+        if(!subghz_bench_load_raw(argv[i], pulses)) {
+            printf("Skipping %s\n", argv[i]);
+            ret = 1;
+            continue;
+        }
+        uint32_t decodes = instance->receiver_decodes;
+        subghz_bench_run_receiver(instance, pulses);
+        subghz_bench_run_decoders(instance, pulses);
+        printf(
+            "%s: %zu pulses, %u decodes\n",
+            argv[i],
+            SubGhzBenchPulseArray_size(pulses),
+            instance->receiver_decodes - decodes);
+    }
+
+    subghz_bench_print_report(instance);
+
+    SubGhzBenchPulseArray_clear(pulses);
+    free(instance->protocol_stat);
+    subghz_receiver_free(instance->receiver);
+    subghz_environment_free(instance->environment);
+    string_clear(came_atomo_path);
+    string_clear(nice_flor_s_path);
+    free(instance);
+
+    return ret;
+}
@@ -0,0 +1,43 @@
+#include <lib/subghz/subghz_file_encoder_worker.h>
+
+/*
+ * Host stub: RAW encoder playback needs a thread and a stream buffer.
+ * Benchmark only exercises decoders, so file playback always fails to start.
+ */
+
+void subghz_file_encoder_worker_callback_end(
+    SubGhzFileEncoderWorker* instance,
+    SubGhzFileEncoderWorkerCallbackEnd callback_end,
+    void* context_end) {
+    UNUSED(instance);
+    UNUSED(callback_end);
+    UNUSED(context_end);
+}
+
+SubGhzFileEncoderWorker* subghz_file_encoder_worker_alloc() {
+    return NULL;
+}
+
+void subghz_file_encoder_worker_free(SubGhzFileEncoderWorker* instance) {
+    UNUSED(instance);
+}
+
+LevelDuration subghz_file_encoder_worker_get_level_duration(void* context) {
+    UNUSED(context);
+    return level_duration_reset();
+}
+
+bool subghz_file_encoder_worker_start(SubGhzFileEncoderWorker* instance, const char* file_path) {
+    UNUSED(instance);
+    UNUSED(file_path);
+    return false;
+}
+
+void subghz_file_encoder_worker_stop(SubGhzFileEncoderWorker* instance) {
+    UNUSED(instance);
+}
+
+bool subghz_file_encoder_worker_is_running(SubGhzFileEncoderWorker* instance) {
+    UNUSED(instance);
+    return false;
+}
@@ -2,15 +2,32 @@
 #include <toolbox/stream/stream.h>
 #include <toolbox/stream/string_stream.h>
 #include <toolbox/stream/file_stream.h>
+#include <toolbox/stream/buffered_file_stream.h>
 #include "flipper_format.h"
 #include "flipper_format_i.h"
 #include "flipper_format_stream.h"
 #include "flipper_format_stream_i.h"
+#include "flipper_format_index.h"
+#include <m-array.h>
 
 /********************************** Private **********************************/
+#define FLIPPER_FORMAT_TRANSACTION_SPAN_MAX 2048
+
+typedef struct {
+    string_t key;
+    string_t line;
+    size_t start;
+    size_t end;
+} FlipperFormatUpdate;
+
+ARRAY_DEF(FlipperFormatUpdateArray, FlipperFormatUpdate, M_POD_OPLIST)
+
 struct FlipperFormat {
     Stream* stream;
     bool strict_mode;
+    FlipperFormatIndex* index;
+    bool transaction;
+    FlipperFormatUpdateArray_t updates;
 };
 
 static const char* const flipper_format_filetype_key = "Filetype";
@@ -20,12 +37,92 @@ Stream* flipper_format_get_raw_stream(FlipperFormat* flipper_format) {
     return flipper_format->stream;
 }
 
+static void flipper_format_drop_index(FlipperFormat* flipper_format) {
+    if(flipper_format->index) {
+        flipper_format_index_invalidate(flipper_format->index);
+    }
+}
+
+static void flipper_format_updates_reset(FlipperFormat* flipper_format) {
+    for
+        M_EACH(update, flipper_format->updates, FlipperFormatUpdateArray_t) {
+            string_clear(update->key);
+            string_clear(update->line);
+        }
+    FlipperFormatUpdateArray_reset(flipper_format->updates);
+}
+
+/** Queue key update, rendered line is kept until commit */
+static bool flipper_format_transaction_add(
+    FlipperFormat* flipper_format,
+    FlipperStreamWriteData* write_data) {
+    if(!flipper_format_key_exist(flipper_format, write_data->key)) return false;
+
+    Stream* line_stream = string_stream_alloc();
+    char* line = NULL;
+    bool result = false;
+
+    do {
+        if(!flipper_format_stream_write_value_line(line_stream, write_data)) break;
+        size_t line_size = stream_size(line_stream);
+        line = malloc(line_size + 1);
+        if(!stream_rewind(line_stream)) break;
+        if(stream_read(line_stream, (uint8_t*)line, line_size) != line_size) break;
+
+        // the same key updated twice: the last value wins
+        FlipperFormatUpdate* update = NULL;
+        size_t count = FlipperFormatUpdateArray_size(flipper_format->updates);
+        for(size_t i = 0; i < count; i++) {
+            FlipperFormatUpdate* item = FlipperFormatUpdateArray_get(flipper_format->updates, i);
+            if(string_cmp_str(item->key, write_data->key) == 0) {
+                update = item;
+                break;
+            }
+        }
+        if(!update) {
+            update = FlipperFormatUpdateArray_push_raw(flipper_format->updates);
+            string_init_set_str(update->key, write_data->key);
+            string_init(update->line);
+        }
+        string_set_strn(update->line, line, line_size);
+
+        result = true;
+    } while(false);
+
+    free(line);
+    stream_free(line_stream);
+    return result;
+}
+
+static bool flipper_format_delete_key_and_write(
+    FlipperFormat* flipper_format,
+    FlipperStreamWriteData* write_data) {
+    if(flipper_format->transaction) {
+        return flipper_format_transaction_add(flipper_format, write_data);
+    }
+
+    flipper_format_drop_index(flipper_format);
+    return flipper_format_stream_delete_key_and_write(
+        flipper_format->stream, write_data, flipper_format->strict_mode);
+}
+
+/** Jump to the key line using the index, false if key is known to be missing */
+static bool flipper_format_seek_to_indexed_key(FlipperFormat* flipper_format, const char* key) {
+    if(!flipper_format->index) return true;
+    FlipperFormatIndexSeek seek = flipper_format_index_seek(
+        flipper_format->index, flipper_format->stream, key, flipper_format->strict_mode);
+    return seek != FlipperFormatIndexSeekNotFound;
+}
+
 /********************************** Public **********************************/
 
 FlipperFormat* flipper_format_string_alloc() {
     FlipperFormat* flipper_format = malloc(sizeof(FlipperFormat));
     flipper_format->stream = string_stream_alloc();
     flipper_format->strict_mode = false;
+    flipper_format->index = NULL;
+    flipper_format->transaction = false;
+    FlipperFormatUpdateArray_init(flipper_format->updates);
     return flipper_format;
 }
 
@@ -33,16 +130,31 @@ FlipperFormat* flipper_format_file_alloc(Storage* storage) {
     FlipperFormat* flipper_format = malloc(sizeof(FlipperFormat));
     flipper_format->stream = file_stream_alloc(storage);
     flipper_format->strict_mode = false;
+    flipper_format->index = NULL;
+    flipper_format->transaction = false;
+    FlipperFormatUpdateArray_init(flipper_format->updates);
+    return flipper_format;
+}
+
+FlipperFormat* flipper_format_buffered_file_alloc(Storage* storage) {
+    FlipperFormat* flipper_format = malloc(sizeof(FlipperFormat));
+    flipper_format->stream = buffered_file_stream_alloc(storage, 0);
+    flipper_format->strict_mode = false;
+    flipper_format->index = NULL;
+    flipper_format->transaction = false;
+    FlipperFormatUpdateArray_init(flipper_format->updates);
     return flipper_format;
 }
 
 bool flipper_format_file_open_existing(FlipperFormat* flipper_format, const char* path) {
     furi_assert(flipper_format);
+    flipper_format_drop_index(flipper_format);
     return file_stream_open(flipper_format->stream, path, FSAM_READ_WRITE, FSOM_OPEN_EXISTING);
 }
 
 bool flipper_format_file_open_append(FlipperFormat* flipper_format, const char* path) {
     furi_assert(flipper_format);
+    flipper_format_drop_index(flipper_format);
 
     bool result =
         file_stream_open(flipper_format->stream, path, FSAM_READ_WRITE, FSOM_OPEN_APPEND);
@@ -74,22 +186,43 @@ bool flipper_format_file_open_append(FlipperFormat* flipper_format, const char*
 
 bool flipper_format_file_open_always(FlipperFormat* flipper_format, const char* path) {
     furi_assert(flipper_format);
+    flipper_format_drop_index(flipper_format);
     return file_stream_open(flipper_format->stream, path, FSAM_READ_WRITE, FSOM_CREATE_ALWAYS);
 }
 
 bool flipper_format_file_open_new(FlipperFormat* flipper_format, const char* path) {
     furi_assert(flipper_format);
+    flipper_format_drop_index(flipper_format);
     return file_stream_open(flipper_format->stream, path, FSAM_READ_WRITE, FSOM_CREATE_NEW);
 }
 
 bool flipper_format_file_close(FlipperFormat* flipper_format) {
     furi_assert(flipper_format);
+    flipper_format_drop_index(flipper_format);
     return file_stream_close(flipper_format->stream);
 }
 
+bool flipper_format_buffered_file_open_existing(FlipperFormat* flipper_format, const char* path) {
+    furi_assert(flipper_format);
+    flipper_format_drop_index(flipper_format);
+    return buffered_file_stream_open(
+        flipper_format->stream, path, FSAM_READ_WRITE, FSOM_OPEN_EXISTING);
+}
+
+bool flipper_format_buffered_file_close(FlipperFormat* flipper_format) {
+    furi_assert(flipper_format);
+    flipper_format_drop_index(flipper_format);
+    return buffered_file_stream_close(flipper_format->stream);
+}
+
 void flipper_format_free(FlipperFormat* flipper_format) {
     furi_assert(flipper_format);
     stream_free(flipper_format->stream);
+    if(flipper_format->index) {
+        flipper_format_index_free(flipper_format->index);
+    }
+    flipper_format_updates_reset(flipper_format);
+    FlipperFormatUpdateArray_clear(flipper_format->updates);
     free(flipper_format);
 }
 
@@ -97,6 +230,123 @@ void flipper_format_set_strict_mode(FlipperFormat* flipper_format, bool strict_m
     flipper_format->strict_mode = strict_mode;
 }
 
+void flipper_format_set_key_index(FlipperFormat* flipper_format, bool enable) {
+    furi_assert(flipper_format);
+    if(enable && !flipper_format->index) {
+        flipper_format->index = flipper_format_index_alloc();
+    } else if(!enable && flipper_format->index) {
+        flipper_format_index_free(flipper_format->index);
+        flipper_format->index = NULL;
+    }
+}
+
+void flipper_format_transaction_begin(FlipperFormat* flipper_format) {
+    furi_assert(flipper_format);
+    furi_check(!flipper_format->transaction);
+    flipper_format->transaction = true;
+}
+
+/** Carry over untouched data between updated keys */
+static bool flipper_format_read_span(Stream* stream, size_t size, string_t span) {
+    const size_t buffer_size = 32;
+    uint8_t buffer[buffer_size];
+
+    while(size > 0) {
+        size_t chunk = MIN(size, buffer_size);
+        if(stream_read(stream, buffer, chunk) != chunk) return false;
+        for(size_t i = 0; i < chunk; i++) {
+            string_push_back(span, buffer[i]);
+        }
+        size -= chunk;
+    }
+
+    return true;
+}
+
+static bool flipper_format_transaction_apply(FlipperFormat* flipper_format) {
+    Stream* stream = flipper_format->stream;
+    size_t count = FlipperFormatUpdateArray_size(flipper_format->updates);
+    size_t span_start = FlipperFormatUpdateArray_get(flipper_format->updates, 0)->start;
+    size_t span_end = FlipperFormatUpdateArray_get(flipper_format->updates, count - 1)->end;
+
+    if(span_end - span_start > FLIPPER_FORMAT_TRANSACTION_SPAN_MAX) {
+        // too much to keep in memory, go from the end so earlier offsets stay valid
+        for(size_t i = count; i > 0; i--) {
+            FlipperFormatUpdate* update =
+                FlipperFormatUpdateArray_get(flipper_format->updates, i - 1);
+            if(!stream_seek(stream, update->start, StreamOffsetFromStart)) return false;
+            if(!stream_delete_and_insert_string(stream, update->end - update->start, update->line))
+                return false;
+        }
+        return true;
+    }
+
+    string_t span;
+    string_init(span);
+    bool result = stream_seek(stream, span_start, StreamOffsetFromStart);
+
+    for(size_t i = 0; result && i < count; i++) {
+        FlipperFormatUpdate* update = FlipperFormatUpdateArray_get(flipper_format->updates, i);
+        result = flipper_format_read_span(stream, update->start - stream_tell(stream), span) &&
+                 stream_seek(stream, update->end, StreamOffsetFromStart);
+        string_cat(span, update->line);
+    }
+
+    // whole span is replaced at once, so the data after it is moved only once
+    if(result) {
+        result = stream_seek(stream, span_start, StreamOffsetFromStart) &&
+                 stream_delete_and_insert_string(stream, span_end - span_start, span);
+    }
+
+    string_clear(span);
+    return result;
+}
+
+bool flipper_format_transaction_commit(FlipperFormat* flipper_format) {
+    furi_assert(flipper_format);
+    furi_check(flipper_format->transaction);
+    flipper_format->transaction = false;
+
+    bool result = true;
+    size_t count = FlipperFormatUpdateArray_size(flipper_format->updates);
+
+    // keys are located in the stream as it is now, appended keys are fine
+    for(size_t i = 0; i < count; i++) {
+        FlipperFormatUpdate* update = FlipperFormatUpdateArray_get(flipper_format->updates, i);
+        if(!flipper_format_stream_find_key_line(
+               flipper_format->stream,
+               string_get_cstr(update->key),
+               flipper_format->strict_mode,
+               &update->start,
+               &update->end)) {
+            result = false;
+            break;
+        }
+    }
+
+    if(result && count > 0) {
+        // order by position, there is only a handful of keys
+        for(size_t i = 1; i < count; i++) {
+            for(size_t j = i; j > 0; j--) {
+                FlipperFormatUpdate* prev =
+                    FlipperFormatUpdateArray_get(flipper_format->updates, j - 1);
+                FlipperFormatUpdate* next =
+                    FlipperFormatUpdateArray_get(flipper_format->updates, j);
+                if(prev->start <= next->start) break;
+                FlipperFormatUpdate tmp = *prev;
+                *prev = *next;
+                *next = tmp;
+            }
+        }
+
+        flipper_format_drop_index(flipper_format);
+        result = flipper_format_transaction_apply(flipper_format);
+    }
+
+    flipper_format_updates_reset(flipper_format);
+    return result;
+}
+
 bool flipper_format_rewind(FlipperFormat* flipper_format) {
     furi_assert(flipper_format);
     return stream_rewind(flipper_format->stream);
@@ -110,7 +360,13 @@ bool flipper_format_seek_to_end(FlipperFormat* flipper_format) {
 bool flipper_format_key_exist(FlipperFormat* flipper_format, const char* key) {
     size_t pos = stream_tell(flipper_format->stream);
     stream_seek(flipper_format->stream, 0, StreamOffsetFromStart);
-    bool result = flipper_format_stream_seek_to_key(flipper_format->stream, key, false);
+    bool result = true;
+    if(flipper_format->index) {
+        FlipperFormatIndexSeek seek =
+            flipper_format_index_seek(flipper_format->index, flipper_format->stream, key, false);
+        result = (seek != FlipperFormatIndexSeekNotFound);
+    }
+    result = result && flipper_format_stream_seek_to_key(flipper_format->stream, key, false);
     stream_seek(flipper_format->stream, pos, StreamOffsetFromStart);
 
     return result;
@@ -148,12 +404,25 @@ bool flipper_format_get_value_count(
     const char* key,
     uint32_t* count) {
     furi_assert(flipper_format);
-    return flipper_format_stream_get_value_count(
-        flipper_format->stream, key, count, flipper_format->strict_mode);
+    if(!flipper_format->index) {
+        return flipper_format_stream_get_value_count(
+            flipper_format->stream, key, count, flipper_format->strict_mode);
+    }
+
+    // value count must not move the stream, including the index jump
+    size_t position = stream_tell(flipper_format->stream);
+    bool result = flipper_format_seek_to_indexed_key(flipper_format, key) &&
+                  flipper_format_stream_get_value_count(
+                      flipper_format->stream, key, count, flipper_format->strict_mode);
+    if(!stream_seek(flipper_format->stream, position, StreamOffsetFromStart)) {
+        result = false;
+    }
+    return result;
 }
 
 bool flipper_format_read_string(FlipperFormat* flipper_format, const char* key, string_t data) {
     furi_assert(flipper_format);
+    if(!flipper_format_seek_to_indexed_key(flipper_format, key)) return false;
     return flipper_format_stream_read_value_line(
         flipper_format->stream, key, FlipperStreamValueStr, data, 1, flipper_format->strict_mode);
 }
@@ -166,6 +435,7 @@ bool flipper_format_write_string(FlipperFormat* flipper_format, const char* key,
         .data = string_get_cstr(data),
         .data_size = 1,
     };
+    flipper_format_drop_index(flipper_format);
     bool result = flipper_format_stream_write_value_line(flipper_format->stream, &write_data);
     return result;
 }
@@ -181,6 +451,7 @@ bool flipper_format_write_string_cstr(
         .data = data,
         .data_size = 1,
     };
+    flipper_format_drop_index(flipper_format);
     bool result = flipper_format_stream_write_value_line(flipper_format->stream, &write_data);
     return result;
 }
@@ -191,6 +462,7 @@ bool flipper_format_read_uint32(
     uint32_t* data,
     const uint16_t data_size) {
     furi_assert(flipper_format);
+    if(!flipper_format_seek_to_indexed_key(flipper_format, key)) return false;
     return flipper_format_stream_read_value_line(
         flipper_format->stream,
         key,
@@ -212,6 +484,7 @@ bool flipper_format_write_uint32(
         .data = data,
         .data_size = data_size,
     };
+    flipper_format_drop_index(flipper_format);
     bool result = flipper_format_stream_write_value_line(flipper_format->stream, &write_data);
     return result;
 }
@@ -221,6 +494,7 @@ bool flipper_format_read_int32(
     const char* key,
     int32_t* data,
     const uint16_t data_size) {
+    if(!flipper_format_seek_to_indexed_key(flipper_format, key)) return false;
     return flipper_format_stream_read_value_line(
         flipper_format->stream,
         key,
@@ -242,6 +516,7 @@ bool flipper_format_write_int32(
         .data = data,
         .data_size = data_size,
     };
+    flipper_format_drop_index(flipper_format);
     bool result = flipper_format_stream_write_value_line(flipper_format->stream, &write_data);
     return result;
 }
@@ -251,6 +526,7 @@ bool flipper_format_read_bool(
     const char* key,
     bool* data,
     const uint16_t data_size) {
+    if(!flipper_format_seek_to_indexed_key(flipper_format, key)) return false;
     return flipper_format_stream_read_value_line(
         flipper_format->stream,
         key,
@@ -272,6 +548,7 @@ bool flipper_format_write_bool(
         .data = data,
         .data_size = data_size,
     };
+    flipper_format_drop_index(flipper_format);
     bool result = flipper_format_stream_write_value_line(flipper_format->stream, &write_data);
     return result;
 }
@@ -281,6 +558,7 @@ bool flipper_format_read_float(
     const char* key,
     float* data,
     const uint16_t data_size) {
+    if(!flipper_format_seek_to_indexed_key(flipper_format, key)) return false;
     return flipper_format_stream_read_value_line(
         flipper_format->stream,
         key,
@@ -302,6 +580,7 @@ bool flipper_format_write_float(
         .data = data,
         .data_size = data_size,
     };
+    flipper_format_drop_index(flipper_format);
     bool result = flipper_format_stream_write_value_line(flipper_format->stream, &write_data);
     return result;
 }
@@ -311,6 +590,7 @@ bool flipper_format_read_hex(
     const char* key,
     uint8_t* data,
     const uint16_t data_size) {
+    if(!flipper_format_seek_to_indexed_key(flipper_format, key)) return false;
     return flipper_format_stream_read_value_line(
         flipper_format->stream,
         key,
@@ -332,6 +612,7 @@ bool flipper_format_write_hex(
         .data = data,
         .data_size = data_size,
     };
+    flipper_format_drop_index(flipper_format);
     bool result = flipper_format_stream_write_value_line(flipper_format->stream, &write_data);
     return result;
 }
@@ -343,6 +624,7 @@ bool flipper_format_write_comment(FlipperFormat* flipper_format, string_t data)
 
 bool flipper_format_write_comment_cstr(FlipperFormat* flipper_format, const char* data) {
     furi_assert(flipper_format);
+    flipper_format_drop_index(flipper_format);
     return flipper_format_stream_write_comment_cstr(flipper_format->stream, data);
 }
 
@@ -354,8 +636,7 @@ bool flipper_format_delete_key(FlipperFormat* flipper_format, const char* key) {
         .data = NULL,
         .data_size = 0,
     };
-    bool result = flipper_format_stream_delete_key_and_write(
-        flipper_format->stream, &write_data, flipper_format->strict_mode);
+    bool result = flipper_format_delete_key_and_write(flipper_format, &write_data);
     return result;
 }
 
@@ -367,8 +648,7 @@ bool flipper_format_update_string(FlipperFormat* flipper_format, const char* key
         .data = string_get_cstr(data),
         .data_size = 1,
     };
-    bool result = flipper_format_stream_delete_key_and_write(
-        flipper_format->stream, &write_data, flipper_format->strict_mode);
+    bool result = flipper_format_delete_key_and_write(flipper_format, &write_data);
     return result;
 }
 
@@ -383,8 +663,7 @@ bool flipper_format_update_string_cstr(
         .data = data,
         .data_size = 1,
     };
-    bool result = flipper_format_stream_delete_key_and_write(
-        flipper_format->stream, &write_data, flipper_format->strict_mode);
+    bool result = flipper_format_delete_key_and_write(flipper_format, &write_data);
     return result;
 }
 
@@ -400,8 +679,7 @@ bool flipper_format_update_uint32(
         .data = data,
         .data_size = data_size,
     };
-    bool result = flipper_format_stream_delete_key_and_write(
-        flipper_format->stream, &write_data, flipper_format->strict_mode);
+    bool result = flipper_format_delete_key_and_write(flipper_format, &write_data);
     return result;
 }
 
@@ -416,8 +694,7 @@ bool flipper_format_update_int32(
         .data = data,
         .data_size = data_size,
     };
-    bool result = flipper_format_stream_delete_key_and_write(
-        flipper_format->stream, &write_data, flipper_format->strict_mode);
+    bool result = flipper_format_delete_key_and_write(flipper_format, &write_data);
     return result;
 }
 
@@ -432,8 +709,7 @@ bool flipper_format_update_bool(
         .data = data,
         .data_size = data_size,
     };
-    bool result = flipper_format_stream_delete_key_and_write(
-        flipper_format->stream, &write_data, flipper_format->strict_mode);
+    bool result = flipper_format_delete_key_and_write(flipper_format, &write_data);
     return result;
 }
 
@@ -448,8 +724,7 @@ bool flipper_format_update_float(
         .data = data,
         .data_size = data_size,
     };
-    bool result = flipper_format_stream_delete_key_and_write(
-        flipper_format->stream, &write_data, flipper_format->strict_mode);
+    bool result = flipper_format_delete_key_and_write(flipper_format, &write_data);
     return result;
 }
 
@@ -464,8 +739,7 @@ bool flipper_format_update_hex(
         .data = data,
         .data_size = data_size,
     };
-    bool result = flipper_format_stream_delete_key_and_write(
-        flipper_format->stream, &write_data, flipper_format->strict_mode);
+    bool result = flipper_format_delete_key_and_write(flipper_format, &write_data);
     return result;
 }
 
@@ -115,6 +115,14 @@ FlipperFormat* flipper_format_string_alloc();
  */
 FlipperFormat* flipper_format_file_alloc(Storage* storage);
 
+/**
+ * Allocate FlipperFormat as file with a read cache.
+ * Parsing costs a few storage reads per cache window instead of a few per key.
+ * Open and close it with flipper_format_buffered_file_* functions only.
+ * @return FlipperFormat* pointer to a FlipperFormat instance
+ */
+FlipperFormat* flipper_format_buffered_file_alloc(Storage* storage);
+
 /**
  * Open existing file. 
  * Use only if FlipperFormat allocated as a file.
@@ -159,6 +167,23 @@ bool flipper_format_file_open_new(FlipperFormat* flipper_format, const char* pat
  */
 bool flipper_format_file_close(FlipperFormat* flipper_format);
 
+/**
+ * Open existing file. 
+ * Use only if FlipperFormat allocated as a buffered file.
+ * @param flipper_format Pointer to a FlipperFormat instance
+ * @param path File path
+ * @return True on success
+ */
+bool flipper_format_buffered_file_open_existing(FlipperFormat* flipper_format, const char* path);
+
+/**
+ * Closes the file, use only if FlipperFormat allocated as a buffered file.
+ * @param flipper_format 
+ * @return true 
+ * @return false 
+ */
+bool flipper_format_buffered_file_close(FlipperFormat* flipper_format);
+
 /**
  * Free FlipperFormat.
  * @param flipper_format Pointer to a FlipperFormat instance
@@ -172,6 +197,34 @@ void flipper_format_free(FlipperFormat* flipper_format);
  */
 void flipper_format_set_strict_mode(FlipperFormat* flipper_format, bool strict_mode);
 
+/**
+ * Enable key offset index. Index is built with a single pass on the first key lookup,
+ * so subsequent lookups jump straight to the key instead of scanning the stream.
+ * Index is dropped on every write and rebuilt on demand. Repeated keys are cheap,
+ * files with more than 255 distinct keys or over 16MB fall back to the regular scan.
+ * Disabled by default.
+ * Do not modify the raw stream while the index is enabled.
+ * @param flipper_format Pointer to a FlipperFormat instance
+ * @param enable True to enable the index
+ */
+void flipper_format_set_key_index(FlipperFormat* flipper_format, bool enable);
+
+/**
+ * Start an update transaction. Until commit, update and delete calls are only queued,
+ * so the stream and reads stay as they were. Commit applies all of them with a single
+ * rewrite of the file part they cover. Other writes are applied immediately.
+ * @param flipper_format Pointer to a FlipperFormat instance
+ */
+void flipper_format_transaction_begin(FlipperFormat* flipper_format);
+
+/**
+ * Apply queued updates and close the transaction.
+ * Nothing is written if one of the updated keys is missing.
+ * @param flipper_format Pointer to a FlipperFormat instance
+ * @return True on success
+ */
+bool flipper_format_transaction_commit(FlipperFormat* flipper_format);
+
 /**
  * Rewind the RW pointer.
  * @param flipper_format Pointer to a FlipperFormat instance
@@ -0,0 +1,212 @@
+#include <furi.h>
+#include <m-array.h>
+#include "flipper_format_index.h"
+#include "flipper_format_stream_i.h"
+
+#define TAG "FlipperFormatIndex"
+
+#define FLIPPER_FORMAT_INDEX_ID_BITS 8
+#define FLIPPER_FORMAT_INDEX_MAX_NAMES ((1UL << FLIPPER_FORMAT_INDEX_ID_BITS) - 1)
+#define FLIPPER_FORMAT_INDEX_MAX_OFFSET ((1UL << (32 - FLIPPER_FORMAT_INDEX_ID_BITS)) - 1)
+#define FLIPPER_FORMAT_INDEX_BUFFER_SIZE 64
+#define FLIPPER_FORMAT_INDEX_HASH_INIT 2166136261UL
+#define FLIPPER_FORMAT_INDEX_HASH_PRIME 16777619UL
+
+/*
+ * Every key line is packed into one word: line offset in the upper bits and
+ * the id of the key name in the lower ones. Key names are stored once as hashes,
+ * so files with many repeated keys (IR libraries, RAW captures) stay cheap.
+ */
+#define FLIPPER_FORMAT_INDEX_LINE(offset, id) \
+    (((uint32_t)(offset) << FLIPPER_FORMAT_INDEX_ID_BITS) | (uint32_t)(id))
+#define FLIPPER_FORMAT_INDEX_LINE_OFFSET(line) ((line) >> FLIPPER_FORMAT_INDEX_ID_BITS)
+#define FLIPPER_FORMAT_INDEX_LINE_ID(line) ((line)&FLIPPER_FORMAT_INDEX_MAX_NAMES)
+
+ARRAY_DEF(FlipperFormatIndexArray, uint32_t, M_POD_OPLIST)
+
+typedef enum {
+    FlipperFormatIndexStateInvalid,
+    FlipperFormatIndexStateValid,
+    FlipperFormatIndexStateOverflow,
+} FlipperFormatIndexState;
+
+struct FlipperFormatIndex {
+    FlipperFormatIndexArray_t names;
+    FlipperFormatIndexArray_t lines;
+    FlipperFormatIndexState state;
+    size_t stream_size;
+};
+
+static inline uint32_t flipper_format_index_hash_add(uint32_t hash, uint8_t data) {
+    return (hash ^ data) * FLIPPER_FORMAT_INDEX_HASH_PRIME;
+}
+
+static uint32_t flipper_format_index_hash(const char* key) {
+    uint32_t hash = FLIPPER_FORMAT_INDEX_HASH_INIT;
+    while(*key) {
+        hash = flipper_format_index_hash_add(hash, *key++);
+    }
+    return hash;
+}
+
+static bool flipper_format_index_find_name(FlipperFormatIndex* index, uint32_t hash, size_t* id) {
+    size_t count = FlipperFormatIndexArray_size(index->names);
+    for(size_t i = 0; i < count; i++) {
+        if(*FlipperFormatIndexArray_cget(index->names, i) == hash) {
+            *id = i;
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool
+    flipper_format_index_add_line(FlipperFormatIndex* index, uint32_t hash, size_t offset) {
+    size_t id;
+    if(!flipper_format_index_find_name(index, hash, &id)) {
+        id = FlipperFormatIndexArray_size(index->names);
+        if(id >= FLIPPER_FORMAT_INDEX_MAX_NAMES) return false;
+        FlipperFormatIndexArray_push_back(index->names, hash);
+    }
+
+    if(offset > FLIPPER_FORMAT_INDEX_MAX_OFFSET) return false;
+    FlipperFormatIndexArray_push_back(index->lines, FLIPPER_FORMAT_INDEX_LINE(offset, id));
+    return true;
+}
+
+FlipperFormatIndex* flipper_format_index_alloc() {
+    FlipperFormatIndex* index = malloc(sizeof(FlipperFormatIndex));
+    FlipperFormatIndexArray_init(index->names);
+    FlipperFormatIndexArray_init(index->lines);
+    index->state = FlipperFormatIndexStateInvalid;
+    return index;
+}
+
+void flipper_format_index_free(FlipperFormatIndex* index) {
+    furi_assert(index);
+    FlipperFormatIndexArray_clear(index->names);
+    FlipperFormatIndexArray_clear(index->lines);
+    free(index);
+}
+
+void flipper_format_index_invalidate(FlipperFormatIndex* index) {
+    furi_assert(index);
+    FlipperFormatIndexArray_reset(index->names);
+    FlipperFormatIndexArray_reset(index->lines);
+    index->state = FlipperFormatIndexStateInvalid;
+}
+
+/*
+ * Single pass over the whole stream, key lines are detected the same way
+ * flipper_format_stream_seek_to_key does: comments and lines starting with
+ * the delimiter are skipped, the rest of the line after the key is a value.
+ */
+static void flipper_format_index_build(FlipperFormatIndex* index, Stream* stream) {
+    flipper_format_index_invalidate(index);
+    index->stream_size = stream_size(stream);
+
+    size_t position = stream_tell(stream);
+    if(!stream_rewind(stream)) return;
+
+    uint8_t buffer[FLIPPER_FORMAT_INDEX_BUFFER_SIZE];
+    size_t offset = 0;
+    size_t line_start = 0;
+    uint32_t hash = FLIPPER_FORMAT_INDEX_HASH_INIT;
+    bool new_line = true;
+    bool accumulate = true;
+    bool overflow = false;
+
+    while(!overflow) {
+        size_t was_read = stream_read(stream, buffer, FLIPPER_FORMAT_INDEX_BUFFER_SIZE);
+        if(was_read == 0) break;
+
+        for(size_t i = 0; i < was_read; i++, offset++) {
+            uint8_t data = buffer[i];
+            if(data == flipper_format_eoln) {
+                line_start = offset + 1;
+                hash = FLIPPER_FORMAT_INDEX_HASH_INIT;
+                accumulate = true;
+                new_line = true;
+            } else if(data == flipper_format_eolr) {
+                // ignore
+            } else if(data == flipper_format_comment && new_line) {
+                accumulate = false;
+                new_line = false;
+            } else if(data == flipper_format_delimiter) {
+                if(accumulate && !new_line) {
+                    if(!flipper_format_index_add_line(index, hash, line_start)) {
+                        overflow = true;
+                        break;
+                    }
+                }
+                accumulate = false;
+                new_line = false;
+            } else {
+                new_line = false;
+                if(accumulate) {
+                    hash = flipper_format_index_hash_add(hash, data);
+                }
+            }
+        }
+    }
+
+    if(overflow) {
+        FURI_LOG_D(TAG, "Too many key names or file too big, falling back to scan");
+        flipper_format_index_invalidate(index);
+        index->state = FlipperFormatIndexStateOverflow;
+    } else {
+        index->state = FlipperFormatIndexStateValid;
+    }
+
+    if(!stream_seek(stream, position, StreamOffsetFromStart)) {
+        flipper_format_index_invalidate(index);
+    }
+}
+
+FlipperFormatIndexSeek flipper_format_index_seek(
+    FlipperFormatIndex* index,
+    Stream* stream,
+    const char* key,
+    bool strict_mode) {
+    furi_assert(index);
+
+    if(index->state == FlipperFormatIndexStateInvalid) {
+        flipper_format_index_build(index, stream);
+    }
+
+    if(index->state != FlipperFormatIndexStateValid) {
+        return FlipperFormatIndexSeekUnavailable;
+    }
+
+    // first key line at or after the current position
+    size_t position = stream_tell(stream);
+    size_t count = FlipperFormatIndexArray_size(index->lines);
+    size_t low = 0;
+    size_t high = count;
+    while(low < high) {
+        size_t middle = low + (high - low) / 2;
+        uint32_t line = *FlipperFormatIndexArray_cget(index->lines, middle);
+        if(FLIPPER_FORMAT_INDEX_LINE_OFFSET(line) < position) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+
+    // hash collisions are resolved by the regular key scan that follows
+    size_t id = 0;
+    bool known = flipper_format_index_find_name(index, flipper_format_index_hash(key), &id);
+    for(size_t i = low; i < count && (strict_mode || known); i++) {
+        uint32_t line = *FlipperFormatIndexArray_cget(index->lines, i);
+        if(strict_mode || FLIPPER_FORMAT_INDEX_LINE_ID(line) == id) {
+            size_t offset = FLIPPER_FORMAT_INDEX_LINE_OFFSET(line);
+            if(!stream_seek(stream, offset, StreamOffsetFromStart)) {
+                return FlipperFormatIndexSeekUnavailable;
+            }
+            return FlipperFormatIndexSeekFound;
+        }
+    }
+
+    stream_seek(stream, index->stream_size, StreamOffsetFromStart);
+    return FlipperFormatIndexSeekNotFound;
+}
@@ -0,0 +1,53 @@
+#pragma once
+#include <stdbool.h>
+#include <toolbox/stream/stream.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct FlipperFormatIndex FlipperFormatIndex;
+
+typedef enum {
+    FlipperFormatIndexSeekFound, /**< Stream is at the beginning of the key line */
+    FlipperFormatIndexSeekNotFound, /**< Key is not present, stream is at the end */
+    FlipperFormatIndexSeekUnavailable, /**< Index can not be used, scan the stream */
+} FlipperFormatIndexSeek;
+
+/**
+ * Allocate key offset index. Index is empty and will be built on first seek.
+ * @return FlipperFormatIndex* 
+ */
+FlipperFormatIndex* flipper_format_index_alloc();
+
+/**
+ * Free key offset index.
+ * @param index 
+ */
+void flipper_format_index_free(FlipperFormatIndex* index);
+
+/**
+ * Drop indexed offsets, index will be rebuilt on next seek.
+ * Must be called after every modification of the indexed stream.
+ * @param index 
+ */
+void flipper_format_index_invalidate(FlipperFormatIndex* index);
+
+/**
+ * Move stream to the line of the first key occurrence after the current position.
+ * Builds the index with a single pass over the stream if needed.
+ * @param index 
+ * @param stream 
+ * @param key 
+ * @param strict_mode in strict mode stream is moved to the next key, whatever it is
+ * @return FlipperFormatIndexSeek 
+ */
+FlipperFormatIndexSeek flipper_format_index_seek(
+    FlipperFormatIndex* index,
+    Stream* stream,
+    const char* key,
+    bool strict_mode);
+
+#ifdef __cplusplus
+}
+#endif
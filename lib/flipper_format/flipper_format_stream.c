@@ -447,10 +447,12 @@ bool flipper_format_stream_get_value_count(
     return result;
 }
 
-bool flipper_format_stream_delete_key_and_write(
+bool flipper_format_stream_find_key_line(
     Stream* stream,
-    FlipperStreamWriteData* write_data,
-    bool strict_mode) {
+    const char* key,
+    bool strict_mode,
+    size_t* start,
+    size_t* end) {
     bool result = false;
 
     do {
@@ -460,10 +462,10 @@ bool flipper_format_stream_delete_key_and_write(
         if(!stream_rewind(stream)) break;
 
         // find key
-        if(!flipper_format_stream_seek_to_key(stream, write_data->key, strict_mode)) break;
+        if(!flipper_format_stream_seek_to_key(stream, key, strict_mode)) break;
 
         // get key start position
-        size_t start_position = stream_tell(stream) - strlen(write_data->key);
+        size_t start_position = stream_tell(stream) - strlen(key);
         if(start_position >= 2) {
             start_position -= 2;
         } else {
@@ -479,6 +481,27 @@ bool flipper_format_stream_delete_key_and_write(
             end_position += 1;
         }
 
+        *start = start_position;
+        *end = end_position;
+        result = true;
+    } while(false);
+
+    return result;
+}
+
+bool flipper_format_stream_delete_key_and_write(
+    Stream* stream,
+    FlipperStreamWriteData* write_data,
+    bool strict_mode) {
+    bool result = false;
+
+    do {
+        size_t start_position = 0;
+        size_t end_position = 0;
+        if(!flipper_format_stream_find_key_line(
+               stream, write_data->key, strict_mode, &start_position, &end_position))
+            break;
+
         if(!stream_seek(stream, start_position, StreamOffsetFromStart)) break;
         if(!stream_delete_and_insert(
                stream,
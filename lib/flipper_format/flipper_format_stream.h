@@ -68,6 +68,23 @@ bool flipper_format_stream_get_value_count(
     uint32_t* count,
     bool strict_mode);
 
+/**
+ * Find the first key line from the beginning of the stream.
+ * @param stream 
+ * @param key 
+ * @param strict_mode 
+ * @param start key line start position
+ * @param end next line start position, or the end of the stream
+ * @return true 
+ * @return false 
+ */
+bool flipper_format_stream_find_key_line(
+    Stream* stream,
+    const char* key,
+    bool strict_mode,
+    size_t* start,
+    size_t* end);
+
 /**
  * Removes a key and the corresponding value string from the stream and inserts a new key/value pair.
  * @param stream 
@@ -48,6 +48,7 @@ const SubGhzProtocolDecoder subghz_protocol_came_decoder = {
 
     .feed = subghz_protocol_decoder_came_feed,
     .reset = subghz_protocol_decoder_came_reset,
+    .get_wakeup = subghz_protocol_decoder_came_get_wakeup,
 
     .get_hash_data = subghz_protocol_decoder_came_get_hash_data,
     .serialize = subghz_protocol_decoder_came_serialize,
@@ -272,6 +273,15 @@ void subghz_protocol_decoder_came_feed(void* context, bool level, uint32_t durat
     }
 }
 
+void subghz_protocol_decoder_came_get_wakeup(void* context, SubGhzProtocolDecoderWakeup* wakeup) {
+    furi_assert(context);
+    SubGhzProtocolDecoderCame* instance = context;
+    wakeup->parser_step = &instance->decoder.parser_step;
+    wakeup->level = false;
+    wakeup->duration = subghz_protocol_came_const.te_short * 51;
+    wakeup->delta = subghz_protocol_came_const.te_delta * 51;
+}
+
 uint8_t subghz_protocol_decoder_came_get_hash_data(void* context) {
     furi_assert(context);
     SubGhzProtocolDecoderCame* instance = context;
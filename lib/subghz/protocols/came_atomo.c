@@ -45,6 +45,7 @@ const SubGhzProtocolDecoder subghz_protocol_came_atomo_decoder = {
 
     .feed = subghz_protocol_decoder_came_atomo_feed,
     .reset = subghz_protocol_decoder_came_atomo_reset,
+    .get_wakeup = subghz_protocol_decoder_came_atomo_get_wakeup,
 
     .get_hash_data = subghz_protocol_decoder_came_atomo_get_hash_data,
     .serialize = subghz_protocol_decoder_came_atomo_serialize,
@@ -186,6 +187,17 @@ void subghz_protocol_decoder_came_atomo_feed(void* context, bool level, uint32_t
     }
 }
 
+void subghz_protocol_decoder_came_atomo_get_wakeup(
+    void* context,
+    SubGhzProtocolDecoderWakeup* wakeup) {
+    furi_assert(context);
+    SubGhzProtocolDecoderCameAtomo* instance = context;
+    wakeup->parser_step = &instance->decoder.parser_step;
+    wakeup->level = false;
+    wakeup->duration = subghz_protocol_came_atomo_const.te_long * 65;
+    wakeup->delta = subghz_protocol_came_atomo_const.te_delta * 20;
+}
+
 /** 
  * Read bytes from rainbow table
  * @param file_name Full path to rainbow table the file 
@@ -76,6 +76,7 @@ const SubGhzProtocolDecoder subghz_protocol_came_twee_decoder = {
 
     .feed = subghz_protocol_decoder_came_twee_feed,
     .reset = subghz_protocol_decoder_came_twee_reset,
+    .get_wakeup = subghz_protocol_decoder_came_twee_get_wakeup,
 
     .get_hash_data = subghz_protocol_decoder_came_twee_get_hash_data,
     .serialize = subghz_protocol_decoder_came_twee_serialize,
@@ -407,6 +408,17 @@ void subghz_protocol_decoder_came_twee_feed(void* context, bool level, uint32_t
     }
 }
 
+void subghz_protocol_decoder_came_twee_get_wakeup(
+    void* context,
+    SubGhzProtocolDecoderWakeup* wakeup) {
+    furi_assert(context);
+    SubGhzProtocolDecoderCameTwee* instance = context;
+    wakeup->parser_step = &instance->decoder.parser_step;
+    wakeup->level = false;
+    wakeup->duration = subghz_protocol_came_twee_const.te_long * 51;
+    wakeup->delta = subghz_protocol_came_twee_const.te_delta * 20;
+}
+
 uint8_t subghz_protocol_decoder_came_twee_get_hash_data(void* context) {
     furi_assert(context);
     SubGhzProtocolDecoderCameTwee* instance = context;
@@ -42,6 +42,7 @@ const SubGhzProtocolDecoder subghz_protocol_faac_slh_decoder = {
 
     .feed = subghz_protocol_decoder_faac_slh_feed,
     .reset = subghz_protocol_decoder_faac_slh_reset,
+    .get_wakeup = subghz_protocol_decoder_faac_slh_get_wakeup,
 
     .get_hash_data = subghz_protocol_decoder_faac_slh_get_hash_data,
     .serialize = subghz_protocol_decoder_faac_slh_serialize,
@@ -159,6 +160,17 @@ void subghz_protocol_decoder_faac_slh_feed(void* context, bool level, uint32_t d
     }
 }
 
+void subghz_protocol_decoder_faac_slh_get_wakeup(
+    void* context,
+    SubGhzProtocolDecoderWakeup* wakeup) {
+    furi_assert(context);
+    SubGhzProtocolDecoderFaacSLH* instance = context;
+    wakeup->parser_step = &instance->decoder.parser_step;
+    wakeup->level = true;
+    wakeup->duration = subghz_protocol_faac_slh_const.te_long * 2;
+    wakeup->delta = subghz_protocol_faac_slh_const.te_delta * 3;
+}
+
 /** 
  * Analysis of received data
  * @param instance Pointer to a SubGhzBlockGeneric* instance
@@ -38,6 +38,15 @@ void subghz_protocol_decoder_faac_slh_reset(void* context);
  */
 void subghz_protocol_decoder_faac_slh_feed(void* context, bool level, uint32_t duration);
 
+/**
+ * Get the pulse window that moves SubGhzProtocolDecoderFaacSLH out of reset step.
+ * @param context Pointer to a SubGhzProtocolDecoderFaacSLH instance
+ * @param wakeup Pointer to a SubGhzProtocolDecoderWakeup to fill
+ */
+void subghz_protocol_decoder_faac_slh_get_wakeup(
+    void* context,
+    SubGhzProtocolDecoderWakeup* wakeup);
+
 /**
  * Getting the hash sum of the last randomly received parcel.
  * @param context Pointer to a SubGhzProtocolDecoderFaacSLH instance
@@ -42,6 +42,7 @@ const SubGhzProtocolDecoder subghz_protocol_gate_tx_decoder = {
 
     .feed = subghz_protocol_decoder_gate_tx_feed,
     .reset = subghz_protocol_decoder_gate_tx_reset,
+    .get_wakeup = subghz_protocol_decoder_gate_tx_get_wakeup,
 
     .get_hash_data = subghz_protocol_decoder_gate_tx_get_hash_data,
     .serialize = subghz_protocol_decoder_gate_tx_serialize,
@@ -263,6 +264,17 @@ void subghz_protocol_decoder_gate_tx_feed(void* context, bool level, uint32_t du
     }
 }
 
+void subghz_protocol_decoder_gate_tx_get_wakeup(
+    void* context,
+    SubGhzProtocolDecoderWakeup* wakeup) {
+    furi_assert(context);
+    SubGhzProtocolDecoderGateTx* instance = context;
+    wakeup->parser_step = &instance->decoder.parser_step;
+    wakeup->level = false;
+    wakeup->duration = subghz_protocol_gate_tx_const.te_short * 47;
+    wakeup->delta = subghz_protocol_gate_tx_const.te_delta * 47;
+}
+
 /** 
  * Analysis of received data
  * @param instance Pointer to a SubGhzBlockGeneric* instance
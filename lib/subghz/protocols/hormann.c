@@ -44,6 +44,7 @@ const SubGhzProtocolDecoder subghz_protocol_hormann_decoder = {
 
     .feed = subghz_protocol_decoder_hormann_feed,
     .reset = subghz_protocol_decoder_hormann_reset,
+    .get_wakeup = subghz_protocol_decoder_hormann_get_wakeup,
 
     .get_hash_data = subghz_protocol_decoder_hormann_get_hash_data,
     .serialize = subghz_protocol_decoder_hormann_serialize,
@@ -290,6 +291,17 @@ void subghz_protocol_decoder_hormann_feed(void* context, bool level, uint32_t du
     }
 }
 
+void subghz_protocol_decoder_hormann_get_wakeup(
+    void* context,
+    SubGhzProtocolDecoderWakeup* wakeup) {
+    furi_assert(context);
+    SubGhzProtocolDecoderHormann* instance = context;
+    wakeup->parser_step = &instance->decoder.parser_step;
+    wakeup->level = true;
+    wakeup->duration = subghz_protocol_hormann_const.te_short * 64;
+    wakeup->delta = subghz_protocol_hormann_const.te_delta * 64;
+}
+
 /** 
  * Analysis of received data
  * @param instance Pointer to a SubGhzBlockGeneric* instance
@@ -72,6 +72,15 @@ void subghz_protocol_decoder_hormann_reset(void* context);
  */
 void subghz_protocol_decoder_hormann_feed(void* context, bool level, uint32_t duration);
 
+/**
+ * Get the pulse window that moves SubGhzProtocolDecoderHormann out of reset step.
+ * @param context Pointer to a SubGhzProtocolDecoderHormann instance
+ * @param wakeup Pointer to a SubGhzProtocolDecoderWakeup to fill
+ */
+void subghz_protocol_decoder_hormann_get_wakeup(
+    void* context,
+    SubGhzProtocolDecoderWakeup* wakeup);
+
 /**
  * Getting the hash sum of the last randomly received parcel.
  * @param context Pointer to a SubGhzProtocolDecoderHormann instance
@@ -42,6 +42,7 @@ const SubGhzProtocolDecoder subghz_protocol_ido_decoder = {
 
     .feed = subghz_protocol_decoder_ido_feed,
     .reset = subghz_protocol_decoder_ido_reset,
+    .get_wakeup = subghz_protocol_decoder_ido_get_wakeup,
 
     .get_hash_data = subghz_protocol_decoder_ido_get_hash_data,
     .deserialize = subghz_protocol_decoder_ido_deserialize,
@@ -158,6 +159,15 @@ void subghz_protocol_decoder_ido_feed(void* context, bool level, uint32_t durati
     }
 }
 
+void subghz_protocol_decoder_ido_get_wakeup(void* context, SubGhzProtocolDecoderWakeup* wakeup) {
+    furi_assert(context);
+    SubGhzProtocolDecoderIDo* instance = context;
+    wakeup->parser_step = &instance->decoder.parser_step;
+    wakeup->level = true;
+    wakeup->duration = subghz_protocol_ido_const.te_short * 10;
+    wakeup->delta = subghz_protocol_ido_const.te_delta * 5;
+}
+
 /** 
  * Analysis of received data
  * @param instance Pointer to a SubGhzBlockGeneric* instance
@@ -38,6 +38,13 @@ void subghz_protocol_decoder_ido_reset(void* context);
  */
 void subghz_protocol_decoder_ido_feed(void* context, bool level, uint32_t duration);
 
+/**
+ * Get the pulse window that moves SubGhzProtocolDecoderIDo out of reset step.
+ * @param context Pointer to a SubGhzProtocolDecoderIDo instance
+ * @param wakeup Pointer to a SubGhzProtocolDecoderWakeup to fill
+ */
+void subghz_protocol_decoder_ido_get_wakeup(void* context, SubGhzProtocolDecoderWakeup* wakeup);
+
 /**
  * Getting the hash sum of the last randomly received parcel.
  * @param context Pointer to a SubGhzProtocolDecoderIDo instance
@@ -54,6 +54,7 @@ const SubGhzProtocolDecoder subghz_protocol_keeloq_decoder = {
 
     .feed = subghz_protocol_decoder_keeloq_feed,
     .reset = subghz_protocol_decoder_keeloq_reset,
+    .get_wakeup = subghz_protocol_decoder_keeloq_get_wakeup,
 
     .get_hash_data = subghz_protocol_decoder_keeloq_get_hash_data,
     .serialize = subghz_protocol_decoder_keeloq_serialize,
@@ -433,6 +434,17 @@ void subghz_protocol_decoder_keeloq_feed(void* context, bool level, uint32_t dur
     }
 }
 
+void subghz_protocol_decoder_keeloq_get_wakeup(
+    void* context,
+    SubGhzProtocolDecoderWakeup* wakeup) {
+    furi_assert(context);
+    SubGhzProtocolDecoderKeeloq* instance = context;
+    wakeup->parser_step = &instance->decoder.parser_step;
+    wakeup->level = true;
+    wakeup->duration = subghz_protocol_keeloq_const.te_short;
+    wakeup->delta = subghz_protocol_keeloq_const.te_delta;
+}
+
 /**
  * Validation of decrypt data.
  * @param instance Pointer to a SubGhzBlockGeneric instance
@@ -94,6 +94,13 @@ void subghz_protocol_decoder_keeloq_reset(void* context);
  */
 void subghz_protocol_decoder_keeloq_feed(void* context, bool level, uint32_t duration);
 
+/**
+ * Get the pulse window that moves SubGhzProtocolDecoderKeeloq out of reset step.
+ * @param context Pointer to a SubGhzProtocolDecoderKeeloq instance
+ * @param wakeup Pointer to a SubGhzProtocolDecoderWakeup to fill
+ */
+void subghz_protocol_decoder_keeloq_get_wakeup(void* context, SubGhzProtocolDecoderWakeup* wakeup);
+
 /**
  * Getting the hash sum of the last randomly received parcel.
  * @param context Pointer to a SubGhzProtocolDecoderKeeloq instance
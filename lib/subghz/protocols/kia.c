@@ -44,6 +44,7 @@ const SubGhzProtocolDecoder subghz_protocol_kia_decoder = {
 
     .feed = subghz_protocol_decoder_kia_feed,
     .reset = subghz_protocol_decoder_kia_reset,
+    .get_wakeup = subghz_protocol_decoder_kia_get_wakeup,
 
     .get_hash_data = subghz_protocol_decoder_kia_get_hash_data,
     .serialize = subghz_protocol_decoder_kia_serialize,
@@ -188,6 +189,15 @@ void subghz_protocol_decoder_kia_feed(void* context, bool level, uint32_t durati
     }
 }
 
+void subghz_protocol_decoder_kia_get_wakeup(void* context, SubGhzProtocolDecoderWakeup* wakeup) {
+    furi_assert(context);
+    SubGhzProtocolDecoderKIA* instance = context;
+    wakeup->parser_step = &instance->decoder.parser_step;
+    wakeup->level = true;
+    wakeup->duration = subghz_protocol_kia_const.te_short;
+    wakeup->delta = subghz_protocol_kia_const.te_delta;
+}
+
 uint8_t subghz_protocol_kia_crc8(uint8_t* data, size_t len) {
     uint8_t crc = 0x08;
     size_t i, j;
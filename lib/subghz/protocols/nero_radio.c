@@ -44,6 +44,7 @@ const SubGhzProtocolDecoder subghz_protocol_nero_radio_decoder = {
 
     .feed = subghz_protocol_decoder_nero_radio_feed,
     .reset = subghz_protocol_decoder_nero_radio_reset,
+    .get_wakeup = subghz_protocol_decoder_nero_radio_get_wakeup,
 
     .get_hash_data = subghz_protocol_decoder_nero_radio_get_hash_data,
     .serialize = subghz_protocol_decoder_nero_radio_serialize,
@@ -330,6 +331,17 @@ void subghz_protocol_decoder_nero_radio_feed(void* context, bool level, uint32_t
     }
 }
 
+void subghz_protocol_decoder_nero_radio_get_wakeup(
+    void* context,
+    SubGhzProtocolDecoderWakeup* wakeup) {
+    furi_assert(context);
+    SubGhzProtocolDecoderNeroRadio* instance = context;
+    wakeup->parser_step = &instance->decoder.parser_step;
+    wakeup->level = true;
+    wakeup->duration = subghz_protocol_nero_radio_const.te_short;
+    wakeup->delta = subghz_protocol_nero_radio_const.te_delta;
+}
+
 uint8_t subghz_protocol_decoder_nero_radio_get_hash_data(void* context) {
     furi_assert(context);
     SubGhzProtocolDecoderNeroRadio* instance = context;
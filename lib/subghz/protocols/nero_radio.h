@@ -72,6 +72,15 @@ void subghz_protocol_decoder_nero_radio_reset(void* context);
  */
 void subghz_protocol_decoder_nero_radio_feed(void* context, bool level, uint32_t duration);
 
+/**
+ * Get the pulse window that moves SubGhzProtocolDecoderNeroRadio out of reset step.
+ * @param context Pointer to a SubGhzProtocolDecoderNeroRadio instance
+ * @param wakeup Pointer to a SubGhzProtocolDecoderWakeup to fill
+ */
+void subghz_protocol_decoder_nero_radio_get_wakeup(
+    void* context,
+    SubGhzProtocolDecoderWakeup* wakeup);
+
 /**
  * Getting the hash sum of the last randomly received parcel.
  * @param context Pointer to a SubGhzProtocolDecoderNeroRadio instance
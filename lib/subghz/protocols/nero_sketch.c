@@ -49,6 +49,7 @@ const SubGhzProtocolDecoder subghz_protocol_nero_sketch_decoder = {
 
     .feed = subghz_protocol_decoder_nero_sketch_feed,
     .reset = subghz_protocol_decoder_nero_sketch_reset,
+    .get_wakeup = subghz_protocol_decoder_nero_sketch_get_wakeup,
 
     .get_hash_data = subghz_protocol_decoder_nero_sketch_get_hash_data,
     .serialize = subghz_protocol_decoder_nero_sketch_serialize,
@@ -321,6 +322,17 @@ void subghz_protocol_decoder_nero_sketch_feed(void* context, bool level, uint32_
     }
 }
 
+void subghz_protocol_decoder_nero_sketch_get_wakeup(
+    void* context,
+    SubGhzProtocolDecoderWakeup* wakeup) {
+    furi_assert(context);
+    SubGhzProtocolDecoderNeroSketch* instance = context;
+    wakeup->parser_step = &instance->decoder.parser_step;
+    wakeup->level = true;
+    wakeup->duration = subghz_protocol_nero_sketch_const.te_short;
+    wakeup->delta = subghz_protocol_nero_sketch_const.te_delta;
+}
+
 uint8_t subghz_protocol_decoder_nero_sketch_get_hash_data(void* context) {
     furi_assert(context);
     SubGhzProtocolDecoderNeroSketch* instance = context;
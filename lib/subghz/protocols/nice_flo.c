@@ -47,6 +47,7 @@ const SubGhzProtocolDecoder subghz_protocol_nice_flo_decoder = {
 
     .feed = subghz_protocol_decoder_nice_flo_feed,
     .reset = subghz_protocol_decoder_nice_flo_reset,
+    .get_wakeup = subghz_protocol_decoder_nice_flo_get_wakeup,
 
     .get_hash_data = subghz_protocol_decoder_nice_flo_get_hash_data,
     .serialize = subghz_protocol_decoder_nice_flo_serialize,
@@ -271,6 +272,17 @@ void subghz_protocol_decoder_nice_flo_feed(void* context, bool level, uint32_t d
     }
 }
 
+void subghz_protocol_decoder_nice_flo_get_wakeup(
+    void* context,
+    SubGhzProtocolDecoderWakeup* wakeup) {
+    furi_assert(context);
+    SubGhzProtocolDecoderNiceFlo* instance = context;
+    wakeup->parser_step = &instance->decoder.parser_step;
+    wakeup->level = false;
+    wakeup->duration = subghz_protocol_nice_flo_const.te_short * 36;
+    wakeup->delta = subghz_protocol_nice_flo_const.te_delta * 36;
+}
+
 uint8_t subghz_protocol_decoder_nice_flo_get_hash_data(void* context) {
     furi_assert(context);
     SubGhzProtocolDecoderNiceFlo* instance = context;
@@ -50,6 +50,7 @@ const SubGhzProtocolDecoder subghz_protocol_nice_flor_s_decoder = {
 
     .feed = subghz_protocol_decoder_nice_flor_s_feed,
     .reset = subghz_protocol_decoder_nice_flor_s_reset,
+    .get_wakeup = subghz_protocol_decoder_nice_flor_s_get_wakeup,
 
     .get_hash_data = subghz_protocol_decoder_nice_flor_s_get_hash_data,
     .serialize = subghz_protocol_decoder_nice_flor_s_serialize,
@@ -277,6 +278,17 @@ void subghz_protocol_decoder_nice_flor_s_feed(void* context, bool level, uint32_
     }
 }
 
+void subghz_protocol_decoder_nice_flor_s_get_wakeup(
+    void* context,
+    SubGhzProtocolDecoderWakeup* wakeup) {
+    furi_assert(context);
+    SubGhzProtocolDecoderNiceFlorS* instance = context;
+    wakeup->parser_step = &instance->decoder.parser_step;
+    wakeup->level = false;
+    wakeup->duration = subghz_protocol_nice_flor_s_const.te_short * 38;
+    wakeup->delta = subghz_protocol_nice_flor_s_const.te_delta * 38;
+}
+
 /** 
  * Analysis of received data
  * @param instance Pointer to a SubGhzBlockGeneric* instance
@@ -51,6 +51,7 @@ const SubGhzProtocolDecoder subghz_protocol_princeton_decoder = {
 
     .feed = subghz_protocol_decoder_princeton_feed,
     .reset = subghz_protocol_decoder_princeton_reset,
+    .get_wakeup = subghz_protocol_decoder_princeton_get_wakeup,
 
     .get_hash_data = subghz_protocol_decoder_princeton_get_hash_data,
     .serialize = subghz_protocol_decoder_princeton_serialize,
@@ -282,6 +283,17 @@ void subghz_protocol_decoder_princeton_feed(void* context, bool level, uint32_t
     }
 }
 
+void subghz_protocol_decoder_princeton_get_wakeup(
+    void* context,
+    SubGhzProtocolDecoderWakeup* wakeup) {
+    furi_assert(context);
+    SubGhzProtocolDecoderPrinceton* instance = context;
+    wakeup->parser_step = &instance->decoder.parser_step;
+    wakeup->level = false;
+    wakeup->duration = subghz_protocol_princeton_const.te_short * 36;
+    wakeup->delta = subghz_protocol_princeton_const.te_delta * 36;
+}
+
 uint8_t subghz_protocol_decoder_princeton_get_hash_data(void* context) {
     furi_assert(context);
     SubGhzProtocolDecoderPrinceton* instance = context;
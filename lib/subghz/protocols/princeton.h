@@ -72,6 +72,15 @@ void subghz_protocol_decoder_princeton_reset(void* context);
  */
 void subghz_protocol_decoder_princeton_feed(void* context, bool level, uint32_t duration);
 
+/**
+ * Get the pulse window that moves SubGhzProtocolDecoderPrinceton out of reset step.
+ * @param context Pointer to a SubGhzProtocolDecoderPrinceton instance
+ * @param wakeup Pointer to a SubGhzProtocolDecoderWakeup to fill
+ */
+void subghz_protocol_decoder_princeton_get_wakeup(
+    void* context,
+    SubGhzProtocolDecoderWakeup* wakeup);
+
 /**
  * Getting the hash sum of the last randomly received parcel.
  * @param context Pointer to a SubGhzProtocolDecoderPrinceton instance
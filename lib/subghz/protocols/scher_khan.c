@@ -50,6 +50,7 @@ const SubGhzProtocolDecoder subghz_protocol_scher_khan_decoder = {
 
     .feed = subghz_protocol_decoder_scher_khan_feed,
     .reset = subghz_protocol_decoder_scher_khan_reset,
+    .get_wakeup = subghz_protocol_decoder_scher_khan_get_wakeup,
 
     .get_hash_data = subghz_protocol_decoder_scher_khan_get_hash_data,
     .serialize = subghz_protocol_decoder_scher_khan_serialize,
@@ -200,6 +201,17 @@ void subghz_protocol_decoder_scher_khan_feed(void* context, bool level, uint32_t
     }
 }
 
+void subghz_protocol_decoder_scher_khan_get_wakeup(
+    void* context,
+    SubGhzProtocolDecoderWakeup* wakeup) {
+    furi_assert(context);
+    SubGhzProtocolDecoderScherKhan* instance = context;
+    wakeup->parser_step = &instance->decoder.parser_step;
+    wakeup->level = true;
+    wakeup->duration = subghz_protocol_scher_khan_const.te_short * 2;
+    wakeup->delta = subghz_protocol_scher_khan_const.te_delta;
+}
+
 /** 
  * Analysis of received data
  * @param instance Pointer to a SubGhzBlockGeneric* instance
@@ -38,6 +38,15 @@ void subghz_protocol_decoder_scher_khan_reset(void* context);
  */
 void subghz_protocol_decoder_scher_khan_feed(void* context, bool level, uint32_t duration);
 
+/**
+ * Get the pulse window that moves SubGhzProtocolDecoderScherKhan out of reset step.
+ * @param context Pointer to a SubGhzProtocolDecoderScherKhan instance
+ * @param wakeup Pointer to a SubGhzProtocolDecoderWakeup to fill
+ */
+void subghz_protocol_decoder_scher_khan_get_wakeup(
+    void* context,
+    SubGhzProtocolDecoderWakeup* wakeup);
+
 /**
  * Getting the hash sum of the last randomly received parcel.
  * @param context Pointer to a SubGhzProtocolDecoderScherKhan instance
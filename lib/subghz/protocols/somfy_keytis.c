@@ -48,6 +48,7 @@ const SubGhzProtocolDecoder subghz_protocol_somfy_keytis_decoder = {
 
     .feed = subghz_protocol_decoder_somfy_keytis_feed,
     .reset = subghz_protocol_decoder_somfy_keytis_reset,
+    .get_wakeup = subghz_protocol_decoder_somfy_keytis_get_wakeup,
 
     .get_hash_data = subghz_protocol_decoder_somfy_keytis_get_hash_data,
     .serialize = subghz_protocol_decoder_somfy_keytis_serialize,
@@ -236,6 +237,17 @@ void subghz_protocol_decoder_somfy_keytis_feed(void* context, bool level, uint32
     }
 }
 
+void subghz_protocol_decoder_somfy_keytis_get_wakeup(
+    void* context,
+    SubGhzProtocolDecoderWakeup* wakeup) {
+    furi_assert(context);
+    SubGhzProtocolDecoderSomfyKeytis* instance = context;
+    wakeup->parser_step = &instance->decoder.parser_step;
+    wakeup->level = true;
+    wakeup->duration = subghz_protocol_somfy_keytis_const.te_short * 4;
+    wakeup->delta = subghz_protocol_somfy_keytis_const.te_delta * 4;
+}
+
 /** 
  * Analysis of received data
  * @param instance Pointer to a SubGhzBlockGeneric* instance
@@ -38,6 +38,15 @@ void subghz_protocol_decoder_somfy_keytis_reset(void* context);
  */
 void subghz_protocol_decoder_somfy_keytis_feed(void* context, bool level, uint32_t duration);
 
+/**
+ * Get the pulse window that moves SubGhzProtocolDecoderSomfyKeytis out of reset step.
+ * @param context Pointer to a SubGhzProtocolDecoderSomfyKeytis instance
+ * @param wakeup Pointer to a SubGhzProtocolDecoderWakeup to fill
+ */
+void subghz_protocol_decoder_somfy_keytis_get_wakeup(
+    void* context,
+    SubGhzProtocolDecoderWakeup* wakeup);
+
 /**
  * Getting the hash sum of the last randomly received parcel.
  * @param context Pointer to a SubGhzProtocolDecoderSomfyKeytis instance
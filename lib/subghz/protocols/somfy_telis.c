@@ -47,6 +47,7 @@ const SubGhzProtocolDecoder subghz_protocol_somfy_telis_decoder = {
 
     .feed = subghz_protocol_decoder_somfy_telis_feed,
     .reset = subghz_protocol_decoder_somfy_telis_reset,
+    .get_wakeup = subghz_protocol_decoder_somfy_telis_get_wakeup,
 
     .get_hash_data = subghz_protocol_decoder_somfy_telis_get_hash_data,
     .serialize = subghz_protocol_decoder_somfy_telis_serialize,
@@ -230,6 +231,17 @@ void subghz_protocol_decoder_somfy_telis_feed(void* context, bool level, uint32_
     }
 }
 
+void subghz_protocol_decoder_somfy_telis_get_wakeup(
+    void* context,
+    SubGhzProtocolDecoderWakeup* wakeup) {
+    furi_assert(context);
+    SubGhzProtocolDecoderSomfyTelis* instance = context;
+    wakeup->parser_step = &instance->decoder.parser_step;
+    wakeup->level = true;
+    wakeup->duration = subghz_protocol_somfy_telis_const.te_short * 4;
+    wakeup->delta = subghz_protocol_somfy_telis_const.te_delta * 4;
+}
+
 /** 
  * Analysis of received data
  * @param instance Pointer to a SubGhzBlockGeneric* instance
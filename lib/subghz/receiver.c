@@ -1,11 +1,13 @@
 #include "receiver.h"
 
 #include "protocols/registry.h"
+#include "blocks/math.h"
 
 #include <m-array.h>
 
 typedef struct {
     SubGhzProtocolEncoderBase* base;
+    SubGhzProtocolDecoderWakeup wakeup;
 } SubGhzReceiverSlot;
 
 ARRAY_DEF(SubGhzReceiverSlotArray, SubGhzReceiverSlot, M_POD_OPLIST);
@@ -14,6 +16,8 @@ ARRAY_DEF(SubGhzReceiverSlotArray, SubGhzReceiverSlot, M_POD_OPLIST);
 struct SubGhzReceiver {
     SubGhzReceiverSlotArray_t slots;
     SubGhzProtocolFlag filter;
+    bool prefilter;
+    SubGhzReceiverStats stats;
 
     SubGhzReceiverCallback callback;
     void* context;
@@ -29,9 +33,16 @@ SubGhzReceiver* subghz_receiver_alloc_init(SubGhzEnvironment* environment) {
         if(protocol->decoder && protocol->decoder->alloc) {
             SubGhzReceiverSlot* slot = SubGhzReceiverSlotArray_push_new(instance->slots);
             slot->base = protocol->decoder->alloc(environment);
+            slot->wakeup.parser_step = NULL;
+            if(protocol->decoder->get_wakeup) {
+                protocol->decoder->get_wakeup(slot->base, &slot->wakeup);
+            }
         }
     }
 
+    instance->prefilter = true;
+    subghz_receiver_reset_stats(instance);
+
     instance->callback = NULL;
     instance->context = NULL;
 
@@ -61,12 +72,37 @@ void subghz_receiver_decode(SubGhzReceiver* instance, bool level, uint32_t durat
 
     for
         M_EACH(slot, instance->slots, SubGhzReceiverSlotArray_t) {
-            if((slot->base->protocol->flag & instance->filter) == instance->filter) {
-                slot->base->protocol->decoder->feed(slot->base, level, duration);
+            if((slot->base->protocol->flag & instance->filter) != instance->filter) continue;
+
+            // Decoder waits in reset step and this pulse can't start a parcel: nothing to do
+            if(instance->prefilter && slot->wakeup.parser_step &&
+               *slot->wakeup.parser_step == 0 &&
+               (level != slot->wakeup.level ||
+                DURATION_DIFF(duration, slot->wakeup.duration) >= slot->wakeup.delta)) {
+                instance->stats.skip_count++;
+                continue;
             }
+
+            slot->base->protocol->decoder->feed(slot->base, level, duration);
+            instance->stats.feed_count++;
         }
 }
 
+void subghz_receiver_decode_batch(
+    SubGhzReceiver* instance,
+    const LevelDuration* batch,
+    size_t count) {
+    furi_assert(instance);
+    furi_assert(batch);
+
+    for(size_t i = 0; i < count; i++) {
+        subghz_receiver_decode(
+            instance,
+            level_duration_get_level(batch[i]),
+            level_duration_get_duration(batch[i]));
+    }
+}
+
 void subghz_receiver_reset(SubGhzReceiver* instance) {
     furi_assert(instance);
     furi_assert(instance->slots);
@@ -105,6 +141,23 @@ void subghz_receiver_set_filter(SubGhzReceiver* instance, SubGhzProtocolFlag fil
     instance->filter = filter;
 }
 
+void subghz_receiver_set_prefilter(SubGhzReceiver* instance, bool enable) {
+    furi_assert(instance);
+    instance->prefilter = enable;
+}
+
+void subghz_receiver_get_stats(SubGhzReceiver* instance, SubGhzReceiverStats* stats) {
+    furi_assert(instance);
+    furi_assert(stats);
+    *stats = instance->stats;
+}
+
+void subghz_receiver_reset_stats(SubGhzReceiver* instance) {
+    furi_assert(instance);
+    instance->stats.feed_count = 0;
+    instance->stats.skip_count = 0;
+}
+
 SubGhzProtocolDecoderBase* subghz_receiver_search_decoder_base_by_name(
     SubGhzReceiver* instance,
     const char* decoder_name) {
@@ -5,6 +5,11 @@
 
 typedef struct SubGhzReceiver SubGhzReceiver;
 
+typedef struct {
+    uint32_t feed_count; /**< pulses passed to decoders */
+    uint32_t skip_count; /**< pulses not passed to decoders idle in reset step */
+} SubGhzReceiverStats;
+
 typedef void (*SubGhzReceiverCallback)(
     SubGhzReceiver* decoder,
     SubGhzProtocolDecoderBase* decoder_base,
@@ -31,6 +36,17 @@ void subghz_receiver_free(SubGhzReceiver* instance);
  */
 void subghz_receiver_decode(SubGhzReceiver* instance, bool level, uint32_t duration);
 
+/**
+ * Parse a batch of levels and durations received from the air, in order.
+ * @param instance Pointer to a SubGhzReceiver instance
+ * @param batch Array of LevelDuration pairs
+ * @param count Number of pairs in batch
+ */
+void subghz_receiver_decode_batch(
+    SubGhzReceiver* instance,
+    const LevelDuration* batch,
+    size_t count);
+
 /**
  * Reset decoder SubGhzReceiver.
  * @param instance Pointer to a SubGhzReceiver instance
@@ -55,6 +71,27 @@ void subghz_receiver_set_rx_callback(
  */
 void subghz_receiver_set_filter(SubGhzReceiver* instance, SubGhzProtocolFlag filter);
 
+/**
+ * Enable or disable pre-filter. Enabled by default.
+ * With pre-filter decoders in reset step are fed only with the pulse that can wake them up.
+ * @param instance Pointer to a SubGhzReceiver instance
+ * @param enable true to enable pre-filter
+ */
+void subghz_receiver_set_prefilter(SubGhzReceiver* instance, bool enable);
+
+/**
+ * Get decoder feed counters.
+ * @param instance Pointer to a SubGhzReceiver instance
+ * @param stats Pointer to a SubGhzReceiverStats to fill
+ */
+void subghz_receiver_get_stats(SubGhzReceiver* instance, SubGhzReceiverStats* stats);
+
+/**
+ * Reset decoder feed counters.
+ * @param instance Pointer to a SubGhzReceiver instance
+ */
+void subghz_receiver_reset_stats(SubGhzReceiver* instance);
+
 /**
  * Search for a cattery by his name.
  * @param instance Pointer to a SubGhzReceiver instance
@@ -5,9 +5,12 @@
 
 #define TAG "SubGhzWorker"
 
+#define SUBGHZ_WORKER_BATCH_SIZE 64
+
 struct SubGhzWorker {
     FuriThread* thread;
     StreamBufferHandle_t stream;
+    LevelDuration* batch;
 
     volatile bool running;
     volatile bool overrun;
@@ -18,6 +21,7 @@ struct SubGhzWorker {
 
     SubGhzWorkerOverrunCallback overrun_callback;
     SubGhzWorkerPairCallback pair_callback;
+    SubGhzWorkerBatchCallback batch_callback;
     void* context;
 };
 
@@ -42,7 +46,30 @@ void subghz_worker_rx_callback(bool level, uint32_t duration, void* context) {
     portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
 }
 
+/** Deliver filtered pairs to batch or pair callback
+ * 
+ * @param instance Pointer to a SubGhzWorker instance
+ * @param count number of pairs in batch
+ */
+static void subghz_worker_deliver(SubGhzWorker* instance, size_t count) {
+    if(!count) return;
+
+    if(instance->batch_callback) {
+        instance->batch_callback(instance->context, instance->batch, count);
+    } else if(instance->pair_callback) {
+        for(size_t i = 0; i < count; i++) {
+            instance->pair_callback(
+                instance->context,
+                level_duration_get_level(instance->batch[i]),
+                level_duration_get_duration(instance->batch[i]));
+        }
+    }
+}
+
 /** Worker callback thread
+ * 
+ * Drains up to SUBGHZ_WORKER_BATCH_SIZE records per stream receive,
+ * glitch filter output is written back into the same buffer.
  * 
  * @param context 
  * @return exit code 
@@ -50,14 +77,22 @@ void subghz_worker_rx_callback(bool level, uint32_t duration, void* context) {
 static int32_t subghz_worker_thread_callback(void* context) {
     SubGhzWorker* instance = context;
 
-    LevelDuration level_duration;
     while(instance->running) {
-        int ret =
-            xStreamBufferReceive(instance->stream, &level_duration, sizeof(LevelDuration), 10);
-        if(ret == sizeof(LevelDuration)) {
+        size_t received = xStreamBufferReceive(
+            instance->stream,
+            instance->batch,
+            sizeof(LevelDuration) * SUBGHZ_WORKER_BATCH_SIZE,
+            10);
+        size_t count = received / sizeof(LevelDuration);
+        size_t out = 0;
+
+        for(size_t i = 0; i < count; i++) {
+            LevelDuration level_duration = instance->batch[i];
             if(level_duration_is_reset(level_duration)) {
                 FURI_LOG_E(TAG, "Overrun buffer");
-                ;
+                // Pairs received before overrun still belong to the old session
+                subghz_worker_deliver(instance, out);
+                out = 0;
                 if(instance->overrun_callback) instance->overrun_callback(instance->context);
             } else {
                 bool level = level_duration_get_level(level_duration);
@@ -69,21 +104,18 @@ static int32_t subghz_worker_thread_callback(void* context) {
                         instance->filter_level_duration.duration += duration;
 
                     } else if(instance->filter_level_duration.level != level) {
-                        if(instance->pair_callback)
-                            instance->pair_callback(
-                                instance->context,
-                                instance->filter_level_duration.level,
-                                instance->filter_level_duration.duration);
+                        instance->batch[out++] = instance->filter_level_duration;
 
                         instance->filter_level_duration.duration = duration;
                         instance->filter_level_duration.level = level;
                     }
                 } else {
-                    if(instance->pair_callback)
-                        instance->pair_callback(instance->context, level, duration);
+                    instance->batch[out++] = level_duration;
                 }
             }
         }
+
+        subghz_worker_deliver(instance, out);
     }
 
     return 0;
@@ -99,6 +131,7 @@ SubGhzWorker* subghz_worker_alloc() {
     furi_thread_set_callback(instance->thread, subghz_worker_thread_callback);
 
     instance->stream = xStreamBufferCreate(sizeof(LevelDuration) * 2048, sizeof(LevelDuration));
+    instance->batch = malloc(sizeof(LevelDuration) * SUBGHZ_WORKER_BATCH_SIZE);
 
     //setting filter
     instance->filter_running = true;
@@ -112,6 +145,7 @@ void subghz_worker_free(SubGhzWorker* instance) {
 
     vStreamBufferDelete(instance->stream);
     furi_thread_free(instance->thread);
+    free(instance->batch);
 
     free(instance);
 }
@@ -128,6 +162,13 @@ void subghz_worker_set_pair_callback(SubGhzWorker* instance, SubGhzWorkerPairCal
     instance->pair_callback = callback;
 }
 
+void subghz_worker_set_batch_callback(
+    SubGhzWorker* instance,
+    SubGhzWorkerBatchCallback callback) {
+    furi_assert(instance);
+    instance->batch_callback = callback;
+}
+
 void subghz_worker_set_context(SubGhzWorker* instance, void* context) {
     furi_assert(instance);
     instance->context = context;
@@ -8,6 +8,9 @@ typedef void (*SubGhzWorkerOverrunCallback)(void* context);
 
 typedef void (*SubGhzWorkerPairCallback)(void* context, bool level, uint32_t duration);
 
+typedef void (
+    *SubGhzWorkerBatchCallback)(void* context, const LevelDuration* batch, size_t count);
+
 void subghz_worker_rx_callback(bool level, uint32_t duration, void* context);
 
 /** 
@@ -38,6 +41,16 @@ void subghz_worker_set_overrun_callback(
  */
 void subghz_worker_set_pair_callback(SubGhzWorker* instance, SubGhzWorkerPairCallback callback);
 
+/** 
+ * Batch callback SubGhzWorker.
+ * Receives every filtered pair drained from the stream in one call, takes precedence over pair callback.
+ * @param instance Pointer to a SubGhzWorker instance
+ * @param callback SubGhzWorkerBatchCallback callback
+ */
+void subghz_worker_set_batch_callback(
+    SubGhzWorker* instance,
+    SubGhzWorkerBatchCallback callback);
+
 /** 
  * Context callback SubGhzWorker.
  * @param instance Pointer to a SubGhzWorker instance
@@ -21,6 +21,18 @@
 #define SUBGHZ_RAW_FILE_VERSION 1
 #define SUBGHZ_RAW_FILE_TYPE "Flipper SubGhz RAW File"
 
+/**
+ * Pulse window that can move a decoder out of its reset step.
+ * While parser step is 0 decoder ignores every pulse outside of this window,
+ * so receiver can skip feeding it.
+ */
+typedef struct {
+    const uint32_t* parser_step; /**< decoder parser step, 0 is reset step */
+    bool level; /**< level of the wakeup pulse */
+    uint32_t duration; /**< expected wakeup pulse duration, us */
+    uint32_t delta; /**< wakeup pulse matches if DURATION_DIFF(duration) < delta, us */
+} SubGhzProtocolDecoderWakeup;
+
 //
 // Abstract method types
 //
@@ -40,6 +52,7 @@ typedef bool (*SubGhzDeserialize)(void* context, FlipperFormat* flipper_format);
 // Decoder specific
 typedef void (*SubGhzDecoderFeed)(void* decoder, bool level, uint32_t duration);
 typedef void (*SubGhzDecoderReset)(void* decoder);
+typedef void (*SubGhzDecoderGetWakeup)(void* decoder, SubGhzProtocolDecoderWakeup* wakeup);
 typedef uint8_t (*SubGhzGetHashData)(void* decoder);
 typedef void (*SubGhzGetString)(void* decoder, string_t output);
 
@@ -53,6 +66,7 @@ typedef struct {
 
     SubGhzDecoderFeed feed;
     SubGhzDecoderReset reset;
+    SubGhzDecoderGetWakeup get_wakeup; /**< optional, enables receiver pre-filter */
 
     SubGhzGetHashData get_hash_data;
     SubGhzGetString get_string;
@@ -0,0 +1,21 @@
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Update zlib-compatible CRC32 with data, in software
+ * For long computations that must not hold hardware CRC block
+ * @param crc CRC32 of previous data, 0 for first block
+ * @param data data pointer
+ * @param size data size
+ * @return uint32_t CRC32 of previous data and this block
+ */
+uint32_t crc32_calc_buffer(uint32_t crc, const void* data, size_t size);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,257 @@
+#include "stream.h"
+#include "stream_i.h"
+#include "file_stream.h"
+#include "buffered_file_stream.h"
+
+#define BUFFERED_FILE_STREAM_CACHE_SIZE STREAM_CACHE_SIZE
+
+typedef struct {
+    Stream stream_base;
+    Stream* file_stream;
+    uint8_t* cache;
+    size_t cache_size;
+    size_t cache_position; // file offset of the first cached byte
+    size_t cache_length; // valid bytes in the cache
+    size_t position; // stream position, the file pointer is synced lazily
+    size_t file_position;
+    size_t size;
+} BufferedFileStream;
+
+static void buffered_file_stream_free(BufferedFileStream* stream);
+static bool buffered_file_stream_eof(BufferedFileStream* stream);
+static void buffered_file_stream_clean(BufferedFileStream* stream);
+static bool buffered_file_stream_seek(
+    BufferedFileStream* stream,
+    int32_t offset,
+    StreamOffset offset_type);
+static size_t buffered_file_stream_tell(BufferedFileStream* stream);
+static size_t buffered_file_stream_size(BufferedFileStream* stream);
+static size_t
+    buffered_file_stream_write(BufferedFileStream* stream, const uint8_t* data, size_t size);
+static size_t buffered_file_stream_read(BufferedFileStream* stream, uint8_t* data, size_t size);
+static bool buffered_file_stream_delete_and_insert(
+    BufferedFileStream* stream,
+    size_t delete_size,
+    StreamWriteCB write_callback,
+    const void* ctx);
+
+const StreamVTable buffered_file_stream_vtable = {
+    .free = (StreamFreeFn)buffered_file_stream_free,
+    .eof = (StreamEOFFn)buffered_file_stream_eof,
+    .clean = (StreamCleanFn)buffered_file_stream_clean,
+    .seek = (StreamSeekFn)buffered_file_stream_seek,
+    .tell = (StreamTellFn)buffered_file_stream_tell,
+    .size = (StreamSizeFn)buffered_file_stream_size,
+    .write = (StreamWriteFn)buffered_file_stream_write,
+    .read = (StreamReadFn)buffered_file_stream_read,
+    .delete_and_insert = (StreamDeleteAndInsertFn)buffered_file_stream_delete_and_insert,
+};
+
+Stream* buffered_file_stream_alloc(Storage* storage, size_t cache_size) {
+    BufferedFileStream* stream = malloc(sizeof(BufferedFileStream));
+    stream->file_stream = file_stream_alloc(storage);
+    stream->cache_size = cache_size ? cache_size : BUFFERED_FILE_STREAM_CACHE_SIZE;
+    stream->cache = malloc(stream->cache_size);
+    stream->cache_position = 0;
+    stream->cache_length = 0;
+    stream->position = 0;
+    stream->file_position = 0;
+    stream->size = 0;
+
+    stream->stream_base.vtable = &buffered_file_stream_vtable;
+    return (Stream*)stream;
+}
+
+static void buffered_file_stream_sync_state(BufferedFileStream* stream) {
+    stream->cache_length = 0;
+    stream->position = stream_tell(stream->file_stream);
+    stream->file_position = stream->position;
+    stream->size = stream_size(stream->file_stream);
+}
+
+bool buffered_file_stream_open(
+    Stream* _stream,
+    const char* path,
+    FS_AccessMode access_mode,
+    FS_OpenMode open_mode) {
+    furi_assert(_stream);
+    BufferedFileStream* stream = (BufferedFileStream*)_stream;
+    furi_check(stream->stream_base.vtable == &buffered_file_stream_vtable);
+    bool result = file_stream_open(stream->file_stream, path, access_mode, open_mode);
+    if(result) {
+        buffered_file_stream_sync_state(stream);
+    }
+    return result;
+}
+
+bool buffered_file_stream_close(Stream* _stream) {
+    furi_assert(_stream);
+    BufferedFileStream* stream = (BufferedFileStream*)_stream;
+    furi_check(stream->stream_base.vtable == &buffered_file_stream_vtable);
+    stream->cache_length = 0;
+    stream->position = 0;
+    stream->file_position = 0;
+    stream->size = 0;
+    return file_stream_close(stream->file_stream);
+}
+
+FS_Error buffered_file_stream_get_error(Stream* _stream) {
+    furi_assert(_stream);
+    BufferedFileStream* stream = (BufferedFileStream*)_stream;
+    furi_check(stream->stream_base.vtable == &buffered_file_stream_vtable);
+    return file_stream_get_error(stream->file_stream);
+}
+
+static void buffered_file_stream_free(BufferedFileStream* stream) {
+    stream_free(stream->file_stream);
+    free(stream->cache);
+    free(stream);
+}
+
+static bool buffered_file_stream_eof(BufferedFileStream* stream) {
+    return stream->position >= stream->size;
+}
+
+static void buffered_file_stream_clean(BufferedFileStream* stream) {
+    stream_clean(stream->file_stream);
+    buffered_file_stream_sync_state(stream);
+}
+
+static bool buffered_file_stream_seek(
+    BufferedFileStream* stream,
+    int32_t offset,
+    StreamOffset offset_type) {
+    bool result = false;
+    size_t seek_position = 0;
+
+    // only the stream position is moved, the file follows on the next miss or write
+    switch(offset_type) {
+    case StreamOffsetFromCurrent: {
+        if((int32_t)(stream->position + offset) >= 0) {
+            seek_position = stream->position + offset;
+            result = true;
+        }
+    } break;
+    case StreamOffsetFromStart: {
+        if(offset >= 0) {
+            seek_position = offset;
+            result = true;
+        }
+    } break;
+    case StreamOffsetFromEnd: {
+        if((int32_t)(stream->size + offset) >= 0) {
+            seek_position = stream->size + offset;
+            result = true;
+        }
+    } break;
+    }
+
+    if(result) {
+        // limit to top
+        if(seek_position > stream->size) {
+            stream->position = stream->size;
+            result = false;
+        } else {
+            stream->position = seek_position;
+        }
+    } else {
+        stream->position = 0;
+    }
+
+    return result;
+}
+
+static size_t buffered_file_stream_tell(BufferedFileStream* stream) {
+    return stream->position;
+}
+
+static size_t buffered_file_stream_size(BufferedFileStream* stream) {
+    return stream->size;
+}
+
+static bool buffered_file_stream_sync_position(BufferedFileStream* stream) {
+    if(stream->file_position != stream->position) {
+        if(!stream_seek(stream->file_stream, stream->position, StreamOffsetFromStart)) {
+            stream->file_position = stream_tell(stream->file_stream);
+            return false;
+        }
+        stream->file_position = stream->position;
+    }
+    return true;
+}
+
+static bool buffered_file_stream_fill(BufferedFileStream* stream) {
+    stream->cache_length = 0;
+    if(!buffered_file_stream_sync_position(stream)) return false;
+
+    size_t was_read = stream_read(stream->file_stream, stream->cache, stream->cache_size);
+    stream->cache_position = stream->position;
+    stream->cache_length = was_read;
+    stream->file_position += was_read;
+
+    return was_read > 0;
+}
+
+static size_t
+    buffered_file_stream_write(BufferedFileStream* stream, const uint8_t* data, size_t size) {
+    size_t was_written = 0;
+
+    // write through, cached data may be stale after that
+    stream->cache_length = 0;
+    if(buffered_file_stream_sync_position(stream)) {
+        was_written = stream_write(stream->file_stream, data, size);
+        stream->position += was_written;
+        stream->file_position = stream->position;
+        stream->size = MAX(stream->size, stream->position);
+    }
+
+    return was_written;
+}
+
+static size_t buffered_file_stream_read(BufferedFileStream* stream, uint8_t* data, size_t size) {
+    size_t was_read = 0;
+
+    while(was_read < size) {
+        bool cache_hit = (stream->position >= stream->cache_position) &&
+                         (stream->position < stream->cache_position + stream->cache_length);
+
+        if(!cache_hit) {
+            size_t need_to_read = size - was_read;
+            if(need_to_read >= stream->cache_size) {
+                // large reads go straight to the file
+                if(!buffered_file_stream_sync_position(stream)) break;
+                size_t bytes_read =
+                    stream_read(stream->file_stream, data + was_read, need_to_read);
+                stream->position += bytes_read;
+                stream->file_position += bytes_read;
+                was_read += bytes_read;
+                break;
+            }
+            if(!buffered_file_stream_fill(stream)) break;
+        }
+
+        size_t cache_offset = stream->position - stream->cache_position;
+        size_t chunk = MIN(size - was_read, stream->cache_length - cache_offset);
+        memcpy(data + was_read, stream->cache + cache_offset, chunk);
+        stream->position += chunk;
+        was_read += chunk;
+    }
+
+    return was_read;
+}
+
+static bool buffered_file_stream_delete_and_insert(
+    BufferedFileStream* stream,
+    size_t delete_size,
+    StreamWriteCB write_callback,
+    const void* ctx) {
+    bool result = false;
+
+    stream->cache_length = 0;
+    if(buffered_file_stream_sync_position(stream)) {
+        result = stream_delete_and_insert(stream->file_stream, delete_size, write_callback, ctx);
+    }
+    buffered_file_stream_sync_state(stream);
+
+    return result;
+}
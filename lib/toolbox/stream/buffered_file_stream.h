@@ -0,0 +1,51 @@
+#pragma once
+#include <stdlib.h>
+#include <storage/storage.h>
+#include "stream.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Allocate buffered file stream.
+ * Reads are served from a RAM window, so small reads and short backward seeks
+ * do not reach the storage. Writes go directly to the file.
+ * @param storage 
+ * @param cache_size read window size, 0 for default
+ * @return Stream* 
+ */
+Stream* buffered_file_stream_alloc(Storage* storage, size_t cache_size);
+
+/**
+ * Opens an existing file or create a new one.
+ * @param stream pointer to buffered file stream object.
+ * @param path path to file 
+ * @param access_mode access mode from FS_AccessMode 
+ * @param open_mode open mode from FS_OpenMode 
+ * @return success flag. You need to close the file even if the open operation failed.
+ */
+bool buffered_file_stream_open(
+    Stream* stream,
+    const char* path,
+    FS_AccessMode access_mode,
+    FS_OpenMode open_mode);
+
+/**
+ * Closes the file.
+ * @param stream 
+ * @return true 
+ * @return false 
+ */
+bool buffered_file_stream_close(Stream* stream);
+
+/** 
+ * Retrieves the error id from the file object
+ * @param stream pointer to stream object.
+ * @return FS_Error error id
+ */
+FS_Error buffered_file_stream_get_error(Stream* stream);
+
+#ifdef __cplusplus
+}
+#endif
@@ -161,6 +161,118 @@ static size_t file_stream_read(FileStream* stream, uint8_t* data, size_t size) {
     return size - need_to_read;
 }
 
+/**
+ * Move a block inside the file, destination must not be beyond the end of file.
+ * Overlapping blocks are copied in the direction that keeps the source intact.
+ */
+static bool file_stream_move(FileStream* stream, size_t from, size_t to, size_t size) {
+    uint8_t* buffer = malloc(STREAM_CACHE_SIZE);
+    bool result = true;
+
+    size_t done = 0;
+    while(done < size) {
+        size_t chunk = MIN((size_t)STREAM_CACHE_SIZE, size - done);
+        // towards the end: go from the last chunk to the first one
+        size_t offset = (to > from) ? (size - done - chunk) : done;
+
+        if(!file_stream_seek(stream, from + offset, StreamOffsetFromStart) ||
+           (file_stream_read(stream, buffer, chunk) != chunk) ||
+           !file_stream_seek(stream, to + offset, StreamOffsetFromStart) ||
+           (file_stream_write(stream, buffer, chunk) != chunk)) {
+            result = false;
+            break;
+        }
+        done += chunk;
+    }
+
+    free(buffer);
+    return result;
+}
+
+/** Append size bytes of padding, makes room for the tail shift */
+static bool file_stream_grow(FileStream* stream, size_t size) {
+    uint8_t* buffer = malloc(STREAM_CACHE_SIZE);
+    bool result = file_stream_seek(stream, 0, StreamOffsetFromEnd);
+
+    while(result && size > 0) {
+        size_t chunk = MIN((size_t)STREAM_CACHE_SIZE, size);
+        result = (file_stream_write(stream, buffer, chunk) == chunk);
+        size -= chunk;
+    }
+
+    free(buffer);
+    return result;
+}
+
+/** Stream that only counts written bytes, measures inserted data without buffering it */
+typedef struct {
+    Stream stream_base;
+    size_t size;
+} FileStreamCounter;
+
+static void file_stream_counter_free(FileStreamCounter* stream) {
+    UNUSED(stream);
+}
+
+static bool file_stream_counter_eof(FileStreamCounter* stream) {
+    UNUSED(stream);
+    return true;
+}
+
+static void file_stream_counter_clean(FileStreamCounter* stream) {
+    stream->size = 0;
+}
+
+static bool
+    file_stream_counter_seek(FileStreamCounter* stream, int32_t offset, StreamOffset offset_type) {
+    UNUSED(stream);
+    UNUSED(offset);
+    UNUSED(offset_type);
+    return false;
+}
+
+static size_t file_stream_counter_tell(FileStreamCounter* stream) {
+    return stream->size;
+}
+
+static size_t
+    file_stream_counter_write(FileStreamCounter* stream, const uint8_t* data, size_t size) {
+    UNUSED(data);
+    stream->size += size;
+    return size;
+}
+
+static size_t file_stream_counter_read(FileStreamCounter* stream, uint8_t* data, size_t size) {
+    UNUSED(stream);
+    UNUSED(data);
+    UNUSED(size);
+    return 0;
+}
+
+static bool file_stream_counter_delete_and_insert(
+    FileStreamCounter* stream,
+    size_t delete_size,
+    StreamWriteCB write_callback,
+    const void* ctx) {
+    UNUSED(stream);
+    UNUSED(delete_size);
+    UNUSED(write_callback);
+    UNUSED(ctx);
+    return false;
+}
+
+static const StreamVTable file_stream_counter_vtable = {
+    .free = (StreamFreeFn)file_stream_counter_free,
+    .eof = (StreamEOFFn)file_stream_counter_eof,
+    .clean = (StreamCleanFn)file_stream_counter_clean,
+    .seek = (StreamSeekFn)file_stream_counter_seek,
+    .tell = (StreamTellFn)file_stream_counter_tell,
+    .size = (StreamSizeFn)file_stream_counter_tell,
+    .write = (StreamWriteFn)file_stream_counter_write,
+    .read = (StreamReadFn)file_stream_counter_read,
+    .delete_and_insert = (StreamDeleteAndInsertFn)file_stream_counter_delete_and_insert,
+};
+
 static bool file_stream_delete_and_insert(
     FileStream* _stream,
     size_t delete_size,
@@ -169,63 +281,47 @@ static bool file_stream_delete_and_insert(
     bool result = false;
     Stream* stream = (Stream*)_stream;
 
-    // open scratchpad
-    Stream* scratch_stream = file_stream_alloc(_stream->storage);
+    size_t current_position = stream_tell(stream);
+    size_t file_size = stream_size(stream);
 
-    // TODO: we need something like "storage_open_tmpfile and storage_close_tmpfile"
-    string_t scratch_name;
-    string_t tmp_name;
-    string_init(tmp_name);
-    storage_get_next_filename(_stream->storage, "/any", ".scratch", ".pad", tmp_name, 255);
-    string_init_printf(scratch_name, "/any/%s.pad", string_get_cstr(tmp_name));
-    string_clear(tmp_name);
-
-    do {
-        if(!file_stream_open(
-               scratch_stream, string_get_cstr(scratch_name), FSAM_READ_WRITE, FSOM_CREATE_NEW))
-            break;
+    size_t size_to_delete = file_size - current_position;
+    size_to_delete = MIN(delete_size, size_to_delete);
 
-        size_t current_position = stream_tell(stream);
-        size_t file_size = stream_size(stream);
-
-        size_t size_to_delete = file_size - current_position;
-        size_to_delete = MIN(delete_size, size_to_delete);
-
-        size_t size_to_copy_before = current_position;
-        size_t size_to_copy_after = file_size - current_position - size_to_delete;
-
-        // copy file from 0 to insert position to scratchpad
-        if(!stream_rewind(stream)) break;
-        if(stream_copy(stream, scratch_stream, size_to_copy_before) != size_to_copy_before) break;
+    size_t tail_position = current_position + size_to_delete;
+    size_t tail_size = file_size - tail_position;
 
+    do {
+        // callback is called twice: to measure inserted data, then to write it in place
+        size_t insert_size = 0;
         if(write_callback) {
-            if(!write_callback(scratch_stream, ctx)) break;
+            FileStreamCounter counter = {
+                .stream_base.vtable = &file_stream_counter_vtable,
+                .size = 0,
+            };
+            if(!write_callback((Stream*)&counter, ctx)) break;
+            insert_size = counter.size;
+        }
+        size_t new_tail_position = current_position + insert_size;
+
+        // only the data after the replaced block is moved, equal size is written in place
+        if(new_tail_position > tail_position && tail_size > 0) {
+            if(!file_stream_grow(_stream, new_tail_position - tail_position)) break;
+            if(!file_stream_move(_stream, tail_position, new_tail_position, tail_size)) break;
+        } else if(new_tail_position < tail_position) {
+            if(!file_stream_move(_stream, tail_position, new_tail_position, tail_size)) break;
+            if(!stream_seek(stream, new_tail_position + tail_size, StreamOffsetFromStart)) break;
+            if(!storage_file_truncate(_stream->file)) break;
         }
-        size_t new_position = stream_tell(scratch_stream);
-
-        // copy key file after insert position + size_to_delete to scratchpad
-        if(!stream_seek(stream, size_to_delete, StreamOffsetFromCurrent)) break;
-        if(stream_copy(stream, scratch_stream, size_to_copy_after) != size_to_copy_after) break;
-
-        size_t new_file_size = stream_size(scratch_stream);
-
-        // copy whole scratchpad file to the original file
-        if(!stream_rewind(stream)) break;
-        if(!stream_rewind(scratch_stream)) break;
-        if(stream_copy(scratch_stream, stream, new_file_size) != new_file_size) break;
-
-        // and truncate original file
-        if(!storage_file_truncate(_stream->file)) break;
 
-        // move seek pointer at insert end
-        if(!stream_seek(stream, new_position, StreamOffsetFromStart)) break;
+        if(!stream_seek(stream, current_position, StreamOffsetFromStart)) break;
+        if(write_callback) {
+            if(!write_callback(stream, ctx)) break;
+            if(stream_tell(stream) != new_tail_position) break;
+        }
 
+        // seek pointer is at insert end
         result = true;
     } while(false);
 
-    stream_free(scratch_stream);
-    storage_common_remove(_stream->storage, string_get_cstr(scratch_name));
-    string_clear(scratch_name);
-
     return result;
-}
\ No newline at end of file
+}
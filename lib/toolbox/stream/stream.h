@@ -83,6 +83,7 @@ size_t stream_read(Stream* stream, uint8_t* data, size_t count);
 
 /**
  * Delete N chars from the stream and write data by calling write_callback(context)
+ * Callback may be called more than once and must write the same data every time
  * @param stream Stream instance
  * @param delete_size size of data to be deleted
  * @param write_callback write callback
@@ -1,4 +1,5 @@
 #include "tar_archive.h"
+#include "tar_heatshrink.h"
 
 #include <microtar.h>
 #include <storage/storage.h>
@@ -9,12 +10,19 @@
 #define MAX_NAME_LEN 255
 #define FILE_BLOCK_SIZE 512
 
+/* Blocks of extracted data queued for writer thread */
+#define TAR_ARCHIVE_UNPACK_QUEUE_DEPTH 4
+#define TAR_ARCHIVE_WRITER_STACK_SIZE 2048
+
 #define FILE_OPEN_NTRIES 10
 #define FILE_OPEN_RETRY_DELAY 25
 
 typedef struct TarArchive {
     Storage* storage;
+    File* stream;
     mtar_t tar;
+    TarHeatshrinkStream* heatshrink; /**< set if archive is compressed */
+    uint16_t unpack_block_size;
     tar_unpack_file_cb unpack_cb;
     void* unpack_cb_context;
 } TarArchive;
@@ -49,10 +57,40 @@ const struct mtar_ops filesystem_ops = {
     .close = mtar_storage_file_close,
 };
 
+static int mtar_heatshrink_write(void* stream, const void* data, unsigned size) {
+    int32_t bytes_written = tar_heatshrink_stream_write(stream, data, size);
+    return (bytes_written == (int32_t)size) ? bytes_written : MTAR_EWRITEFAIL;
+}
+
+static int mtar_heatshrink_read(void* stream, void* data, unsigned size) {
+    int32_t bytes_read = tar_heatshrink_stream_read(stream, data, size);
+    return (bytes_read == (int32_t)size) ? bytes_read : MTAR_EREADFAIL;
+}
+
+static int mtar_heatshrink_seek(void* stream, unsigned offset) {
+    bool res = tar_heatshrink_stream_seek(stream, offset);
+    return res ? MTAR_ESUCCESS : MTAR_ESEEKFAIL;
+}
+
+static int mtar_heatshrink_close(void* stream) {
+    if(stream && !tar_heatshrink_stream_close(stream)) {
+        return MTAR_EWRITEFAIL;
+    }
+    return MTAR_ESUCCESS;
+}
+
+const struct mtar_ops heatshrink_ops = {
+    .read = mtar_heatshrink_read,
+    .write = mtar_heatshrink_write,
+    .seek = mtar_heatshrink_seek,
+    .close = mtar_heatshrink_close,
+};
+
 TarArchive* tar_archive_alloc(Storage* storage) {
     furi_check(storage);
     TarArchive* archive = malloc(sizeof(TarArchive));
     archive->storage = storage;
+    archive->unpack_block_size = TAR_ARCHIVE_UNPACK_BLOCK_SIZE_DEFAULT;
     archive->unpack_cb = NULL;
     return archive;
 }
@@ -70,6 +108,7 @@ bool tar_archive_open(TarArchive* archive, const char* path, TarOpenMode mode) {
         open_mode = FSOM_OPEN_EXISTING;
         break;
     case TAR_OPEN_MODE_WRITE:
+    case TAR_OPEN_MODE_WRITE_HEATSHRINK:
         mtar_access = MTAR_WRITE;
         access_mode = FSAM_WRITE;
         open_mode = FSOM_CREATE_ALWAYS;
@@ -83,7 +122,29 @@ bool tar_archive_open(TarArchive* archive, const char* path, TarOpenMode mode) {
         storage_file_free(stream);
         return false;
     }
-    mtar_init(&archive->tar, mtar_access, &filesystem_ops, stream);
+
+    archive->stream = stream;
+    archive->heatshrink = NULL;
+    if(mode == TAR_OPEN_MODE_WRITE_HEATSHRINK) {
+        archive->heatshrink = tar_heatshrink_stream_open_write(
+            stream,
+            TAR_HEATSHRINK_WINDOW_SIZE_LOG_DEFAULT,
+            TAR_HEATSHRINK_LOOKAHEAD_SIZE_LOG_DEFAULT);
+    } else if((mode == TAR_OPEN_MODE_READ) && tar_heatshrink_is_compressed(stream)) {
+        archive->heatshrink = tar_heatshrink_stream_open_read(stream);
+    } else {
+        mtar_init(&archive->tar, mtar_access, &filesystem_ops, stream);
+        return true;
+    }
+
+    if(!archive->heatshrink) {
+        FURI_LOG_E(TAG, "Failed to set up compression for '%s'", path);
+        storage_file_close(stream);
+        storage_file_free(stream);
+        archive->stream = NULL;
+        return false;
+    }
+    mtar_init(&archive->tar, mtar_access, &heatshrink_ops, archive->heatshrink);
 
     return true;
 }
@@ -93,6 +154,10 @@ void tar_archive_free(TarArchive* archive) {
     if(mtar_is_open(&archive->tar)) {
         mtar_close(&archive->tar);
     }
+    if(archive->stream) {
+        storage_file_free(archive->stream);
+    }
+    free(archive);
 }
 
 void tar_archive_set_file_callback(TarArchive* archive, tar_unpack_file_cb callback, void* context) {
@@ -101,6 +166,12 @@ void tar_archive_set_file_callback(TarArchive* archive, tar_unpack_file_cb callb
     archive->unpack_cb_context = context;
 }
 
+void tar_archive_set_unpack_block_size(TarArchive* archive, uint16_t block_size) {
+    furi_assert(archive);
+    furi_check(block_size > 0);
+    archive->unpack_block_size = block_size;
+}
+
 static int tar_archive_entry_counter(mtar_t* tar, const mtar_header_t* header, void* param) {
     UNUSED(tar);
     UNUSED(header);
@@ -124,7 +195,12 @@ bool tar_archive_dir_add_element(TarArchive* archive, const char* dirpath) {
 
 bool tar_archive_finalize(TarArchive* archive) {
     furi_assert(archive);
-    return (mtar_finalize(&archive->tar) == MTAR_ESUCCESS);
+    bool success = (mtar_finalize(&archive->tar) == MTAR_ESUCCESS);
+    /* Compressed data still buffered in encoder has to reach the file */
+    if(archive->heatshrink) {
+        success = tar_heatshrink_stream_finish(archive->heatshrink) && success;
+    }
+    return success;
 }
 
 bool tar_archive_store_data(
@@ -160,16 +236,141 @@ bool tar_archive_file_finalize(TarArchive* archive) {
     return (mtar_end_data(&archive->tar) == MTAR_ESUCCESS);
 }
 
+typedef enum {
+    TarArchiveWriterOpen,
+    TarArchiveWriterData,
+    TarArchiveWriterClose,
+    TarArchiveWriterStop,
+} TarArchiveWriterMessageType;
+
+typedef struct {
+    TarArchiveWriterMessageType type;
+    char* path; /**< TarArchiveWriterOpen, freed by writer */
+    uint8_t* block; /**< TarArchiveWriterData, returned to free_blocks by writer */
+    uint16_t size;
+} TarArchiveWriterMessage;
+
+/* Writes extracted files on its own thread, so SD writes of one block overlap
+ * with reading and decompressing the next ones */
+typedef struct {
+    Storage* storage;
+    osMessageQueueId_t queue;
+    osMessageQueueId_t free_blocks;
+    uint8_t* blocks;
+    volatile bool failed;
+    FuriThread* thread;
+} TarArchiveWriter;
+
 typedef struct {
     TarArchive* archive;
     const char* work_dir;
+    TarArchiveWriter* writer;
 } TarArchiveDirectoryOpParams;
 
+static void tar_archive_writer_open(File* file, const char* path) {
+    uint8_t n_tries = FILE_OPEN_NTRIES;
+    while((n_tries-- > 0) && !storage_file_open(file, path, FSAM_WRITE, FSOM_CREATE_ALWAYS)) {
+        FURI_LOG_W(TAG, "Failed to open '%s', reties: %d", path, n_tries);
+        osDelay(FILE_OPEN_RETRY_DELAY);
+    }
+}
+
+static int32_t tar_archive_writer_thread(void* context) {
+    TarArchiveWriter* writer = context;
+    File* out_file = storage_file_alloc(writer->storage);
+    TarArchiveWriterMessage message;
+
+    while(true) {
+        furi_check(osMessageQueueGet(writer->queue, &message, NULL, osWaitForever) == osOK);
+        if(message.type == TarArchiveWriterStop) {
+            break;
+        }
+
+        switch(message.type) {
+        case TarArchiveWriterOpen:
+            tar_archive_writer_open(out_file, message.path);
+            if(!storage_file_is_open(out_file)) {
+                writer->failed = true;
+            }
+            free(message.path);
+            break;
+        case TarArchiveWriterData:
+            /* Data of file that failed to open is dropped */
+            if(storage_file_is_open(out_file) &&
+               (storage_file_write(out_file, message.block, message.size) != message.size)) {
+                writer->failed = true;
+            }
+            furi_check(
+                osMessageQueuePut(writer->free_blocks, &message.block, 0, osWaitForever) ==
+                osOK);
+            break;
+        case TarArchiveWriterClose:
+            if(storage_file_is_open(out_file)) {
+                storage_file_close(out_file);
+            }
+            break;
+        default:
+            break;
+        }
+    }
+
+    storage_file_free(out_file);
+    return 0;
+}
+
+static TarArchiveWriter* tar_archive_writer_alloc(Storage* storage, uint16_t block_size) {
+    TarArchiveWriter* writer = malloc(sizeof(TarArchiveWriter));
+    writer->storage = storage;
+    /* Bounded both ways: reader waits for free blocks and for space in queue */
+    writer->queue = osMessageQueueNew(
+        TAR_ARCHIVE_UNPACK_QUEUE_DEPTH + 2, sizeof(TarArchiveWriterMessage), NULL);
+    writer->free_blocks =
+        osMessageQueueNew(TAR_ARCHIVE_UNPACK_QUEUE_DEPTH, sizeof(uint8_t*), NULL);
+    writer->blocks = malloc(block_size * TAR_ARCHIVE_UNPACK_QUEUE_DEPTH);
+    for(size_t i = 0; i < TAR_ARCHIVE_UNPACK_QUEUE_DEPTH; i++) {
+        uint8_t* block = &writer->blocks[i * block_size];
+        furi_check(osMessageQueuePut(writer->free_blocks, &block, 0, 0) == osOK);
+    }
+
+    writer->thread = furi_thread_alloc();
+    furi_thread_set_name(writer->thread, "TarWriter");
+    furi_thread_set_stack_size(writer->thread, TAR_ARCHIVE_WRITER_STACK_SIZE);
+    furi_thread_set_context(writer->thread, writer);
+    furi_thread_set_callback(writer->thread, tar_archive_writer_thread);
+    furi_thread_start(writer->thread);
+
+    return writer;
+}
+
+/* Waits for queued writes to complete, returns false if any of them failed */
+static bool tar_archive_writer_free(TarArchiveWriter* writer) {
+    TarArchiveWriterMessage message = {.type = TarArchiveWriterStop};
+    furi_check(osMessageQueuePut(writer->queue, &message, 0, osWaitForever) == osOK);
+    furi_thread_join(writer->thread);
+    furi_thread_free(writer->thread);
+
+    bool success = !writer->failed;
+    osMessageQueueDelete(writer->queue);
+    osMessageQueueDelete(writer->free_blocks);
+    free(writer->blocks);
+    free(writer);
+    return success;
+}
+
+static void tar_archive_writer_post(TarArchiveWriter* writer, TarArchiveWriterMessage* message) {
+    furi_check(osMessageQueuePut(writer->queue, message, 0, osWaitForever) == osOK);
+}
+
 static int archive_extract_foreach_cb(mtar_t* tar, const mtar_header_t* header, void* param) {
     TarArchiveDirectoryOpParams* op_params = param;
     TarArchive* archive = op_params->archive;
+    TarArchiveWriter* writer = op_params->writer;
     string_t fname;
 
+    if(writer->failed) {
+        return -1;
+    }
+
     bool skip_entry = false;
     if(archive->unpack_cb) {
         skip_entry = !archive->unpack_cb(
@@ -197,38 +398,35 @@ static int archive_extract_foreach_cb(mtar_t* tar, const mtar_header_t* header,
 
     string_init(fname);
     path_concat(op_params->work_dir, header->name, fname);
-    FURI_LOG_I(TAG, "Extracting %d bytes to '%s'", header->size, header->name);
-    File* out_file = storage_file_alloc(archive->storage);
-    uint8_t* readbuf = malloc(FILE_BLOCK_SIZE);
+    FURI_LOG_D(TAG, "Extracting %d bytes to '%s'", header->size, header->name);
 
-    bool failed = false;
-    uint8_t n_tries = FILE_OPEN_NTRIES;
-    do {
-        while(
-            (n_tries-- > 0) &&
-            !storage_file_open(out_file, string_get_cstr(fname), FSAM_WRITE, FSOM_CREATE_ALWAYS)) {
-            FURI_LOG_W(TAG, "Failed to open '%s', reties: %d", string_get_cstr(fname), n_tries);
-            osDelay(FILE_OPEN_RETRY_DELAY);
-            continue;
-        }
+    TarArchiveWriterMessage message = {
+        .type = TarArchiveWriterOpen,
+        .path = strdup(string_get_cstr(fname)),
+    };
+    string_clear(fname);
+    tar_archive_writer_post(writer, &message);
 
-        if(!storage_file_is_open(out_file)) {
+    bool failed = false;
+    while(!mtar_eof_data(tar)) {
+        uint8_t* block;
+        furi_check(osMessageQueueGet(writer->free_blocks, &block, NULL, osWaitForever) == osOK);
+        int32_t readcnt = mtar_read_data(tar, block, archive->unpack_block_size);
+        if((readcnt <= 0) || writer->failed) {
+            osMessageQueuePut(writer->free_blocks, &block, 0, 0);
             failed = true;
             break;
         }
 
-        while(!mtar_eof_data(tar)) {
-            int32_t readcnt = mtar_read_data(tar, readbuf, FILE_BLOCK_SIZE);
-            if(!readcnt || !storage_file_write(out_file, readbuf, readcnt)) {
-                failed = true;
-                break;
-            }
-        }
-    } while(false);
+        message.type = TarArchiveWriterData;
+        message.block = block;
+        message.size = readcnt;
+        tar_archive_writer_post(writer, &message);
+    }
+
+    message.type = TarArchiveWriterClose;
+    tar_archive_writer_post(writer, &message);
 
-    storage_file_free(out_file);
-    free(readbuf);
-    string_clear(fname);
     return failed ? -1 : 0;
 }
 
@@ -237,11 +435,15 @@ bool tar_archive_unpack_to(TarArchive* archive, const char* destination) {
     TarArchiveDirectoryOpParams param = {
         .archive = archive,
         .work_dir = destination,
+        .writer = tar_archive_writer_alloc(archive->storage, archive->unpack_block_size),
     };
 
     FURI_LOG_I(TAG, "Restoring '%s'", destination);
 
-    return (mtar_foreach(&archive->tar, archive_extract_foreach_cb, &param) == MTAR_ESUCCESS);
+    bool success =
+        (mtar_foreach(&archive->tar, archive_extract_foreach_cb, &param) == MTAR_ESUCCESS);
+    /* Writes are still in flight when foreach returns */
+    return tar_archive_writer_free(param.writer) && success;
 };
 
 bool tar_archive_add_file(
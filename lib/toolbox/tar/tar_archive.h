@@ -9,11 +9,14 @@ extern "C" {
 
 typedef struct TarArchive TarArchive;
 
+#define TAR_ARCHIVE_UNPACK_BLOCK_SIZE_DEFAULT 2048
+
 typedef struct Storage Storage;
 
 typedef enum {
-    TAR_OPEN_MODE_READ = 'r',
+    TAR_OPEN_MODE_READ = 'r', /* plain or heatshrink-compressed, detected by header */
     TAR_OPEN_MODE_WRITE = 'w',
+    TAR_OPEN_MODE_WRITE_HEATSHRINK = 'h',
     TAR_OPEN_MODE_STDOUT = 's' /* to be implemented */
 } TarOpenMode;
 
@@ -23,6 +26,9 @@ bool tar_archive_open(TarArchive* archive, const char* path, TarOpenMode mode);
 
 void tar_archive_free(TarArchive* archive);
 
+/* Size of blocks extracted files are written in, 4 of them are kept in RAM while unpacking */
+void tar_archive_set_unpack_block_size(TarArchive* archive, uint16_t block_size);
+
 /* High-level API  - assumes archive is open */
 bool tar_archive_unpack_to(TarArchive* archive, const char* destination);
 
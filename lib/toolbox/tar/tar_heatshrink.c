@@ -0,0 +1,332 @@
+#include "tar_heatshrink.h"
+
+#include <furi.h>
+#include <lib/heatshrink/heatshrink_encoder.h>
+#include <lib/heatshrink/heatshrink_decoder.h>
+
+#define TAG "TarHs"
+
+/* Compressed data is read from and written to SD in blocks of this size */
+#define TAR_HEATSHRINK_FILE_BUFFER_SIZE 1024
+/* Decoded data kept for backward seeks, one tar header */
+#define TAR_HEATSHRINK_HISTORY_SIZE 512
+
+struct TarHeatshrinkStream {
+    File* file;
+    heatshrink_encoder* encoder;
+    heatshrink_decoder* decoder;
+    uint8_t* window;
+    uint8_t* file_buffer;
+    size_t file_buffer_pos;
+    size_t file_buffer_len;
+    bool input_finished;
+    bool finished; /**< encoder output is flushed, no more writes */
+    uint32_t position; /**< position in decompressed data */
+    uint32_t decoded; /**< bytes produced by decoder so far */
+    uint8_t* history; /**< last decoded bytes, ends at decoded */
+    size_t history_len;
+};
+
+static bool tar_heatshrink_read_header(File* file, TarHeatshrinkHeader* header) {
+    return storage_file_seek(file, 0, true) &&
+           (storage_file_read(file, header, sizeof(TarHeatshrinkHeader)) ==
+            sizeof(TarHeatshrinkHeader)) &&
+           (memcmp(header->magic, TAR_HEATSHRINK_MAGIC, sizeof(header->magic)) == 0);
+}
+
+bool tar_heatshrink_is_compressed(File* file) {
+    TarHeatshrinkHeader header;
+    bool compressed = tar_heatshrink_read_header(file, &header);
+    storage_file_seek(file, 0, true);
+    return compressed;
+}
+
+static TarHeatshrinkStream* tar_heatshrink_stream_alloc(File* file) {
+    TarHeatshrinkStream* stream = malloc(sizeof(TarHeatshrinkStream));
+    stream->file = file;
+    stream->file_buffer = malloc(TAR_HEATSHRINK_FILE_BUFFER_SIZE);
+    return stream;
+}
+
+static void tar_heatshrink_stream_free(TarHeatshrinkStream* stream) {
+    if(stream->encoder) {
+        heatshrink_encoder_free(stream->encoder);
+    }
+    if(stream->decoder) {
+        heatshrink_decoder_free(stream->decoder);
+    }
+    free(stream->window);
+    free(stream->history);
+    free(stream->file_buffer);
+    free(stream);
+}
+
+TarHeatshrinkStream* tar_heatshrink_stream_open_read(File* file) {
+    furi_assert(file);
+
+    TarHeatshrinkHeader header;
+    if(!tar_heatshrink_read_header(file, &header) ||
+       (header.version != TAR_HEATSHRINK_VERSION) ||
+       (header.window_sz2 > TAR_HEATSHRINK_WINDOW_SIZE_LOG_MAX)) {
+        return NULL;
+    }
+
+    TarHeatshrinkStream* stream = tar_heatshrink_stream_alloc(file);
+    stream->window = malloc(TAR_HEATSHRINK_FILE_BUFFER_SIZE + (1 << header.window_sz2));
+    stream->decoder = heatshrink_decoder_alloc(
+        stream->window,
+        TAR_HEATSHRINK_FILE_BUFFER_SIZE,
+        header.window_sz2,
+        header.lookahead_sz2);
+    if(!stream->decoder) {
+        FURI_LOG_E(TAG, "Unsupported parameters %u/%u", header.window_sz2, header.lookahead_sz2);
+        tar_heatshrink_stream_free(stream);
+        return NULL;
+    }
+    stream->history = malloc(TAR_HEATSHRINK_HISTORY_SIZE);
+
+    return stream;
+}
+
+TarHeatshrinkStream*
+    tar_heatshrink_stream_open_write(File* file, uint8_t window_sz2, uint8_t lookahead_sz2) {
+    furi_assert(file);
+
+    if(window_sz2 > TAR_HEATSHRINK_WINDOW_SIZE_LOG_MAX) {
+        return NULL;
+    }
+
+    TarHeatshrinkStream* stream = tar_heatshrink_stream_alloc(file);
+    stream->window = malloc(2 << window_sz2);
+    stream->encoder = heatshrink_encoder_alloc(stream->window, window_sz2, lookahead_sz2);
+
+    TarHeatshrinkHeader header = {
+        .version = TAR_HEATSHRINK_VERSION,
+        .window_sz2 = window_sz2,
+        .lookahead_sz2 = lookahead_sz2,
+    };
+    memcpy(header.magic, TAR_HEATSHRINK_MAGIC, sizeof(header.magic));
+
+    if(!stream->encoder ||
+       (storage_file_write(file, &header, sizeof(header)) != sizeof(header))) {
+        tar_heatshrink_stream_free(stream);
+        return NULL;
+    }
+
+    return stream;
+}
+
+static void tar_heatshrink_history_append(
+    TarHeatshrinkStream* stream,
+    const uint8_t* data,
+    size_t size) {
+    if(size >= TAR_HEATSHRINK_HISTORY_SIZE) {
+        memcpy(
+            stream->history,
+            &data[size - TAR_HEATSHRINK_HISTORY_SIZE],
+            TAR_HEATSHRINK_HISTORY_SIZE);
+        stream->history_len = TAR_HEATSHRINK_HISTORY_SIZE;
+        return;
+    }
+
+    size_t keep = MIN(stream->history_len, TAR_HEATSHRINK_HISTORY_SIZE - size);
+    memmove(stream->history, &stream->history[stream->history_len - keep], keep);
+    memcpy(&stream->history[keep], data, size);
+    stream->history_len = keep + size;
+}
+
+/* Decode up to size bytes, returns -1 on error */
+static int32_t tar_heatshrink_decode(TarHeatshrinkStream* stream, uint8_t* data, size_t size) {
+    size_t produced = 0;
+
+    while(produced < size) {
+        size_t polled = 0;
+        HSD_poll_res poll_res = heatshrink_decoder_poll(
+            stream->decoder, &data[produced], size - produced, &polled);
+        if(poll_res < 0) {
+            return -1;
+        }
+        produced += polled;
+        if(poll_res == HSDR_POLL_MORE) {
+            continue;
+        }
+
+        /* Decoder is drained, feed it */
+        if(stream->file_buffer_pos == stream->file_buffer_len) {
+            if(stream->input_finished) {
+                break;
+            }
+            stream->file_buffer_pos = 0;
+            stream->file_buffer_len = storage_file_read(
+                stream->file, stream->file_buffer, TAR_HEATSHRINK_FILE_BUFFER_SIZE);
+            if(stream->file_buffer_len == 0) {
+                if(heatshrink_decoder_finish(stream->decoder) != HSDR_FINISH_MORE) {
+                    stream->input_finished = true;
+                    break;
+                }
+                continue;
+            }
+        }
+
+        size_t sunk = 0;
+        if(heatshrink_decoder_sink(
+               stream->decoder,
+               &stream->file_buffer[stream->file_buffer_pos],
+               stream->file_buffer_len - stream->file_buffer_pos,
+               &sunk) < 0) {
+            return -1;
+        }
+        stream->file_buffer_pos += sunk;
+    }
+
+    tar_heatshrink_history_append(stream, data, produced);
+    stream->decoded += produced;
+    return produced;
+}
+
+int32_t tar_heatshrink_stream_read(TarHeatshrinkStream* stream, void* data, uint32_t size) {
+    furi_assert(stream);
+    furi_assert(stream->decoder);
+
+    uint8_t* out = data;
+    uint32_t done = 0;
+
+    /* Replay history after backward seek */
+    if(stream->position < stream->decoded) {
+        size_t behind = stream->decoded - stream->position;
+        done = MIN(size, behind);
+        memcpy(out, &stream->history[stream->history_len - behind], done);
+    }
+
+    if(done < size) {
+        int32_t decoded = tar_heatshrink_decode(stream, &out[done], size - done);
+        if(decoded < 0) {
+            return -1;
+        }
+        done += decoded;
+    }
+
+    stream->position += done;
+    return done;
+}
+
+static bool tar_heatshrink_flush(TarHeatshrinkStream* stream) {
+    size_t len = stream->file_buffer_len;
+    stream->file_buffer_len = 0;
+    return storage_file_write(stream->file, stream->file_buffer, len) == len;
+}
+
+/* Move encoder output to file buffer, writing it to file when full */
+static bool tar_heatshrink_drain(TarHeatshrinkStream* stream) {
+    HSE_poll_res poll_res;
+    do {
+        size_t polled = 0;
+        poll_res = heatshrink_encoder_poll(
+            stream->encoder,
+            &stream->file_buffer[stream->file_buffer_len],
+            TAR_HEATSHRINK_FILE_BUFFER_SIZE - stream->file_buffer_len,
+            &polled);
+        if(poll_res < 0) {
+            return false;
+        }
+        stream->file_buffer_len += polled;
+        if((stream->file_buffer_len == TAR_HEATSHRINK_FILE_BUFFER_SIZE) &&
+           !tar_heatshrink_flush(stream)) {
+            return false;
+        }
+    } while(poll_res == HSER_POLL_MORE);
+    return true;
+}
+
+int32_t tar_heatshrink_stream_write(TarHeatshrinkStream* stream, const void* data, uint32_t size) {
+    furi_assert(stream);
+    furi_assert(stream->encoder);
+
+    if(stream->finished) {
+        return -1;
+    }
+
+    uint32_t sunk_total = 0;
+    while(sunk_total < size) {
+        size_t sunk = 0;
+        if(heatshrink_encoder_sink(
+               stream->encoder, (uint8_t*)data + sunk_total, size - sunk_total, &sunk) < 0) {
+            return -1;
+        }
+        sunk_total += sunk;
+        if(!tar_heatshrink_drain(stream)) {
+            return -1;
+        }
+    }
+
+    stream->position += size;
+    return size;
+}
+
+bool tar_heatshrink_stream_seek(TarHeatshrinkStream* stream, uint32_t position) {
+    furi_assert(stream);
+
+    if(stream->encoder) {
+        return position == stream->position;
+    }
+
+    if(position + stream->history_len < stream->decoded) {
+        /* Too far back: start over */
+        if(!storage_file_seek(stream->file, sizeof(TarHeatshrinkHeader), true)) {
+            return false;
+        }
+        heatshrink_decoder_reset(stream->decoder);
+        stream->file_buffer_pos = 0;
+        stream->file_buffer_len = 0;
+        stream->input_finished = false;
+        stream->decoded = 0;
+        stream->history_len = 0;
+    }
+
+    if(position <= stream->decoded) {
+        stream->position = position;
+        return true;
+    }
+
+    /* Skip forward by decoding, last chunk lands in history */
+    stream->position = stream->decoded;
+    uint8_t* skip_buffer = malloc(TAR_HEATSHRINK_HISTORY_SIZE);
+    bool success = true;
+    while(success && (stream->position < position)) {
+        uint32_t chunk = MIN(position - stream->position, TAR_HEATSHRINK_HISTORY_SIZE);
+        success = (tar_heatshrink_stream_read(stream, skip_buffer, chunk) == (int32_t)chunk);
+    }
+    free(skip_buffer);
+    return success;
+}
+
+bool tar_heatshrink_stream_finish(TarHeatshrinkStream* stream) {
+    furi_assert(stream);
+    furi_assert(stream->encoder);
+
+    if(stream->finished) {
+        return true;
+    }
+    stream->finished = true;
+
+    bool success = true;
+    HSE_finish_res finish_res = HSER_FINISH_MORE;
+    while(success &&
+          ((finish_res = heatshrink_encoder_finish(stream->encoder)) == HSER_FINISH_MORE)) {
+        success = tar_heatshrink_drain(stream);
+    }
+    return success && (finish_res == HSER_FINISH_DONE) && tar_heatshrink_flush(stream);
+}
+
+bool tar_heatshrink_stream_close(TarHeatshrinkStream* stream) {
+    furi_assert(stream);
+
+    bool success = true;
+    if(stream->encoder) {
+        success = tar_heatshrink_stream_finish(stream);
+    }
+
+    storage_file_close(stream->file);
+    tar_heatshrink_stream_free(stream);
+    return success;
+}
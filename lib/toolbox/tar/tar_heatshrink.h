@@ -0,0 +1,100 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <storage/storage.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Compressed tar: TarHeatshrinkHeader followed by heatshrink stream of plain tar.
+ * Keep in sync with scripts/flipper/utils/tarhs.py
+ */
+#define TAR_HEATSHRINK_MAGIC "\x89HST"
+#define TAR_HEATSHRINK_VERSION 1
+
+#define TAR_HEATSHRINK_WINDOW_SIZE_LOG_DEFAULT 11
+#define TAR_HEATSHRINK_LOOKAHEAD_SIZE_LOG_DEFAULT 4
+/* Limits decoder RAM usage for archives made on host */
+#define TAR_HEATSHRINK_WINDOW_SIZE_LOG_MAX 13
+
+#pragma pack(push, 1)
+
+typedef struct {
+    char magic[4];
+    uint8_t version;
+    uint8_t window_sz2;
+    uint8_t lookahead_sz2;
+    uint8_t flags; /**< reserved, 0 */
+} TarHeatshrinkHeader;
+
+#pragma pack(pop)
+
+typedef struct TarHeatshrinkStream TarHeatshrinkStream;
+
+/** Check if file starts with compressed tar header. Read pointer is restored
+ *
+ * @param      file  open file
+ *
+ * @return     true if file is compressed tar
+ */
+bool tar_heatshrink_is_compressed(File* file);
+
+/** Start decompressing file from the beginning
+ *
+ * @param      file  open file, closed by tar_heatshrink_stream_close
+ *
+ * @return     stream instance or NULL if header is invalid
+ */
+TarHeatshrinkStream* tar_heatshrink_stream_open_read(File* file);
+
+/** Write header and start compressing to file
+ *
+ * @param      file           file open for writing, closed by tar_heatshrink_stream_close
+ * @param      window_sz2     log2 of window size
+ * @param      lookahead_sz2  log2 of lookahead size
+ *
+ * @return     stream instance or NULL on failure
+ */
+TarHeatshrinkStream*
+    tar_heatshrink_stream_open_write(File* file, uint8_t window_sz2, uint8_t lookahead_sz2);
+
+/** Read decompressed data
+ *
+ * @return     bytes read, less than size at the end of stream, -1 on error
+ */
+int32_t tar_heatshrink_stream_read(TarHeatshrinkStream* stream, void* data, uint32_t size);
+
+/** Compress data
+ *
+ * @return     bytes written, -1 on error
+ */
+int32_t tar_heatshrink_stream_write(TarHeatshrinkStream* stream, const void* data, uint32_t size);
+
+/** Seek to absolute position in decompressed data
+ *
+ * Short backward seeks are served from history of decoded data, longer ones
+ * restart decoding. Write streams can only "seek" to their current position.
+ *
+ * @return     true on success
+ */
+bool tar_heatshrink_stream_seek(TarHeatshrinkStream* stream, uint32_t position);
+
+/** Finish compression and write all pending data to file
+ *
+ * Stream can't be written to afterwards.
+ *
+ * @return     true if all data was written
+ */
+bool tar_heatshrink_stream_finish(TarHeatshrinkStream* stream);
+
+/** Finish write stream if needed, close file and free stream
+ *
+ * @return     true if all data was written
+ */
+bool tar_heatshrink_stream_close(TarHeatshrinkStream* stream);
+
+#ifdef __cplusplus
+}
+#endif
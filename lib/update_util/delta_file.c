@@ -0,0 +1,143 @@
+#include "delta_file.h"
+#include <furi_hal.h>
+
+#define DELTA_DATA_BUFFER_MAX_LEN 512
+
+bool delta_file_validate(
+    File* deltaf,
+    DeltaFileHeader* header,
+    const DfuPageTaskProgressCb progress_cb,
+    void* context) {
+    furi_assert(header);
+
+    if(!storage_file_is_open(deltaf) || !storage_file_seek(deltaf, 0, true)) {
+        return false;
+    }
+
+    const uint32_t file_size = storage_file_size(deltaf);
+    if(file_size < sizeof(DeltaFileHeader) + sizeof(uint32_t)) {
+        return false;
+    }
+
+    if(storage_file_read(deltaf, header, sizeof(DeltaFileHeader)) != sizeof(DeltaFileHeader)) {
+        return false;
+    }
+
+    const size_t page_size = furi_hal_flash_get_page_size();
+    if((header->magic != DELTA_FILE_MAGIC) || (header->version != DELTA_FILE_VERSION) ||
+       ((header->address & (page_size - 1)) != 0)) {
+        return false;
+    }
+
+    if(!storage_file_seek(deltaf, 0, true)) {
+        return false;
+    }
+
+    /* Trailing CRC covers header and all page records */
+    const uint32_t data_size = file_size - sizeof(uint32_t);
+    uint8_t* data_buffer = malloc(DELTA_DATA_BUFFER_MAX_LEN);
+    uint32_t crc = 0;
+    uint32_t fptr = 0;
+
+    furi_hal_crc_reset();
+    furi_hal_crc_acquire(osWaitForever);
+    while(fptr < data_size) {
+        uint16_t n_bytes_to_read = MIN(DELTA_DATA_BUFFER_MAX_LEN, data_size - fptr);
+        if(storage_file_read(deltaf, data_buffer, n_bytes_to_read) != n_bytes_to_read) {
+            break;
+        }
+        fptr += n_bytes_to_read;
+        crc = furi_hal_crc_feed(data_buffer, n_bytes_to_read);
+        progress_cb(fptr * 100 / data_size, context);
+    }
+    furi_hal_crc_reset();
+    free(data_buffer);
+
+    uint32_t file_crc = 0;
+    if((fptr != data_size) ||
+       (storage_file_read(deltaf, &file_crc, sizeof(uint32_t)) != sizeof(uint32_t))) {
+        return false;
+    }
+
+    return crc == file_crc;
+}
+
+static bool delta_file_check_flash(uint32_t address, uint32_t size, uint32_t expected_crc) {
+    const size_t flash_start = furi_hal_flash_get_base();
+    const size_t flash_end = (size_t)furi_hal_flash_get_free_end_address();
+    if((address < flash_start) || (size > flash_end - address)) {
+        return false;
+    }
+
+    const size_t page_size = furi_hal_flash_get_page_size();
+    uint32_t crc = 0;
+
+    furi_hal_crc_reset();
+    furi_hal_crc_acquire(osWaitForever);
+    for(uint32_t offset = 0; offset < size; offset += page_size) {
+        crc = furi_hal_crc_feed((void*)(address + offset), MIN(page_size, size - offset));
+    }
+    furi_hal_crc_reset();
+
+    return (size > 0) && (crc == expected_crc);
+}
+
+bool delta_file_check_base(const DeltaFileHeader* header) {
+    furi_assert(header);
+    return delta_file_check_flash(header->address, header->base_size, header->base_crc);
+}
+
+bool delta_file_check_target(const DeltaFileHeader* header) {
+    furi_assert(header);
+    return delta_file_check_flash(header->address, header->target_size, header->target_crc);
+}
+
+bool delta_file_process_pages(
+    const DfuUpdateTask* task,
+    File* deltaf,
+    const DeltaFileHeader* header) {
+    furi_assert(task);
+    furi_assert(header);
+
+    if(!storage_file_seek(deltaf, sizeof(DeltaFileHeader), true)) {
+        return false;
+    }
+
+    task->progress_cb(0, task->context);
+    const size_t page_size = furi_hal_flash_get_page_size();
+    uint8_t* page_buffer = malloc(page_size);
+    uint32_t i_record = 0;
+
+    for(; i_record < header->page_count; i_record++) {
+        DeltaPageHeader page_header;
+        if(storage_file_read(deltaf, &page_header, sizeof(DeltaPageHeader)) !=
+           sizeof(DeltaPageHeader)) {
+            break;
+        }
+
+        const size_t page_address = header->address + page_header.page * page_size;
+        if((page_header.size == 0) || (page_header.size > page_size) ||
+           (task->address_cb && (!task->address_cb(page_address) ||
+                                 !task->address_cb(page_address + page_header.size - 1)))) {
+            break;
+        }
+
+        int16_t i_page = furi_hal_flash_get_page_number(page_address);
+        if(i_page < 0) {
+            break;
+        }
+
+        if(storage_file_read(deltaf, page_buffer, page_header.size) != page_header.size) {
+            break;
+        }
+
+        if(!task->task_cb(i_page, page_buffer, page_header.size)) {
+            break;
+        }
+
+        task->progress_cb((i_record + 1) * 100 / header->page_count, task->context);
+    }
+
+    free(page_buffer);
+    return i_record == header->page_count;
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include "dfu_file.h"
+
+#include <stdbool.h>
+#include <storage/storage.h>
+
+/* Delta file: changed flash pages of firmware image relative to a base build.
+ * Layout: DeltaFileHeader, header.page_count x (DeltaPageHeader + page data),
+ * CRC32 of everything before it. All CRCs are zlib-compatible CRC32.
+ */
+#define DELTA_FILE_MAGIC 0x544C4446 /* "FDLT" */
+#define DELTA_FILE_VERSION 1
+
+#pragma pack(push, 1)
+
+typedef struct {
+    uint32_t magic;
+    uint8_t version;
+    uint8_t _pad[3];
+    uint32_t address; /**< flash address of image start, page aligned */
+    uint32_t base_size; /**< size of image the delta was built against */
+    uint32_t base_crc; /**< CRC32 of base_size bytes of base image */
+    uint32_t target_size;
+    uint32_t target_crc; /**< CRC32 of target_size bytes of flash after update */
+    uint32_t page_count;
+} DeltaFileHeader;
+
+typedef struct {
+    uint16_t page; /**< page index, relative to image start */
+    uint16_t size; /**< page data size, rest of the page is erased */
+} DeltaPageHeader;
+
+#pragma pack(pop)
+
+/* Reads header and validates CRC of the whole file
+ */
+bool delta_file_validate(
+    File* deltaf,
+    DeltaFileHeader* header,
+    const DfuPageTaskProgressCb progress_cb,
+    void* context);
+
+/* Checks that flash contains image the delta was built against
+ */
+bool delta_file_check_base(const DeltaFileHeader* header);
+
+/* Checks that flash contains target image
+ */
+bool delta_file_check_target(const DeltaFileHeader* header);
+
+/* Runs task for every page in delta file. File must be validated first
+ */
+bool delta_file_process_pages(
+    const DfuUpdateTask* task,
+    File* deltaf,
+    const DeltaFileHeader* header);
@@ -3,46 +3,155 @@
 
 #define VALID_WHOLE_FILE_CRC 0xFFFFFFFF
 #define DFU_SUFFIX_VERSION 0x011A
-#define DFU_DATA_BUFFER_MAX_LEN 512
 #define DFU_SIGNATURE "DfuSe"
 
-bool dfu_file_validate_crc(File* dfuf, const DfuPageTaskProgressCb progress_cb, void* context) {
+typedef struct {
+    const DfuUpdateTask* task;
+    File* file;
+    uint32_t file_size;
+    uint32_t offset;
+    uint32_t crc;
+} DfuFileScan;
+
+static uint16_t dfu_file_scan_read(DfuFileScan* scan, void* data, uint16_t size) {
+    uint16_t bytes_read = storage_file_read(scan->file, data, size);
+    if(bytes_read > 0) {
+        scan->crc = furi_hal_crc_feed(data, bytes_read);
+        scan->offset += bytes_read;
+    }
+    return bytes_read;
+}
+
+static bool dfu_file_scan_page_changed(size_t page_address, const uint8_t* data, uint16_t size) {
+    const uint8_t* flash = (const uint8_t*)page_address;
+    if(memcmp(data, flash, size) != 0) {
+        return true;
+    }
+    /* Programming erases the rest of the page */
+    const size_t page_size = furi_hal_flash_get_page_size();
+    for(size_t i = size; i < page_size; i++) {
+        if(flash[i] != 0xFF) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool dfu_file_scan_element(
+    DfuFileScan* scan,
+    const ImageElementHeader* header,
+    uint8_t* buffer,
+    DfuPageMap* page_map) {
+    const DfuUpdateTask* task = scan->task;
+    const size_t page_size = furi_hal_flash_get_page_size();
+
+    /* Elements that are going to be skipped or rejected are only fed into CRC */
+    bool compare = ((header->dwElementAddress & (page_size - 1)) == 0);
+    if(task->address_cb && (!task->address_cb(header->dwElementAddress) ||
+                            !task->address_cb(header->dwElementAddress + header->dwElementSize))) {
+        compare = false;
+    }
+
+    uint32_t element_offs = 0;
+    while(element_offs < header->dwElementSize) {
+        uint16_t n_bytes_to_read = MIN(page_size, header->dwElementSize - element_offs);
+        if(dfu_file_scan_read(scan, buffer, n_bytes_to_read) != n_bytes_to_read) {
+            return false;
+        }
+
+        if(compare) {
+            int16_t i_page =
+                furi_hal_flash_get_page_number(header->dwElementAddress + element_offs);
+            if((i_page < 0) || (i_page >= DFU_PAGE_MAP_PAGES)) {
+                return false;
+            }
+            page_map->pages_total++;
+            if(dfu_file_scan_page_changed(
+                   furi_hal_flash_get_base() + i_page * page_size, buffer, n_bytes_to_read)) {
+                page_map->changed[i_page / 32] |= 1UL << (i_page % 32);
+                page_map->pages_changed++;
+            }
+        }
+
+        element_offs += n_bytes_to_read;
+        task->progress_cb(scan->offset * 100 / scan->file_size, task->context);
+    }
+
+    return true;
+}
+
+bool dfu_file_scan(
+    const DfuUpdateTask* task,
+    File* dfuf,
+    const uint8_t n_targets,
+    DfuPageMap* page_map) {
+    furi_assert(task);
+    furi_assert(page_map);
+
     if(!storage_file_is_open(dfuf) || !storage_file_seek(dfuf, 0, true)) {
         return false;
     }
 
-    furi_hal_crc_reset();
+    memset(page_map, 0, sizeof(DfuPageMap));
 
-    uint32_t file_crc = 0;
+    const size_t page_size = furi_hal_flash_get_page_size();
+    uint8_t* buffer = malloc(page_size);
+    DfuFileScan scan = {
+        .task = task,
+        .file = dfuf,
+        .file_size = storage_file_size(dfuf),
+    };
+    bool success = false;
 
-    uint8_t* data_buffer = malloc(DFU_DATA_BUFFER_MAX_LEN);
-    uint16_t data_buffer_valid_len;
+    furi_hal_crc_reset();
+    furi_hal_crc_acquire(osWaitForever);
+    do {
+        DfuPrefix dfu_prefix;
+        if(dfu_file_scan_read(&scan, &dfu_prefix, sizeof(DfuPrefix)) != sizeof(DfuPrefix)) {
+            break;
+        }
 
-    uint32_t file_size = storage_file_size(dfuf);
+        bool elements_valid = true;
+        for(uint8_t i_target = 0; (i_target < n_targets) && elements_valid; ++i_target) {
+            TargetPrefix target_prefix;
+            if(dfu_file_scan_read(&scan, &target_prefix, sizeof(TargetPrefix)) !=
+               sizeof(TargetPrefix)) {
+                elements_valid = false;
+                break;
+            }
 
-    /* Feed file contents per sector into CRC calc */
-    furi_hal_crc_acquire(osWaitForever);
-    for(uint32_t fptr = 0; fptr < file_size;) {
-        data_buffer_valid_len = storage_file_read(dfuf, data_buffer, DFU_DATA_BUFFER_MAX_LEN);
-        if(data_buffer_valid_len == 0) {
+            for(uint32_t i_element = 0; i_element < target_prefix.dwNbElements; ++i_element) {
+                ImageElementHeader image_element;
+                if((dfu_file_scan_read(&scan, &image_element, sizeof(ImageElementHeader)) !=
+                    sizeof(ImageElementHeader)) ||
+                   !dfu_file_scan_element(&scan, &image_element, buffer, page_map)) {
+                    elements_valid = false;
+                    break;
+                }
+            }
+        }
+        if(!elements_valid) {
             break;
         }
-        fptr += data_buffer_valid_len;
 
-        if((fptr % DFU_DATA_BUFFER_MAX_LEN == 0)) {
-            progress_cb(fptr * 100 / file_size, context);
+        /* Suffix and anything else up to the end of file is covered by CRC too */
+        while(scan.offset < scan.file_size) {
+            uint16_t n_bytes_to_read = MIN(page_size, scan.file_size - scan.offset);
+            if(dfu_file_scan_read(&scan, buffer, n_bytes_to_read) != n_bytes_to_read) {
+                break;
+            }
         }
 
-        file_crc = furi_hal_crc_feed(data_buffer, data_buffer_valid_len);
-    }
+        /* Last 4 bytes of DFU file = CRC of previous file contents, inverted
+         * If we calculate whole file CRC32, incl. embedded CRC,
+         * that should give us 0xFFFFFFFF
+         */
+        success = (scan.offset == scan.file_size) && (scan.crc == VALID_WHOLE_FILE_CRC);
+    } while(false);
     furi_hal_crc_reset();
-    free(data_buffer);
 
-    /* Last 4 bytes of DFU file = CRC of previous file contents, inverted
-     * If we calculate whole file CRC32, incl. embedded CRC,
-     * that should give us 0xFFFFFFFF 
-     */
-    return file_crc == VALID_WHOLE_FILE_CRC;
+    free(buffer);
+    return success;
 }
 
 uint8_t dfu_file_validate_headers(File* dfuf, const DfuValidationParams* reference_params) {
@@ -99,7 +208,8 @@ uint8_t dfu_file_validate_headers(File* dfuf, const DfuValidationParams* referen
 static DfuUpdateBlockResult dfu_file_perform_task_for_update_pages(
     const DfuUpdateTask* task,
     File* dfuf,
-    const ImageElementHeader* header) {
+    const ImageElementHeader* header,
+    const DfuPageMap* page_map) {
     furi_assert(task);
     furi_assert(header);
     task->progress_cb(0, task->context);
@@ -127,18 +237,27 @@ static DfuUpdateBlockResult dfu_file_perform_task_for_update_pages(
             n_bytes_to_read = header->dwElementSize - element_offs;
         }
 
-        bytes_read = storage_file_read(dfuf, fw_block, n_bytes_to_read);
-        if(bytes_read == 0) {
-            break;
-        }
-
         int16_t i_page = furi_hal_flash_get_page_number(header->dwElementAddress + element_offs);
         if(i_page < 0) {
             break;
         }
 
-        if(!task->task_cb(i_page, fw_block, bytes_read)) {
-            break;
+        if(page_map && ((i_page >= DFU_PAGE_MAP_PAGES) ||
+                        !(page_map->changed[i_page / 32] & (1UL << (i_page % 32))))) {
+            /* Page contents are already in flash */
+            if(!storage_file_seek(dfuf, n_bytes_to_read, false)) {
+                break;
+            }
+            bytes_read = n_bytes_to_read;
+        } else {
+            bytes_read = storage_file_read(dfuf, fw_block, n_bytes_to_read);
+            if(bytes_read == 0) {
+                break;
+            }
+
+            if(!task->task_cb(i_page, fw_block, bytes_read)) {
+                break;
+            }
         }
 
         element_offs += bytes_read;
@@ -150,7 +269,11 @@ static DfuUpdateBlockResult dfu_file_perform_task_for_update_pages(
                                                      UpdateBlockResult_Failed;
 }
 
-bool dfu_file_process_targets(const DfuUpdateTask* task, File* dfuf, const uint8_t n_targets) {
+bool dfu_file_process_targets(
+    const DfuUpdateTask* task,
+    File* dfuf,
+    const uint8_t n_targets,
+    const DfuPageMap* page_map) {
     TargetPrefix target_prefix = {0};
     ImageElementHeader image_element = {0};
     uint16_t bytes_read = 0;
@@ -172,7 +295,7 @@ bool dfu_file_process_targets(const DfuUpdateTask* task, File* dfuf, const uint8
                 return UpdateBlockResult_Failed;
             }
 
-            if(dfu_file_perform_task_for_update_pages(task, dfuf, &image_element) ==
+            if(dfu_file_perform_task_for_update_pages(task, dfuf, &image_element, page_map) ==
                UpdateBlockResult_Failed) {
                 return false;
             }
@@ -30,11 +30,33 @@ typedef struct {
     uint16_t device;
 } DfuValidationParams;
 
-bool dfu_file_validate_crc(File* dfuf, const DfuPageTaskProgressCb progress_cb, void* context);
+#define DFU_PAGE_MAP_PAGES 256
+
+/* Flash pages that have to be programmed, filled by dfu_file_scan */
+typedef struct {
+    uint32_t changed[DFU_PAGE_MAP_PAGES / 32];
+    uint16_t pages_changed;
+    uint16_t pages_total;
+} DfuPageMap;
+
+/* Reads whole file once: validates CRC and compares image pages with flash contents
+ * Pages with different contents are marked in page_map. Returns true if CRC is valid
+ */
+bool dfu_file_scan(
+    const DfuUpdateTask* task,
+    File* dfuf,
+    const uint8_t n_targets,
+    DfuPageMap* page_map);
 
 /* Returns number of valid targets from file header
  * If file is invalid, returns 0
  */
 uint8_t dfu_file_validate_headers(File* dfuf, const DfuValidationParams* reference_params);
 
-bool dfu_file_process_targets(const DfuUpdateTask* task, File* dfuf, const uint8_t n_targets);
+/* Runs task for image pages. If page_map is not NULL, pages not marked in it are skipped
+ */
+bool dfu_file_process_targets(
+    const DfuUpdateTask* task,
+    File* dfuf,
+    const uint8_t n_targets,
+    const DfuPageMap* page_map);
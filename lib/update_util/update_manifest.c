@@ -14,11 +14,14 @@
 #define MANIFEST_KEY_RADIO_VERSION "Radio version"
 #define MANIFEST_KEY_RADIO_CRC "Radio CRC"
 #define MANIFEST_KEY_ASSETS_FILE "Resources"
+#define MANIFEST_KEY_DELTA_FILE "Firmware delta"
+#define MANIFEST_KEY_DELTA_BASE_CRC "Delta base CRC"
 
 UpdateManifest* update_manifest_alloc() {
     UpdateManifest* update_manifest = malloc(sizeof(UpdateManifest));
     string_init(update_manifest->version);
     string_init(update_manifest->firmware_dfu_image);
+    string_init(update_manifest->firmware_delta_image);
     string_init(update_manifest->radio_image);
     string_init(update_manifest->staged_loader_file);
     string_init(update_manifest->resource_bundle);
@@ -31,6 +34,7 @@ void update_manifest_free(UpdateManifest* update_manifest) {
     furi_assert(update_manifest);
     string_clear(update_manifest->version);
     string_clear(update_manifest->firmware_dfu_image);
+    string_clear(update_manifest->firmware_delta_image);
     string_clear(update_manifest->radio_image);
     string_clear(update_manifest->staged_loader_file);
     string_clear(update_manifest->resource_bundle);
@@ -85,6 +89,20 @@ static bool
         flipper_format_read_string(
             flipper_file, MANIFEST_KEY_ASSETS_FILE, update_manifest->resource_bundle);
 
+        /* Delta is only usable along with full image to fall back to */
+        if(!string_empty_p(update_manifest->firmware_dfu_image) &&
+           flipper_format_rewind(flipper_file) &&
+           flipper_format_read_string(
+               flipper_file, MANIFEST_KEY_DELTA_FILE, update_manifest->firmware_delta_image)) {
+            if(!flipper_format_read_hex(
+                   flipper_file,
+                   MANIFEST_KEY_DELTA_BASE_CRC,
+                   (uint8_t*)&update_manifest->firmware_delta_base_crc,
+                   sizeof(uint32_t))) {
+                string_reset(update_manifest->firmware_delta_image);
+            }
+        }
+
         update_manifest->valid =
             (!string_empty_p(update_manifest->firmware_dfu_image) ||
              !string_empty_p(update_manifest->radio_image) ||
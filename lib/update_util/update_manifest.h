@@ -19,6 +19,8 @@ typedef struct {
     string_t staged_loader_file;
     uint32_t staged_loader_crc;
     string_t firmware_dfu_image;
+    string_t firmware_delta_image;
+    uint32_t firmware_delta_base_crc;
     string_t radio_image;
     uint32_t radio_address;
     uint32_t radio_version;
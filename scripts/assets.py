@@ -61,6 +61,13 @@ class Main(App):
             help="Symbol and file name in dolphin output directory",
             default=None,
         )
+        self.parser_dolphin.add_argument(
+            "-b",
+            "--bundle",
+            action="store_true",
+            help="Pack frames of every animation into single file",
+            default=False,
+        )
         self.parser_dolphin.add_argument(
             "input_directory", help="Dolphin source directory"
         )
@@ -248,7 +255,9 @@ class Main(App):
         self.logger.info(f"Loading data")
         dolphin.load(self.args.input_directory)
         self.logger.info(f"Packing")
-        dolphin.pack(self.args.output_directory, self.args.symbol_name)
+        dolphin.pack(
+            self.args.output_directory, self.args.symbol_name, self.args.bundle
+        )
         self.logger.info(f"Complete")
 
         return 0
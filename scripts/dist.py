@@ -25,6 +25,12 @@ class Main(App):
             help="If set, bundle update package for self-update",
             required=False,
         )
+        self.parser_copy.add_argument(
+            "--delta-base",
+            dest="delta_base",
+            help="DFU file of previous build to add firmware delta for",
+            required=False,
+        )
         self.parser_copy.add_argument(
             "--noclean",
             dest="noclean",
@@ -91,6 +97,13 @@ class Main(App):
                         self.args.resources,
                     )
                 )
+            if self.args.delta_base:
+                bundle_args.extend(
+                    (
+                        "--delta-base",
+                        self.args.delta_base,
+                    )
+                )
             self.logger.info(
                 f"Use this directory to self-update your Flipper:\n\t{bundle_dir}"
             )
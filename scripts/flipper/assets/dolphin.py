@@ -3,6 +3,7 @@ import logging
 import os
 import sys
 import shutil
+import struct
 from collections import Counter
 
 from flipper.utils.fff import *
@@ -26,6 +27,12 @@ class DolphinBubbleAnimation:
     FILE_TYPE = "Flipper Animation"
     FILE_VERSION = 1
 
+    # Keep in sync with applications/desktop/animations/animation_frame_stream.h
+    BUNDLE_FILE = "frames.bundle"
+    BUNDLE_MAGIC = 0x4E424641
+    BUNDLE_VERSION = 1
+    BUNDLE_HEADER_FORMAT = "<IBBBB"
+
     def __init__(
         self,
         name: str,
@@ -183,7 +190,30 @@ class DolphinBubbleAnimation:
             if bubbles_in_slots[slot] != 0:
                 bubble["_NextBubbleIndex"] = bubble_index + 1
 
-    def save(self, output_directory: str):
+    def _save_bundle(self, animation_directory: str, frames: list):
+        header = struct.pack(
+            self.BUNDLE_HEADER_FORMAT,
+            self.BUNDLE_MAGIC,
+            self.BUNDLE_VERSION,
+            len(frames),
+            self.meta["Width"],
+            self.meta["Height"],
+        )
+        # Offsets from file start, last one is file size
+        offset = len(header) + 4 * (len(frames) + 1)
+        offsets = []
+        for frame in frames:
+            offsets.append(offset)
+            offset += len(frame)
+        offsets.append(offset)
+
+        with open(os.path.join(animation_directory, self.BUNDLE_FILE), "wb") as file:
+            file.write(header)
+            file.write(struct.pack(f"<{len(offsets)}I", *offsets))
+            for frame in frames:
+                file.write(frame)
+
+    def save(self, output_directory: str, bundle: bool = False):
         animation_directory = os.path.join(output_directory, self.name)
         os.makedirs(animation_directory, exist_ok=True)
         meta_filename = os.path.join(animation_directory, "meta.txt")
@@ -221,6 +251,12 @@ class DolphinBubbleAnimation:
 
         file.save(meta_filename)
 
+        if bundle:
+            pool = multiprocessing.Pool()
+            frames = pool.map(_convert_image, self.frames)
+            self._save_bundle(animation_directory, frames)
+            return
+
         to_pack = []
         for index, frame in enumerate(self.frames):
             to_pack.append(
@@ -321,7 +357,7 @@ class DolphinManifest:
             symbol_name=symbol_name,
         )
 
-    def save2folder(self, output_directory: str):
+    def save2folder(self, output_directory: str, bundle: bool = False):
         manifest_filename = os.path.join(output_directory, "manifest.txt")
         file = FlipperFormatFile()
         file.setHeader(self.FILE_TYPE, self.FILE_VERSION)
@@ -336,16 +372,16 @@ class DolphinManifest:
             file.writeKey("Weight", animation.weight)
             file.writeEmptyLine()
 
-            animation.save(output_directory)
+            animation.save(output_directory, bundle)
 
         file.save(manifest_filename)
 
-    def save(self, output_directory: str, symbol_name: str):
+    def save(self, output_directory: str, symbol_name: str, bundle: bool = False):
         os.makedirs(output_directory, exist_ok=True)
         if symbol_name:
             self.save2code(output_directory, symbol_name)
         else:
-            self.save2folder(output_directory)
+            self.save2folder(output_directory, bundle)
 
 
 class Dolphin:
@@ -359,5 +395,7 @@ class Dolphin:
         self.logger.info(f"Loading directory {source_directory}")
         self.manifest.load(source_directory)
 
-    def pack(self, output_directory: str, symbol_name: str = None):
-        self.manifest.save(output_directory, symbol_name)
+    def pack(
+        self, output_directory: str, symbol_name: str = None, bundle: bool = False
+    ):
+        self.manifest.save(output_directory, symbol_name, bundle)
@@ -0,0 +1,62 @@
+import io
+import struct
+import subprocess
+import tarfile
+
+# Keep in sync with lib/toolbox/tar/tar_heatshrink.h
+TAR_HEATSHRINK_MAGIC = b"\x89HST"
+TAR_HEATSHRINK_VERSION = 1
+TAR_HEATSHRINK_HEADER_FORMAT = "<4sBBBB"
+TAR_HEATSHRINK_WINDOW_SIZE_LOG_DEFAULT = 11
+TAR_HEATSHRINK_LOOKAHEAD_SIZE_LOG_DEFAULT = 4
+TAR_HEATSHRINK_WINDOW_SIZE_LOG_MAX = 13
+
+TAR_FORMAT = tarfile.USTAR_FORMAT
+
+
+def is_compressed(data: bytes):
+    return data[: len(TAR_HEATSHRINK_MAGIC)] == TAR_HEATSHRINK_MAGIC
+
+
+def compress(
+    data: bytes,
+    window_sz2=TAR_HEATSHRINK_WINDOW_SIZE_LOG_DEFAULT,
+    lookahead_sz2=TAR_HEATSHRINK_LOOKAHEAD_SIZE_LOG_DEFAULT,
+):
+    if window_sz2 > TAR_HEATSHRINK_WINDOW_SIZE_LOG_MAX:
+        raise ValueError(f"Window size log {window_sz2} is too big for device")
+    header = struct.pack(
+        TAR_HEATSHRINK_HEADER_FORMAT,
+        TAR_HEATSHRINK_MAGIC,
+        TAR_HEATSHRINK_VERSION,
+        window_sz2,
+        lookahead_sz2,
+        0,
+    )
+    encoded = subprocess.check_output(
+        ["heatshrink", "-e", f"-w{window_sz2}", f"-l{lookahead_sz2}"], input=data
+    )
+    return header + encoded
+
+
+def decompress(data: bytes):
+    if not is_compressed(data):
+        raise ValueError("Not a compressed tar")
+    _, version, window_sz2, lookahead_sz2, _ = struct.unpack_from(
+        TAR_HEATSHRINK_HEADER_FORMAT, data
+    )
+    if version != TAR_HEATSHRINK_VERSION:
+        raise ValueError(f"Unsupported version {version}")
+    return subprocess.check_output(
+        ["heatshrink", "-d", f"-w{window_sz2}", f"-l{lookahead_sz2}"],
+        input=data[struct.calcsize(TAR_HEATSHRINK_HEADER_FORMAT) :],
+    )
+
+
+def pack_directory(srcdir: str, compressed=True, **kwargs):
+    """Pack directory contents to tar in the layout device unpacks"""
+    buffer = io.BytesIO()
+    with tarfile.open(fileobj=buffer, mode="w:", format=TAR_FORMAT) as tarball:
+        tarball.add(srcdir, arcname="")
+    data = buffer.getvalue()
+    return compress(data, **kwargs) if compressed else data
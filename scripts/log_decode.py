@@ -0,0 +1,197 @@
+#!/usr/bin/env python3
+
+import re
+import struct
+import sys
+
+from flipper.app import App
+
+# Keep in sync with core/furi/log.c
+TRACE_SYNC = 0xA5
+TRACE_TOKEN_DROPPED = 0
+TRACE_HEADER_SIZE = 8
+TRACE_ARGS_SIZE_MAX = 32
+
+ELF_MAGIC = b"\x7fELF"
+ELF_SHF_ALLOC = 0x2
+ELF_SHT_NOBITS = 8
+
+SPEC_RE = re.compile(
+    r"%(?P<flags>[-+ #0]*)(?P<width>\*|\d+)?(?:\.(?P<precision>\*|\d*))?"
+    r"(?P<length>hh|h|ll|l|j|z|t|L)?(?P<conversion>[diouxXcspfFeEgGaAn%])"
+)
+
+
+class Elf:
+    """Minimal ELF32 little endian reader: enough to fetch format literals"""
+
+    def __init__(self, path):
+        with open(path, "rb") as file:
+            self.data = file.read()
+        if self.data[:4] != ELF_MAGIC or self.data[4] != 1 or self.data[5] != 1:
+            raise ValueError(f"{path} is not ELF32 little endian file")
+        (shoff,) = struct.unpack_from("<I", self.data, 0x20)
+        shentsize, shnum = struct.unpack_from("<HH", self.data, 0x2E)
+        self.sections = []
+        for index in range(shnum):
+            (
+                _name,
+                sh_type,
+                flags,
+                addr,
+                offset,
+                size,
+            ) = struct.unpack_from("<IIIIII", self.data, shoff + index * shentsize)
+            if (flags & ELF_SHF_ALLOC) and sh_type != ELF_SHT_NOBITS and size:
+                self.sections.append((addr, offset, size))
+
+    def read_string(self, address):
+        for addr, offset, size in self.sections:
+            if addr <= address < addr + size:
+                start = offset + address - addr
+                end = self.data.index(b"\0", start, offset + size)
+                return self.data[start:end].decode("utf-8", errors="replace")
+        return None
+
+
+class ArgsReader:
+    def __init__(self, data):
+        self.data = data
+        self.offset = 0
+
+    def unpack(self, fmt):
+        size = struct.calcsize(fmt)
+        if self.offset + size > len(self.data):
+            raise EOFError()
+        (value,) = struct.unpack_from(fmt, self.data, self.offset)
+        self.offset += size
+        return value
+
+    def string(self):
+        end = self.data.find(b"\0", self.offset)
+        if end < 0:
+            raise EOFError()
+        value = self.data[self.offset : end].decode("utf-8", errors="replace")
+        self.offset = end + 1
+        return value
+
+
+def format_record(format_string, args):
+    """Format record the same way firmware does in deferred text mode"""
+    reader = ArgsReader(args)
+    result = ""
+    position = 0
+    for match in SPEC_RE.finditer(format_string):
+        result += format_string[position : match.start()]
+        position = match.end()
+        conversion = match.group("conversion")
+        if conversion == "%":
+            result += "%"
+            continue
+        try:
+            width = match.group("width") or ""
+            if width == "*":
+                width = str(reader.unpack("<i"))
+            precision = match.group("precision")
+            if precision == "*":
+                precision = str(reader.unpack("<i"))
+            flags = match.group("flags")
+            wide = match.group("length") in ("ll", "j")
+
+            if conversion == "s":
+                value = reader.string()
+            elif conversion in "fFeEgGaA":
+                value = reader.unpack("<d")
+                conversion = {"a": "e", "A": "E"}.get(conversion, conversion)
+            elif conversion in "pn":
+                value = reader.unpack("<I")
+                if conversion == "n":
+                    continue
+                flags += "#"
+                conversion = "x"
+            elif conversion in "di":
+                value = reader.unpack("<q" if wide else "<i")
+            else:
+                value = reader.unpack("<Q" if wide else "<I")
+                if conversion == "u":
+                    conversion = "d"
+                elif conversion == "c":
+                    value &= 0xFF
+        except EOFError:
+            # Arguments didn't fit into record on device
+            return result + "~" + format_string[match.start() :]
+
+        spec = "%" + flags + width
+        if precision is not None:
+            spec += "." + precision
+        result += (spec + conversion) % value
+    return result + format_string[position:]
+
+
+class Main(App):
+    def init(self):
+        self.parser.add_argument("elf", help="Firmware ELF file the trace came from")
+        self.parser.add_argument(
+            "input", help="Captured trace stream, '-' for stdin", nargs="?", default="-"
+        )
+        self.parser.add_argument(
+            "--no-color", action="store_true", help="Strip terminal color codes"
+        )
+        self.parser.set_defaults(func=self.decode)
+
+    def call(self):
+        return self.args.func()
+
+    def frames(self, data):
+        position = 0
+        while position < len(data):
+            if data[position] != TRACE_SYNC or position + 2 > len(data):
+                position += 1
+                continue
+            length = data[position + 1]
+            end = position + 2 + length + 1
+            if (
+                length < TRACE_HEADER_SIZE
+                or length > TRACE_HEADER_SIZE + TRACE_ARGS_SIZE_MAX
+                or end > len(data)
+            ):
+                position += 1
+                continue
+            checksum = 0
+            for byte in data[position + 1 : end - 1]:
+                checksum ^= byte
+            if checksum != data[end - 1]:
+                self.logger.debug(f"Bad checksum at {position}, resyncing")
+                position += 1
+                continue
+            token, timestamp = struct.unpack_from("<II", data, position + 2)
+            yield token, timestamp, data[position + 2 + TRACE_HEADER_SIZE : end - 1]
+            position = end
+
+    def decode(self):
+        elf = Elf(self.args.elf)
+        if self.args.input == "-":
+            data = sys.stdin.buffer.read()
+        else:
+            with open(self.args.input, "rb") as file:
+                data = file.read()
+
+        color_re = re.compile(r"\033\[[0-9;]*m")
+        for token, timestamp, args in self.frames(data):
+            if token == TRACE_TOKEN_DROPPED:
+                (dropped,) = struct.unpack_from("<I", args)
+                line = f"{dropped} log records dropped\r\n"
+            else:
+                format_string = elf.read_string(token)
+                if format_string is None:
+                    self.logger.warning(f"Unknown token 0x{token:08X}, wrong ELF?")
+                    continue
+                line = format_record(format_string, args)
+            if self.args.no_color:
+                line = color_re.sub("", line)
+            sys.stdout.write(f"{timestamp} {line.rstrip()}\n")
+        return 0
+
+
+if __name__ == "__main__":
+    Main()()
@@ -0,0 +1,64 @@
+#!/usr/bin/env python3
+
+import io
+import tarfile
+
+from flipper.app import App
+from flipper.utils import tarhs
+
+
+class Main(App):
+    def init(self):
+        self.subparsers = self.parser.add_subparsers(help="sub-command help")
+
+        # pack
+        self.parser_pack = self.subparsers.add_parser(
+            "pack", help="Pack directory into heatshrink-compressed tar"
+        )
+        self.parser_pack.add_argument("source", help="Directory to pack")
+        self.parser_pack.add_argument("output", help="Output file")
+        self.parser_pack.add_argument(
+            "-w",
+            dest="window",
+            type=int,
+            default=tarhs.TAR_HEATSHRINK_WINDOW_SIZE_LOG_DEFAULT,
+            help="log2 of window size",
+        )
+        self.parser_pack.add_argument(
+            "-l",
+            dest="lookahead",
+            type=int,
+            default=tarhs.TAR_HEATSHRINK_LOOKAHEAD_SIZE_LOG_DEFAULT,
+            help="log2 of lookahead size",
+        )
+        self.parser_pack.set_defaults(func=self.pack)
+
+        # unpack
+        self.parser_unpack = self.subparsers.add_parser(
+            "unpack", help="Unpack plain or compressed tar"
+        )
+        self.parser_unpack.add_argument("input", help="Archive to unpack")
+        self.parser_unpack.add_argument("destination", help="Output directory")
+        self.parser_unpack.set_defaults(func=self.unpack)
+
+    def pack(self):
+        plain = tarhs.pack_directory(self.args.source, compressed=False)
+        data = tarhs.compress(plain, self.args.window, self.args.lookahead)
+        with open(self.args.output, "wb") as file:
+            file.write(data)
+        ratio = len(data) * 100 // max(len(plain), 1)
+        self.logger.info(f"{len(plain)} bytes packed to {len(data)} ({ratio}%)")
+        return 0
+
+    def unpack(self):
+        with open(self.args.input, "rb") as file:
+            data = file.read()
+        if tarhs.is_compressed(data):
+            data = tarhs.decompress(data)
+        with tarfile.open(fileobj=io.BytesIO(data), mode="r:") as tarball:
+            tarball.extractall(self.args.destination)
+        return 0
+
+
+if __name__ == "__main__":
+    Main()()
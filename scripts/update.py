@@ -2,21 +2,32 @@
 
 from flipper.app import App
 from flipper.utils.fff import FlipperFormatFile
+from flipper.utils import tarhs
 from os.path import basename, join, exists
 import os
 import shutil
+import struct
 import zlib
-import tarfile
 
 
 class Main(App):
     UPDATE_MANIFEST_NAME = "update.fuf"
 
-    #  No compression, plain tar
-    RESOURCE_TAR_MODE = "w:"
-    RESOURCE_TAR_FORMAT = tarfile.USTAR_FORMAT
+    #  Heatshrink-compressed tar, unpacked by updater from the same package
     RESOURCE_FILE_NAME = "resources.tar"
 
+    # Keep in sync with lib/update_util/delta_file.h
+    DELTA_FILE_NAME = "firmware.fdelta"
+    DELTA_FILE_MAGIC = 0x544C4446
+    DELTA_FILE_VERSION = 1
+    DELTA_HEADER_FORMAT = "<IB3xIIIIII"
+    DELTA_PAGE_HEADER_FORMAT = "<HH"
+    FLASH_PAGE_SIZE = 0x1000
+
+    DFU_SIGNATURE = b"DfuSe"
+    DFU_PREFIX_SIZE = 11
+    DFU_TARGET_PREFIX_SIZE = 274
+
     def init(self):
         self.subparsers = self.parser.add_subparsers(help="sub-command help")
 
@@ -40,6 +51,19 @@ class Main(App):
         self.parser_generate.add_argument(
             "--radiover", dest="radioversion", required=False
         )
+        self.parser_generate.add_argument(
+            "--plain-resources",
+            dest="plain_resources",
+            action="store_true",
+            help="Don't compress resources tar",
+            required=False,
+        )
+        self.parser_generate.add_argument(
+            "--delta-base",
+            dest="delta_base",
+            help="DFU file of build to generate firmware delta against",
+            required=False,
+        )
 
         self.parser_generate.set_defaults(func=self.generate)
 
@@ -63,6 +87,13 @@ class Main(App):
             self.package_resources(
                 self.args.resources, join(self.args.directory, resources_basename)
             )
+        delta_base_crc = None
+        if self.args.delta_base:
+            delta_base_crc = self.package_delta(
+                self.args.delta_base,
+                self.args.dfu,
+                join(self.args.directory, self.DELTA_FILE_NAME),
+            )
 
         file = FlipperFormatFile()
         file.setHeader("Flipper firmware upgrade configuration", 1)
@@ -80,15 +111,74 @@ class Main(App):
         else:
             file.writeKey("Radio CRC", self.int2ffhex(0))
         file.writeKey("Resources", resources_basename)
+        if delta_base_crc is not None:
+            file.writeKey("Firmware delta", self.DELTA_FILE_NAME)
+            file.writeKey("Delta base CRC", self.int2ffhex(delta_base_crc))
         file.save(join(self.args.directory, self.UPDATE_MANIFEST_NAME))
 
         return 0
 
     def package_resources(self, srcdir: str, dst_name: str):
-        with tarfile.open(
-            dst_name, self.RESOURCE_TAR_MODE, format=self.RESOURCE_TAR_FORMAT
-        ) as tarball:
-            tarball.add(srcdir, arcname="")
+        data = tarhs.pack_directory(srcdir, compressed=not self.args.plain_resources)
+        with open(dst_name, "wb") as file:
+            file.write(data)
+
+    def read_dfu_image(self, filename: str):
+        with open(filename, "rb") as file:
+            data = file.read()
+        if data[: len(self.DFU_SIGNATURE)] != self.DFU_SIGNATURE:
+            raise ValueError(f"{filename} is not a DfuSe file")
+        (targets,) = struct.unpack_from("<B", data, 10)
+        offset = self.DFU_PREFIX_SIZE
+        (elements,) = struct.unpack_from("<I", data, offset + 270)
+        if targets != 1 or elements != 1:
+            raise ValueError(f"{filename}: only single element images are supported")
+        offset += self.DFU_TARGET_PREFIX_SIZE
+        address, size = struct.unpack_from("<II", data, offset)
+        offset += 8
+        return address, data[offset : offset + size]
+
+    def package_delta(self, base_dfu: str, target_dfu: str, dst_name: str):
+        base_address, base = self.read_dfu_image(base_dfu)
+        address, target = self.read_dfu_image(target_dfu)
+        if base_address != address:
+            raise ValueError("Base and target images have different addresses")
+
+        # Programming a page erases it first: the rest of the page reads 0xFF
+        page_size = self.FLASH_PAGE_SIZE
+        records = bytearray()
+        page_count = 0
+        for offset in range(0, len(target), page_size):
+            new = target[offset : offset + page_size]
+            old = base[offset : offset + page_size]
+            if new.ljust(page_size, b"\xFF") == old.ljust(page_size, b"\xFF"):
+                continue
+            records += struct.pack(
+                self.DELTA_PAGE_HEADER_FORMAT, offset // page_size, len(new)
+            )
+            records += new
+            page_count += 1
+
+        base_crc = zlib.crc32(base) & 0xFFFFFFFF
+        data = struct.pack(
+            self.DELTA_HEADER_FORMAT,
+            self.DELTA_FILE_MAGIC,
+            self.DELTA_FILE_VERSION,
+            address,
+            len(base),
+            base_crc,
+            len(target),
+            zlib.crc32(target) & 0xFFFFFFFF,
+            page_count,
+        )
+        data += records
+        data += struct.pack("<I", zlib.crc32(data) & 0xFFFFFFFF)
+        with open(dst_name, "wb") as file:
+            file.write(data)
+
+        total_pages = (len(target) + page_size - 1) // page_size
+        self.logger.info(f"Delta: {page_count} of {total_pages} pages changed")
+        return base_crc
 
     @staticmethod
     def int2ffhex(value: int):